@@ -42,6 +42,6 @@ App::Application::Application(HMODULE aHandle, const RED4ext::Sdk* aSdk)
     Register<App::TweakWatcher>(Env::TweakHotFile());
 
     Register<App::ResourcePathRegistry>(Env::KnownHashesPath());
-    Register<App::WorldNodeRegistry>();
+    Register<App::WorldNodeRegistry>(Env::NodeIndexPath());
     Register<App::InkWidgetCollector>(Env::IsPrePatch212a());
 }
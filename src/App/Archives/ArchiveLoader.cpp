@@ -71,6 +71,11 @@ bool App::ArchiveLoader::SwapArchives(const std::filesystem::path& aArchiveHotDi
     return true;
 }
 
+uint32_t App::ArchiveLoader::GetResourceGeneration()
+{
+    return s_resourceGeneration;
+}
+
 bool App::ArchiveLoader::CollectArchiveGroups(Red::DynArray<Red::ArchiveGroup*>& aGroups)
 {
     auto depot = Red::ResourceDepot::Get();
@@ -276,6 +281,8 @@ bool App::ArchiveLoader::InvalidateResources(const Red::DynArray<Red::ResourcePa
     if (aPaths.size == 0)
         return true;
 
+    ++s_resourceGeneration;
+
     // Force reload existing tokens:
     // 1. Copy existing token
     // 2. Reset token in the loader
@@ -347,6 +354,8 @@ bool App::ArchiveLoader::InvalidateResources(const Red::DynArray<Red::ResourcePa
 
             Raw::JobHandle::Wait(allJobs);
 
+            ++s_resourceGeneration;
+
             ReloadExtensions();
         });
 
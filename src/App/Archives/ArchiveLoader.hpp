@@ -15,6 +15,9 @@ class ArchiveLoader
 public:
     bool SwapArchives(const std::filesystem::path& aArchiveHotDir);
 
+    // Changes every time loaded resources are invalidated, so dependent caches can tell when to drop their state.
+    static uint32_t GetResourceGeneration();
+
 private:
     struct DepotLocker
     {
@@ -48,5 +51,6 @@ private:
     static void ReloadExtensions();
 
     std::mutex m_updateLock;
+    inline static std::atomic<uint32_t> s_resourceGeneration{0};
 };
 }
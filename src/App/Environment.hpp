@@ -49,6 +49,16 @@ inline std::filesystem::path KnownHashesPath()
     return Core::Runtime::GetModuleDir() / L"Resources.txt";
 }
 
+inline std::filesystem::path NodeIndexPath()
+{
+    return Core::Runtime::GetModuleDir() / L"Nodes.idx";
+}
+
+inline std::filesystem::path TraceDir()
+{
+    return Core::Runtime::GetModuleDir() / L"traces";
+}
+
 inline bool IsPrePatch212a()
 {
     auto& fileVer = Core::Runtime::GetHost()->GetFileVer();
@@ -11,6 +11,7 @@ Red::ClassLocator<Red::IScriptable> s_IScriptableType;
 void App::ObjectRegistry::OnBootstrap()
 {
     s_objects.reserve(MaxNumObjects);
+    s_shrinkSize = MaxNumObjects - 1;
 
     Hook<Raw::ISerializable::CreateHandle>(&OnCreateHandle);
 }
@@ -26,7 +27,7 @@ void* App::ObjectRegistry::OnCreateHandle(Red::Handle<Red::ISerializable>& aHand
         std::unique_lock lock(s_registryLock);
         s_objects.emplace_back(aHandle);
 
-        if (s_objects.size() >= MaxNumObjects - 1)
+        if (s_objects.size() >= s_shrinkSize)
         {
             Shrink();
         }
@@ -148,8 +149,58 @@ void App::ObjectRegistry::RestoreSnapshot()
     Shrink();
 }
 
+void App::ObjectRegistry::CollectMemoryUsage(Core::Vector<MemoryUsage>& aUsage)
+{
+    {
+        std::shared_lock lock(s_registryLock);
+        aUsage.push_back({"ObjectRegistry.Objects", s_objects.size(), MemoryAccounting::GetBytes(s_objects),
+                          s_objectsBudget});
+    }
+
+    {
+        std::shared_lock lock(s_snapshotLock);
+
+        MemoryUsage usage{"ObjectRegistry.Snapshot", s_snapshot.size(), MemoryAccounting::GetBytes(s_snapshot)};
+
+        for (const auto& [name, desc] : s_snapshot)
+        {
+            usage.bytes += MemoryAccounting::GetBytes(desc.props);
+        }
+
+        aUsage.push_back(usage);
+    }
+}
+
+void App::ObjectRegistry::SetObjectsBudget(uint64_t aBytes)
+{
+    std::unique_lock lock(s_registryLock);
+    s_objectsBudget = aBytes;
+
+    Shrink();
+}
+
 void App::ObjectRegistry::Shrink()
 {
     auto [b, e] = std::ranges::remove_if(s_objects, [](auto& x) { return x.Expired(); });
     s_objects.erase(b, e);
+
+    if (!s_objectsBudget)
+    {
+        s_shrinkSize = MaxNumObjects - 1;
+        return;
+    }
+
+    // The reserved block is given back when it's over the budget, the list grows past the budget only when
+    // there are more live objects than it allows
+    const auto budgetSize = std::max<size_t>(s_objectsBudget / sizeof(Red::WeakHandle<Red::ISerializable>), 1);
+
+    if (s_objects.capacity() > budgetSize && s_objects.size() < budgetSize)
+    {
+        Core::Vector<Red::WeakHandle<Red::ISerializable>> objects;
+        objects.reserve(budgetSize);
+        objects.assign(std::make_move_iterator(s_objects.begin()), std::make_move_iterator(s_objects.end()));
+        s_objects.swap(objects);
+    }
+
+    s_shrinkSize = std::min<size_t>(std::max(budgetSize, s_objects.size() * 2), MaxNumObjects - 1);
 }
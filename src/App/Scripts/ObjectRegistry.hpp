@@ -3,6 +3,7 @@
 #include "Core/Foundation/Feature.hpp"
 #include "Core/Hooking/HookingAgent.hpp"
 #include "Core/Logging/LoggingAgent.hpp"
+#include "App/Shared/MemoryUsage.hpp"
 
 namespace App
 {
@@ -17,6 +18,9 @@ public:
     void CreateSnapshot();
     void RestoreSnapshot();
 
+    void CollectMemoryUsage(Core::Vector<MemoryUsage>& aUsage);
+    void SetObjectsBudget(uint64_t aBytes);
+
 protected:
     void OnBootstrap() override;
 
@@ -43,6 +47,8 @@ protected:
 
     inline static std::shared_mutex s_registryLock;
     inline static Core::Vector<Red::WeakHandle<Red::ISerializable>> s_objects;
+    inline static size_t s_shrinkSize{0};
+    inline static uint64_t s_objectsBudget{0};
 
     inline static std::shared_mutex s_snapshotLock;
     inline static Core::Map<Red::CName, ClassDesc> s_snapshot;
@@ -0,0 +1,76 @@
+#pragma once
+
+namespace App
+{
+// Memory held by a long lived structure.
+// The bytes are estimated from the capacity of the containers, allocator overhead isn't included.
+// Structures with a budget compact themselves or evict cold data when they grow past it, zero means no budget.
+struct MemoryUsage
+{
+    Red::CName name;
+    uint64_t entries{0};
+    uint64_t bytes{0};
+    uint64_t budget{0};
+};
+
+namespace MemoryAccounting
+{
+template<typename T>
+concept HopscotchContainer = requires(const T& aContainer)
+{
+    aContainer.bucket_count();
+    aContainer.overflow_size();
+};
+
+template<typename T>
+concept SequenceContainer = requires(const T& aContainer)
+{
+    aContainer.capacity();
+};
+
+template<SequenceContainer T>
+inline uint64_t GetBytes(const T& aContainer)
+{
+    return aContainer.capacity() * sizeof(typename T::value_type);
+}
+
+template<typename T>
+inline uint64_t GetBytes(const Red::DynArray<T>& aContainer)
+{
+    return aContainer.capacity * sizeof(T);
+}
+
+// Every bucket keeps the neighborhood bitmap next to the value, overflown values are kept in a list.
+template<HopscotchContainer T>
+inline uint64_t GetBytes(const T& aContainer)
+{
+    return aContainer.bucket_count() * (sizeof(typename T::value_type) + sizeof(uint64_t)) +
+           aContainer.overflow_size() * (sizeof(typename T::value_type) + 2 * sizeof(void*));
+}
+
+// Red-black tree nodes have three links and a color next to the value.
+template<typename K, typename V>
+inline uint64_t GetBytes(const Core::SortedMap<K, V>& aContainer)
+{
+    return aContainer.size() * (sizeof(typename Core::SortedMap<K, V>::value_type) + 4 * sizeof(void*));
+}
+
+// Only the heap part of the string, short strings are stored inline.
+inline uint64_t GetHeapBytes(const std::string& aString)
+{
+    return aString.capacity() > std::string().capacity() ? aString.capacity() + 1 : 0;
+}
+
+inline bool IsOverBudget(const MemoryUsage& aUsage)
+{
+    return aUsage.budget && aUsage.bytes > aUsage.budget;
+}
+}
+}
+
+RTTI_DEFINE_CLASS(App::MemoryUsage, {
+    RTTI_PROPERTY(name);
+    RTTI_PROPERTY(entries);
+    RTTI_PROPERTY(bytes);
+    RTTI_PROPERTY(budget);
+});
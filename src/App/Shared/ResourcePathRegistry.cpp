@@ -107,3 +107,18 @@ void App::ResourcePathRegistry::RegisterPath(Red::ResourcePath aPath, const std:
         s_instance->m_map[aPath] = aPathStr;
     }
 }
+
+void App::ResourcePathRegistry::CollectMemoryUsage(Core::Vector<MemoryUsage>& aUsage)
+{
+    std::shared_lock _(s_instance->m_lock);
+
+    MemoryUsage usage{"ResourcePathRegistry.Paths", s_instance->m_map.size(),
+                      MemoryAccounting::GetBytes(s_instance->m_map)};
+
+    for (const auto& [path, pathStr] : s_instance->m_map)
+    {
+        usage.bytes += MemoryAccounting::GetHeapBytes(pathStr);
+    }
+
+    aUsage.push_back(usage);
+}
@@ -3,6 +3,7 @@
 #include "Core/Foundation/Feature.hpp"
 #include "Core/Hooking/HookingAgent.hpp"
 #include "Core/Logging/LoggingAgent.hpp"
+#include "App/Shared/MemoryUsage.hpp"
 #include "Red/ResourcePath.hpp"
 
 namespace App
@@ -21,6 +22,9 @@ public:
     Red::ResourcePath RegisterPath(const std::string& aPathStr);
     void RegisterPath(Red::ResourcePath aPath, const std::string& aPathStr);
 
+    // The paths have no budget, they can't be recovered once dropped and the map is shared between versions.
+    void CollectMemoryUsage(Core::Vector<MemoryUsage>& aUsage);
+
 protected:
     struct SharedInstance
     {
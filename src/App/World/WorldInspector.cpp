@@ -1,3 +1,6 @@
+#include "App/Environment.hpp"
+#include "App/Scripts/ObjectRegistry.hpp"
+#include "App/Shared/ResourcePathRegistry.hpp"
 #include "Core/Facades/Container.hpp"
 #include "Core/Facades/Log.hpp"
 #include "Red/CameraSystem.hpp"
@@ -9,11 +12,13 @@
 #include "Red/Transform.hpp"
 #include "Red/WorldNode.hpp"
 #include "WorldInspector.hpp"
+#include "WorldTraceRecorder.hpp"
 
 void App::WorldInspector::OnWorldAttached(Red::world::RuntimeScene*)
 {
     m_nodeRegistry = Core::Resolve<WorldNodeRegistry>();
-    m_nodeRegistry->RegisterWatcher(this);
+    m_nodeEvents = m_nodeRegistry->RegisterWatcher();
+    m_nodeEventHashes.clear();
 
     m_cameraSystem = Red::GetGameSystem<Red::gameICameraSystem>();
 
@@ -22,18 +27,46 @@ void App::WorldInspector::OnWorldAttached(Red::world::RuntimeScene*)
 
 void App::WorldInspector::OnAfterWorldDetach()
 {
-    m_nodeRegistry->UnregisterWatcher(this);
+    if (WorldTraceRecorder::IsRecording())
+    {
+        WorldTraceRecorder::RecordWorldDetach();
+    }
+
+    m_nodeRegistry->UnregisterWatcher(m_nodeEvents);
+    m_nodeEvents.reset();
     m_nodeRegistry->ClearRuntimeData();
 
     {
         std::unique_lock _(m_streamedNodesLock);
         m_streamedNodes.clear();
+        m_streamedNodesIndex.Clear();
+        m_streamedNodesBounds.Clear();
+        m_streamedNodesDataBytes = 0;
+        m_streamedNodesCompactSize = 0;
+        ++m_streamedNodesVersion;
+    }
+
+    {
+        std::unique_lock _(m_postponedRequestsLock);
+        m_postponedRequests.clear();
+    }
+
+    {
+        std::unique_lock _(m_visibilityLock);
+        m_visibilityLayers.clear();
     }
 
     {
         std::unique_lock _(m_frustumNodesLock);
-        m_frustumNodes.Clear();
-        m_targetedNodes.Clear();
+        ResetFrustumChanges();
+    }
+
+    m_frustumSnapshot.store(Core::MakeShared<const FrustumSnapshot>());
+
+    {
+        std::unique_lock _(m_scannerLock);
+        m_scannedNodes.clear();
+        m_scannedRecords.clear();
     }
 }
 
@@ -61,20 +94,82 @@ void App::WorldInspector::OnRegisterUpdates(Red::UpdateRegistrar* aRegistrar)
                                });
 }
 
-void App::WorldInspector::OnNodeStreamedIn(uint64_t aNodeHash,
-                                             Red::worldNode* aNodeDefinition,
-                                             Red::worldINodeInstance* aNodeInstance,
-                                             Red::CompiledNodeInstanceSetupInfo* aNodeSetup)
+void App::WorldInspector::CollectStreamingRequests(Core::Map<uint64_t, WorldNodeStreamingRequest>& aRequests)
 {
-    std::unique_lock _(m_pendingRequestsLock);
-    m_pendingRequests[aNodeHash] = {true, aNodeHash, Red::AsWeakHandle(aNodeInstance),
-                                    Red::AsWeakHandle(aNodeDefinition), aNodeSetup};
-}
+    if (!m_nodeEvents)
+        return;
 
-void App::WorldInspector::OnNodeStreamedOut(uint64_t aNodeHash)
-{
-    std::unique_lock _(m_pendingRequestsLock);
-    m_pendingRequests[aNodeHash] = {false, aNodeHash};
+    // Some events were lost, so the known state can't be trusted anymore and is rebuilt from the registry
+    if (m_nodeEvents->ConsumeOverflow())
+    {
+        Core::Vector<WorldNodeInstanceEvent> droppedEvents;
+        m_nodeEvents->Drain(droppedEvents);
+
+        {
+            std::unique_lock _(m_streamedNodesLock);
+            m_streamedNodes.clear();
+            m_streamedNodesIndex.Clear();
+            m_streamedNodesDataBytes = 0;
+            ++m_streamedNodesVersion;
+
+            if (WorldTraceRecorder::IsRecording())
+            {
+                WorldTraceRecorder::RecordIndexClear();
+            }
+        }
+
+        {
+            std::unique_lock _(m_postponedRequestsLock);
+            m_postponedRequests.clear();
+        }
+
+        aRequests.clear();
+        m_nodeEventHashes.clear();
+
+        for (const auto& node : m_nodeRegistry->GetAllStreamedNodes())
+        {
+            if (node.nodeInstance)
+            {
+                auto nodeHash = reinterpret_cast<uint64_t>(node.setup);
+                aRequests[nodeHash] = {true, nodeHash, node.nodeInstance, node.nodeDefinition, node.setup};
+                m_nodeEventHashes[node.nodeInstance.instance] = nodeHash;
+            }
+        }
+
+        return;
+    }
+
+    Core::Vector<WorldNodeInstanceEvent> events;
+    m_nodeEvents->Drain(events);
+
+    // The hooks only push the instances, they're resolved here, so the hooks never take the registry locks.
+    // Detached instances can already be gone from the registry, so they're mapped to the hashes known from attach.
+    for (const auto& event : events)
+    {
+        if (event.type == WorldNodeInstanceEventType::StreamedIn)
+        {
+            auto node = m_nodeRegistry->ResolveNodeInstance(event.nodeInstance);
+
+            if (!node.setup)
+                continue;
+
+            auto nodeHash = reinterpret_cast<uint64_t>(node.setup);
+            aRequests[nodeHash] = {true, nodeHash, std::move(node.nodeInstance), std::move(node.nodeDefinition),
+                                   node.setup};
+            m_nodeEventHashes[event.nodeInstance] = nodeHash;
+        }
+        else
+        {
+            const auto& it = m_nodeEventHashes.find(event.nodeInstance);
+
+            if (it == m_nodeEventHashes.end())
+                continue;
+
+            auto nodeHash = it->second;
+            m_nodeEventHashes.erase(it);
+            aRequests[nodeHash] = {false, nodeHash};
+        }
+    }
 }
 
 void App::WorldInspector::UpdateStreamedNodes()
@@ -84,36 +179,51 @@ void App::WorldInspector::UpdateStreamedNodes()
 #endif
 
     Core::Map<uint64_t, WorldNodeStreamingRequest> pendingRequests;
-    Core::Map<uint64_t, WorldNodeStreamingRequest> postponedRequests;
-    {
-        std::unique_lock requestLock(m_pendingRequestsLock);
-        pendingRequests = std::move(m_pendingRequests);
-    }
+    Core::Vector<std::pair<uint64_t, WorldNodeStreamingState>> requestStates;
+
+    CollectStreamingRequests(pendingRequests);
+    CollectPostponedRequests(pendingRequests);
 
     if (pendingRequests.empty())
         return;
 
+    requestStates.reserve(pendingRequests.size());
+
     std::unique_lock updateLock(m_streamedNodesLock);
     for (const auto& [hash, request] : pendingRequests)
     {
         if (!request.streaming)
         {
-            m_streamedNodes.erase(request.hash);
+            auto streamedNodeIt = m_streamedNodes.find(request.hash);
+            if (streamedNodeIt != m_streamedNodes.end())
+            {
+                m_streamedNodesDataBytes -= GetStreamedNodeDataSize(streamedNodeIt->second);
+                m_streamedNodes.erase(streamedNodeIt);
+                m_streamedNodesIndex.Remove(request.hash);
+                ++m_streamedNodesVersion;
+
+                if (WorldTraceRecorder::IsRecording())
+                {
+                    WorldTraceRecorder::RecordNodeRemove(request.hash);
+                }
+            }
+            requestStates.emplace_back(hash, WorldNodeStreamingState::Cancelled);
             continue;
         }
 
         auto nodeInstance = request.nodeInstance.Lock();
         auto nodeDefinition = request.nodeDefinition.Lock();
 
+        // A destroyed instance never becomes ready, a new instance for the same node comes with its own event
         if (!nodeInstance || !nodeDefinition)
         {
-            postponedRequests[hash] = request;
+            requestStates.emplace_back(hash, WorldNodeStreamingState::Destroyed);
             continue;
         }
 
         if (!Raw::WorldNodeInstance::IsAttached(nodeInstance))
         {
-            postponedRequests[hash] = request;
+            requestStates.emplace_back(hash, WorldNodeStreamingState::WaitingForAttach);
             continue;
         }
 
@@ -123,7 +233,9 @@ void App::WorldInspector::UpdateStreamedNodes()
         auto& transform = Raw::WorldNodeInstance::Transform::Ref(nodeInstance);
         auto& scale = Raw::WorldNodeInstance::Scale::Ref(nodeInstance);
 
-        if (Red::IsInstanceOf<Red::worldMeshNode>(nodeDefinition))
+        const auto classData = GetNodeClassData(nodeDefinition->GetType());
+
+        if (classData.boundsSource == NodeBoundsSource::Mesh)
         {
             auto& meshResource = Raw::WorldMeshNodeInstance::Mesh::Ref(nodeInstance);
 
@@ -136,28 +248,20 @@ void App::WorldInspector::UpdateStreamedNodes()
 
                 Red::TransformBox(boundingBox, transform);
 
-                streamedNode.testBoxes.push_back(boundingBox);
-                streamedNode.isStaticMesh = !Red::IsInstanceOf<Red::worldTerrainProxyMeshNode>(nodeDefinition) &&
-                                            !Red::IsInstanceOf<Red::worldRoadProxyMeshNode>(nodeDefinition);
+                streamedNode.testBoxes.Push(boundingBox);
+                streamedNode.isStaticMesh = classData.isStaticMesh;
             }
             else
             {
-                postponedRequests[hash] = request;
+                requestStates.emplace_back(hash, WorldNodeStreamingState::WaitingForResource);
                 continue;
             }
         }
-        else if (Red::IsInstanceOf<Red::worldStaticDecalNode>(nodeDefinition) ||
-                 Red::IsInstanceOf<Red::worldBendedMeshNode>(nodeDefinition) ||
-                 Red::IsInstanceOf<Red::worldFoliageNode>(nodeDefinition) ||
-                 Red::IsInstanceOf<Red::worldEntityNode>(nodeDefinition) ||
-                 Red::IsInstanceOf<Red::worldAreaShapeNode>(nodeDefinition) ||
-                 Red::IsInstanceOf<Red::worldGeometryShapeNode>(nodeDefinition) ||
-                 Red::IsInstanceOf<Red::worldStaticOccluderMeshNode>(nodeDefinition))
+        else if (classData.boundsSource == NodeBoundsSource::Definition)
         {
-            Red::Box boundingBox{{1.0, 0.0, 0.0, 0.0}, {-1.0, 0.0, 0.0, 0.0}};
-            Raw::WorldNode::GetBoundingBox(nodeDefinition, boundingBox);
+            Red::Box boundingBox;
 
-            if (Red::IsValidBox(boundingBox))
+            if (m_streamedNodesBounds.GetBounds(nodeDefinition, boundingBox))
             {
                 Red::ScaleBox(boundingBox, scale);
 
@@ -165,51 +269,190 @@ void App::WorldInspector::UpdateStreamedNodes()
 
                 Red::TransformBox(boundingBox, transform);
 
-                streamedNode.testBoxes.push_back(boundingBox);
-                streamedNode.isStaticMesh = !Red::IsInstanceOf<Red::worldAreaShapeNode>(nodeDefinition) &&
-                                            !Red::IsInstanceOf<Red::worldGeometryShapeNode>(nodeDefinition) &&
-                                            !Red::IsInstanceOf<Red::worldStaticOccluderMeshNode>(nodeDefinition);
+                streamedNode.testBoxes.Push(boundingBox);
+                streamedNode.isStaticMesh = classData.isStaticMesh;
             }
             else
             {
-                postponedRequests[hash] = request;
+                requestStates.emplace_back(hash, WorldNodeStreamingState::WaitingForBounds);
                 continue;
             }
         }
-        else if (Red::IsInstanceOf<Red::worldInstancedMeshNode>(nodeDefinition))
+        else if (classData.boundsSource == NodeBoundsSource::Instances)
         {
             auto& instanceBoxes = Raw::WorldInstancedMeshNode::Bounds::Ref(nodeDefinition);
             if (instanceBoxes.size > 0)
             {
+                streamedNode.testBoxes.Reserve(instanceBoxes.size);
                 for (const auto& instanceBox : instanceBoxes)
                 {
-                    streamedNode.testBoxes.push_back(instanceBox);
-                    streamedNode.isStaticMesh = true;
+                    streamedNode.testBoxes.Push(instanceBox);
+                    streamedNode.isStaticMesh = classData.isStaticMesh;
                 }
+
+                // Built once here, so frustum and crosshair tests don't have to go through every instance
+                streamedNode.testTree.Build(streamedNode.testBoxes);
             }
             else
             {
-                postponedRequests[hash] = request;
+                requestStates.emplace_back(hash, WorldNodeStreamingState::WaitingForBounds);
                 continue;
             }
         }
 
-        m_streamedNodes.emplace(request.hash, std::move(streamedNode));
+        const auto& [streamedNodeIt, inserted] = m_streamedNodes.emplace(request.hash, std::move(streamedNode));
+
+        if (inserted)
+        {
+            m_streamedNodesDataBytes += GetStreamedNodeDataSize(streamedNodeIt->second);
+
+            const auto bounds = GetStreamedNodeBounds(streamedNodeIt->second);
+            m_streamedNodesIndex.Insert(request.hash, bounds);
+            ++m_streamedNodesVersion;
+
+            if (WorldTraceRecorder::IsRecording())
+            {
+                WorldTraceRecorder::RecordNodeBounds(request.hash, bounds);
+            }
+        }
+
+        requestStates.emplace_back(hash, WorldNodeStreamingState::Resolved);
     }
 
+    if (m_streamedNodesBudget)
+    {
+        CompactStreamedNodes();
+    }
+
+    updateLock.unlock();
+
+    UpdatePostponedRequests(pendingRequests, requestStates);
+
 #ifndef NDEBUG
     const std::chrono::duration<double, std::milli> updateDuration = std::chrono::steady_clock::now() - updateStart;
-    Core::Log::Debug("UpdateStreamedNodes streamed={} requests={} postponed={} time={:.3f}ms",
-                     m_streamedNodes.size(), pendingRequests.size(), postponedRequests.size(), updateDuration.count());
+    const auto eventStats = m_nodeEvents ? m_nodeEvents->GetStats() : WorldNodeEventRingStats{};
+    const auto requestStats = GetStreamingRequestStats();
+    const auto boundsStats = m_streamedNodesBounds.GetStats();
+    const auto boundsLookups = boundsStats.hits + boundsStats.misses;
+    Core::Log::Debug("UpdateStreamedNodes streamed={} requests={} postponed={} expired={} dropped={} overflows={} "
+                     "bounds={} bounds_hits={:.1f}% time={:.3f}ms",
+                     m_streamedNodes.size(), pendingRequests.size(), requestStats.waiting, requestStats.expired,
+                     eventStats.dropped, eventStats.overflows, boundsStats.entries,
+                     boundsLookups ? 100.0 * static_cast<double>(boundsStats.hits) / boundsLookups : 0.0,
+                     updateDuration.count());
 #endif
+}
+
+void App::WorldInspector::CollectPostponedRequests(Core::Map<uint64_t, WorldNodeStreamingRequest>& aRequests)
+{
+    std::unique_lock _(m_postponedRequestsLock);
+
+    const auto now = std::chrono::steady_clock::now();
+
+    for (auto it = m_postponedRequests.begin(); it != m_postponedRequests.end(); ++it)
+    {
+        auto& postponedRequest = it.value();
+
+        // A new event for the node means its state has changed, so it's retried right away with a fresh backoff,
+        // a streamed out node is cancelled by the update instead
+        const auto& requestIt = aRequests.find(it->first);
+        if (requestIt != aRequests.end())
+        {
+            if (requestIt->second.streaming)
+            {
+                postponedRequest.attempts = 0;
+                postponedRequest.postponedAt = now;
+                ++m_streamingRequestStats.woken;
+            }
+            continue;
+        }
+
+        if (postponedRequest.retryAt <= now)
+        {
+            aRequests.emplace(it->first, postponedRequest.request);
+            ++m_streamingRequestStats.retried;
+        }
+    }
+}
+
+std::chrono::steady_clock::duration App::WorldInspector::GetStreamingRetryDelay(uint32_t aAttempts)
+{
+    // The delay doubles with every failed attempt, resources can take seconds to load on slow drives
+    const auto retryDelay = std::min(StreamingRetryMinDelay * static_cast<float>(1u << std::min(aAttempts, 8u)),
+                                     StreamingRetryMaxDelay);
+
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(retryDelay));
+}
+
+void App::WorldInspector::UpdatePostponedRequests(
+    const Core::Map<uint64_t, WorldNodeStreamingRequest>& aRequests,
+    const Core::Vector<std::pair<uint64_t, WorldNodeStreamingState>>& aRequestStates)
+{
+    std::unique_lock _(m_postponedRequestsLock);
 
-    if (!postponedRequests.empty())
+    const auto now = std::chrono::steady_clock::now();
+
+    for (const auto& [hash, state] : aRequestStates)
     {
-        std::unique_lock requestLock(m_pendingRequestsLock);
-        m_pendingRequests.reserve(postponedRequests.size());
-        for (const auto& request : postponedRequests)
+        auto postponedIt = m_postponedRequests.find(hash);
+
+        switch (state)
+        {
+        case WorldNodeStreamingState::Resolved:
+        case WorldNodeStreamingState::Cancelled:
+        case WorldNodeStreamingState::Destroyed:
+        {
+            if (postponedIt == m_postponedRequests.end())
+                break;
+
+            if (state == WorldNodeStreamingState::Resolved && WorldStreamingProfiler::IsProfiling())
+            {
+                const auto& postponedRequest = postponedIt->second;
+                if (auto nodeDefinition = postponedRequest.request.nodeDefinition.Lock())
+                {
+                    WorldStreamingProfiler::RecordPostponedWait(nodeDefinition->GetType()->GetName(),
+                                                                postponedRequest.queuedAt,
+                                                                WorldStreamingProfiler::GetTimestamp());
+                }
+            }
+
+            m_postponedRequests.erase(postponedIt);
+
+            if (state == WorldNodeStreamingState::Resolved)
+                ++m_streamingRequestStats.resolved;
+            else if (state == WorldNodeStreamingState::Cancelled)
+                ++m_streamingRequestStats.cancelled;
+            else
+                ++m_streamingRequestStats.destroyed;
+
+            break;
+        }
+        default:
         {
-            m_pendingRequests.insert(request);
+            if (postponedIt == m_postponedRequests.end())
+            {
+                m_postponedRequests.emplace(hash, PostponedRequest{aRequests.find(hash)->second, state, 0, now,
+                                                                  now + GetStreamingRetryDelay(0),
+                                                                  WorldStreamingProfiler::GetTimestamp()});
+                ++m_streamingRequestStats.postponed;
+                break;
+            }
+
+            auto& postponedRequest = postponedIt.value();
+
+            if (now - postponedRequest.postponedAt >= std::chrono::duration<float>(StreamingRetryMaxAge))
+            {
+                m_postponedRequests.erase(postponedIt);
+                ++m_streamingRequestStats.expired;
+                break;
+            }
+
+            postponedRequest.request = aRequests.find(hash)->second;
+            postponedRequest.state = state;
+            postponedRequest.attempts++;
+            postponedRequest.retryAt = now + GetStreamingRetryDelay(postponedRequest.attempts);
+            break;
+        }
         }
     }
 }
@@ -220,314 +463,1408 @@ void App::WorldInspector::UpdateFrustumNodes()
     std::chrono::duration<double, std::milli> initDuration{};
     std::chrono::duration<double, std::milli> resolveDuration{};
     std::chrono::duration<double, std::milli> raycastDuration{};
+    std::chrono::duration<double, std::milli> processDuration{};
     std::chrono::duration<double, std::milli> commitDuration{};
     const auto updateStart = std::chrono::steady_clock::now();
 #endif
 
-    Core::Vector<WorldNodeRuntimeSceneData> frustumNodes{};
-    Core::Vector<uint32_t> targetedNodeIndexes{};
+    Core::Vector<WorldNodeTopK<uint32_t>::Entry> targetedNodeIndexes{};
 
+    auto update = Core::MakeShared<FrustumUpdate>();
+    auto& view = update->view;
+
+    Raw::CameraSystem::GetCameraPosition(m_cameraSystem, *reinterpret_cast<Red::Vector3*>(&view.cameraPosition));
+    Raw::CameraSystem::GetCameraForward(m_cameraSystem, view.cameraForward);
+    Raw::CameraSystem::GetCameraFrustum(m_cameraSystem, view.cameraFrustum);
+
+    view.frustumDistance = m_frustumDistance;
+    view.targetingDistance = m_targetingDistance;
+    view.crosshairLimit = m_crosshairLimit;
+
+    // Unchanged views are recorded too, so the replay sees the same update rate
+    if (WorldTraceRecorder::IsRecording())
     {
-        std::shared_lock _(m_frustumNodesLock);
-        frustumNodes.reserve(m_frustumNodes.size);
-        targetedNodeIndexes.reserve(m_targetedNodes.size);
+        WorldTraceRecorder::RecordCameraUpdate(view.cameraFrustum, view.cameraPosition, view.cameraForward,
+                                               view.frustumDistance, view.targetingDistance);
     }
 
-    Red::Frustum cameraFrustum;
-    Red::Vector4 cameraPosition{};
-    Red::Vector4 cameraForward{};
+    {
+        std::shared_lock _(m_streamedNodesLock);
+        view.streamedNodesVersion = m_streamedNodesVersion;
+    }
 
-    Raw::CameraSystem::GetCameraPosition(m_cameraSystem, *reinterpret_cast<Red::Vector3*>(&cameraPosition));
-    Raw::CameraSystem::GetCameraForward(m_cameraSystem, cameraForward);
-    Raw::CameraSystem::GetCameraFrustum(m_cameraSystem, cameraFrustum);
+    if (!IsFrustumViewChanged(view))
+    {
+#ifndef NDEBUG
+        const std::chrono::duration<double, std::milli> skipDuration = std::chrono::steady_clock::now() - updateStart;
+        Core::Log::Debug("UpdateFrustumNodes skipped time={:.3f}ms", skipDuration.count());
+#endif
+        return;
+    }
 
-    const Red::Vector4 cameraInverseDirection{1.0f / cameraForward.X, 1.0f / cameraForward.Y, 1.0f / cameraForward.Z, 0.0};
+    update->cameraInverseDirection = {1.0f / view.cameraForward.X, 1.0f / view.cameraForward.Y,
+                                      1.0f / view.cameraForward.Z, 0.0};
+    update->streamedNodes = &m_streamedNodes;
+    update->chunkSize = m_frustumChunkSize;
 
 #ifndef NDEBUG
     initDuration = std::chrono::steady_clock::now() - updateStart;
 #endif
 
+    WorldNodeSpatialIndexStats indexStats{};
+    uint32_t workerCount = 0;
+
     {
         std::shared_lock _(m_streamedNodesLock);
-        for (const auto& [hash, streamedNode] : m_streamedNodes)
-        {
-            if (streamedNode.nodeInstance.Expired() || streamedNode.nodeDefinition.Expired())
-                continue;
 
-            // if (!Raw::WorldNodeInstance::SetupInfo::Ptr(streamedNode.nodeInstance.instance))
-            //     continue;
+        // The index only culls by the bounds of whole nodes, the individual test boxes are still checked by workers
+        m_streamedNodesIndex.Query(view.cameraFrustum, view.cameraPosition, view.frustumDistance,
+                                   m_streamedNodesQuery, update->candidateNodes);
+        indexStats = m_streamedNodesIndex.GetStats(m_streamedNodesQuery);
 
 #ifndef NDEBUG
-            const auto resolveStart = std::chrono::steady_clock::now();
+        const auto processStart = std::chrono::steady_clock::now();
 #endif
 
-            Red::FrustumResult frustumResult{};
-            Red::Box testBox{{1.0, 0.0, 0.0, 0.0}, {-1.0, 0.0, 0.0, 0.0}};
-
-            if (!streamedNode.testBoxes.empty())
-            {
-                for (const auto& candidateBox : streamedNode.testBoxes)
-                {
-                    if ((frustumResult = cameraFrustum.Test(candidateBox)) != Red::FrustumResult::Outside)
-                    {
-                        testBox = candidateBox;
-                        break;
-                    }
-                }
-            }
-            else
-            {
-                Red::Box dummyBox{{-0.05, -0.05, -0.05, 1.0}, {0.05, 0.05, 0.05, 1.0}};
-                Red::TransformBox(dummyBox, streamedNode.transform);
-
-                frustumResult = cameraFrustum.Test(dummyBox);
-            }
+        // The lock is held until every chunk is finished, so the workers can read streamed nodes without locking
+        workerCount = UpdateFrustumChunks(update);
 
 #ifndef NDEBUG
-            resolveDuration += std::chrono::steady_clock::now() - resolveStart;
-            const auto raycastStart = std::chrono::steady_clock::now();
+        processDuration = std::chrono::steady_clock::now() - processStart;
 #endif
-
-            float distance;
-            if (Red::IsValidBox(testBox))
-            {
-                distance = Red::Distance(cameraPosition, testBox);
-            }
-            else
-            {
-                distance = Red::Distance(cameraPosition, streamedNode.transform.position);
-            }
-
-            auto inFrustum = (frustumResult != Red::FrustumResult::Outside && distance <= m_frustumDistance);
-            if (inFrustum)
-            {
-                if (streamedNode.nodeDefinition.instance->isVisibleInGame &&
-                    streamedNode.isStaticMesh && Red::IsValidBox(testBox) &&
-                    distance >= 0.0001 && distance <= m_targetingDistance)
-                {
-                    if (Red::Intersect(cameraPosition, cameraInverseDirection, testBox))
-                    {
-                        targetedNodeIndexes.push_back(frustumNodes.size());
-                    }
-                }
-            }
-            else
-            {
-                continue;
-            }
+    }
 
 #ifndef NDEBUG
-            raycastDuration += std::chrono::steady_clock::now() - raycastStart;
+    const auto commitStart = std::chrono::steady_clock::now();
 #endif
 
-            const auto instanceHash = reinterpret_cast<uint64_t>(streamedNode.nodeInstance.instance);
-            frustumNodes.push_back({streamedNode.nodeInstance, streamedNode.nodeDefinition,
-                                    streamedNode.boundingBox, streamedNode.transform.position,
-                                    streamedNode.transform.orientation, streamedNode.scale,
-                                    testBox, distance, inFrustum, instanceHash, true});
-        }
+    // The snapshot is built in the back buffer, which is the previously published snapshot when no one holds it anymore
+    auto snapshot = std::move(m_frustumBackBuffer);
+
+    if (snapshot)
+    {
+        snapshot->frustumNodes.Clear();
+        snapshot->targetedNodes.Clear();
+    }
+    else
+    {
+        snapshot = Core::MakeShared<FrustumSnapshot>();
+        snapshot->frustumNodes.Reserve(m_frustumSnapshot.load()->frustumNodes.size);
     }
 
-#ifndef NDEBUG
-    const auto commitStart = std::chrono::steady_clock::now();
-#endif
+    auto& frustumNodes = snapshot->frustumNodes;
 
-    std::sort(targetedNodeIndexes.begin(), targetedNodeIndexes.end(),
-              [&frustumNodes](uint32_t a, uint32_t b)
-              {
-                  return frustumNodes[a].distance < frustumNodes[b].distance;
-              });
+    // Every chunk keeps only its nearest targets, the nearest of all chunks are selected from those.
+    // Chunks are merged in the order of candidates, so the result is the same as when processed on one thread.
+    WorldNodeTopK<uint32_t> targetedNodes(view.crosshairLimit);
 
+    for (auto& chunk : update->chunks)
     {
-        std::unique_lock _(m_frustumNodesLock);
+        const auto chunkOffset = frustumNodes.size;
 
-        m_frustumNodes.Clear();
-        m_frustumNodes.Reserve(frustumNodes.size());
-        for (const auto& node : frustumNodes)
+        for (const auto& [distance, index] : chunk.targetedNodes.GetEntries())
         {
-            m_frustumNodes.PushBack(node);
+            targetedNodes.Push(distance, chunkOffset + index);
         }
 
-        m_targetedNodes.Clear();
-        m_targetedNodes.Reserve(targetedNodeIndexes.size());
-        for (const auto& index : targetedNodeIndexes)
+        for (auto& node : chunk.nodes)
         {
-            m_targetedNodes.PushBack(m_frustumNodes[index]);
+            frustumNodes.PushBack(std::move(node));
         }
+
+#ifndef NDEBUG
+        resolveDuration += chunk.resolveDuration;
+        raycastDuration += chunk.raycastDuration;
+#endif
+    }
+
+    targetedNodes.Take(targetedNodeIndexes);
+
+    snapshot->targetedNodes.Reserve(static_cast<uint32_t>(targetedNodeIndexes.size()));
+    for (const auto& [distance, index] : targetedNodeIndexes)
+    {
+        snapshot->targetedNodes.PushBack(frustumNodes[index]);
+    }
+
+    {
+        std::unique_lock _(m_frustumNodesLock);
+
+        CommitFrustumChanges(frustumNodes);
+
+        m_frustumView = view;
+    }
+
+    const auto frustumNodeCount = frustumNodes.size;
+
+    // Readers that loaded the previous snapshot keep it alive, it's only reused when it's no longer shared
+    auto previousSnapshot = m_frustumSnapshot.exchange(std::move(snapshot));
+
+    if (previousSnapshot.use_count() == 1)
+    {
+        // The count is read relaxed, the fence orders the reuse after the reads of the last reader,
+        // which released its reference before dropping it
+        std::atomic_thread_fence(std::memory_order_acquire);
+        m_frustumBackBuffer = std::const_pointer_cast<FrustumSnapshot>(std::move(previousSnapshot));
     }
 
 #ifndef NDEBUG
     commitDuration = std::chrono::steady_clock::now() - commitStart;
 
+    // Resolving and raycasting are summed over all workers, the other phases run on the calling thread
     const std::chrono::duration<double, std::milli> updateDuration = std::chrono::steady_clock::now() - updateStart;
-    Core::Log::Debug("UpdateFrustumNodes streamed={} frustum={} targets={} "
-                     "time={:.3f}ms init={:.3f}ms resolving={:.3f}ms raycasting={:.3f}ms commit={:.3f}ms",
-                     m_streamedNodes.size(), m_frustumNodes.size, targetedNodeIndexes.size(),
-                     updateDuration.count(), initDuration.count(),
-                     resolveDuration.count(), raycastDuration.count(),
+    const auto cpuDuration = initDuration + resolveDuration + raycastDuration + commitDuration;
+    Core::Log::Debug("UpdateFrustumNodes streamed={} candidates={} cells={}/{} planes={} frustum={} targets={} "
+                     "chunks={} workers={} time={:.3f}ms cpu={:.3f}ms init={:.3f}ms process={:.3f}ms "
+                     "resolving={:.3f}ms(cpu) raycasting={:.3f}ms(cpu) commit={:.3f}ms",
+                     m_streamedNodes.size(), update->candidateNodes.size(), indexStats.visitedCells,
+                     indexStats.cells, indexStats.planeTests, frustumNodeCount,
+                     targetedNodeIndexes.size(), update->chunks.size(),
+                     workerCount, updateDuration.count(), cpuDuration.count(), initDuration.count(),
+                     processDuration.count(), resolveDuration.count(), raycastDuration.count(),
                      commitDuration.count());
 #endif
 }
 
-App::WorldNodeInstanceStaticData App::WorldInspector::ResolveSectorDataFromNodeID(uint64_t aNodeID)
+bool App::WorldInspector::IsFrustumViewChanged(const FrustumView& aView)
 {
-    {
-        static const Red::GlobalNodeRef context{Red::NodeRef::GlobalRoot};
+    std::shared_lock _(m_frustumNodesLock);
 
-        Red::NodeRef nodeRef{aNodeID};
-        Red::GlobalNodeRef resolvedRef{};
-        Red::CallGlobal("ResolveNodeRef", resolvedRef, nodeRef, context);
+    if (aView.streamedNodesVersion != m_frustumView.streamedNodesVersion ||
+        aView.frustumDistance != m_frustumView.frustumDistance ||
+        aView.targetingDistance != m_frustumView.targetingDistance ||
+        aView.crosshairLimit != m_frustumView.crosshairLimit ||
+        std::memcmp(&aView.cameraPosition, &m_frustumView.cameraPosition, sizeof(Red::Vector4)) != 0 ||
+        std::memcmp(&aView.cameraForward, &m_frustumView.cameraForward, sizeof(Red::Vector4)) != 0 ||
+        std::memcmp(&aView.cameraFrustum, &m_frustumView.cameraFrustum, sizeof(Red::Frustum)) != 0)
+        return true;
 
-        if (resolvedRef.hash != 0)
-        {
-            aNodeID = resolvedRef.hash;
-        }
+    const auto snapshot = m_frustumSnapshot.load();
+
+    // Dynamic entities can be destroyed while their nodes are still streamed, so they have to be refreshed anyway
+    for (const auto& node : snapshot->frustumNodes)
+    {
+        if (node.nodeInstance.Expired() || node.nodeDefinition.Expired())
+            return true;
     }
 
-    return m_nodeRegistry->GetNodeStaticData(aNodeID);
+    return false;
 }
 
-App::WorldNodeInstanceStaticData App::WorldInspector::ResolveSectorDataFromNodeInstance(
-    const Red::WeakHandle<Red::worldINodeInstance>& aNodeInstance)
+uint32_t App::WorldInspector::UpdateFrustumChunks(const Core::SharedPtr<FrustumUpdate>& aUpdate)
 {
-    return m_nodeRegistry->GetNodeStaticData(aNodeInstance);
-}
+    const auto candidateCount = static_cast<uint32_t>(aUpdate->candidateNodes.size());
+    const auto chunkCount = (candidateCount + aUpdate->chunkSize - 1) / aUpdate->chunkSize;
 
-Red::CString App::WorldInspector::ResolveNodeRefFromNodeHash(uint64_t aNodeID)
-{
-    if (!aNodeID)
-        return {};
+    aUpdate->chunks.resize(chunkCount);
 
-    {
-        static const Red::GlobalNodeRef context{Red::NodeRef::GlobalRoot};
+    if (chunkCount == 0)
+        return 0;
 
-        Red::NodeRef nodeRef{aNodeID};
-        Red::GlobalNodeRef resolvedRef{};
-        Red::CallGlobal("ResolveNodeRef", resolvedRef, nodeRef, context);
+    // The calling thread is one of the workers, so the update still progresses when the job queue is busy
+    const auto workerCount = std::min(chunkCount, std::max(std::thread::hardware_concurrency(), 1u));
 
-        if (resolvedRef.hash != 0)
+    if (workerCount > 1)
+    {
+        Red::JobQueue jobQueue;
+        for (uint32_t workerIndex = 1; workerIndex < workerCount; ++workerIndex)
         {
-            aNodeID = resolvedRef.hash;
+            jobQueue.Dispatch([aUpdate] { ProcessFrustumChunks(*aUpdate); });
         }
     }
 
-    {
-        Red::CString debugStr;
-        Red::EntityID entityID{aNodeID};
-        Raw::EntityID::ToStringDEBUG(entityID, debugStr);
+    ProcessFrustumChunks(*aUpdate);
 
-        if (debugStr.Length() != 0)
-        {
-            std::string_view debugStrView(debugStr.c_str(), debugStr.Length());
-            if (!debugStrView.starts_with("UNKNOWN:") && !debugStrView.starts_with("dynamic:"))
-                return debugStr;
-        }
-    }
+    std::unique_lock lock(aUpdate->finishedLock);
+    aUpdate->finishedEvent.wait(lock, [&aUpdate, chunkCount] { return aUpdate->finishedChunks == chunkCount; });
 
-    return {};
+    return workerCount;
 }
 
-uint64_t App::WorldInspector::ComputeNodeRefHash(const Red::CString& aNodeRef)
+void App::WorldInspector::ProcessFrustumChunks(FrustumUpdate& aUpdate)
 {
-    return Red::NodeRef(aNodeRef.c_str());
-}
+    const auto chunkCount = static_cast<uint32_t>(aUpdate.chunks.size());
 
-Red::EntityID App::WorldInspector::ResolveCommunityIDFromEntityID(uint64_t aEntityID)
-{
-    auto entityStubSystem = Red::GetGameSystem<Red::IEntityStubSystem>();
-    auto entityStub = entityStubSystem->FindStub(aEntityID);
+    while (true)
+    {
+        const auto chunkIndex = aUpdate.nextChunk++;
 
-    if (!entityStub)
-        return {};
+        if (chunkIndex >= chunkCount)
+            break;
 
-    return entityStub->stubState->spawnerId.entityId;
+        ProcessFrustumChunk(aUpdate, chunkIndex);
+
+        {
+            std::unique_lock _(aUpdate.finishedLock);
+            ++aUpdate.finishedChunks;
+        }
+
+        aUpdate.finishedEvent.notify_all();
+    }
 }
 
-App::WorldCommunityEntryData App::WorldInspector::ResolveCommunityEntryDataFromEntityID(uint64_t aEntityID)
+void App::WorldInspector::ProcessFrustumChunk(FrustumUpdate& aUpdate, uint32_t aChunkIndex)
 {
-    WorldCommunityEntryData communityEntryData{};
+    auto& chunk = aUpdate.chunks[aChunkIndex];
+    const auto& streamedNodes = *aUpdate.streamedNodes;
+    auto& cameraFrustum = aUpdate.view.cameraFrustum;
+    const auto& cameraPosition = aUpdate.view.cameraPosition;
+
+    const auto candidateBegin = aChunkIndex * aUpdate.chunkSize;
+    const auto candidateEnd = std::min(candidateBegin + aUpdate.chunkSize,
+                                       static_cast<uint32_t>(aUpdate.candidateNodes.size()));
+
+    chunk.nodes.reserve(candidateEnd - candidateBegin);
+    chunk.targetedNodes.Reset(aUpdate.view.crosshairLimit);
+
+    for (auto candidateIndex = candidateBegin; candidateIndex < candidateEnd; ++candidateIndex)
+    {
+        const auto& streamedNodeIt = streamedNodes.find(aUpdate.candidateNodes[candidateIndex]);
+
+        if (streamedNodeIt == streamedNodes.end())
+            continue;
+
+        const auto& streamedNode = streamedNodeIt->second;
+
+        if (streamedNode.nodeInstance.Expired() || streamedNode.nodeDefinition.Expired())
+            continue;
+
+        // if (!Raw::WorldNodeInstance::SetupInfo::Ptr(streamedNode.nodeInstance.instance))
+        //     continue;
+
+#ifndef NDEBUG
+        const auto resolveStart = std::chrono::steady_clock::now();
+#endif
+
+        Red::FrustumResult frustumResult{};
+        Red::Box testBox{{1.0, 0.0, 0.0, 0.0}, {-1.0, 0.0, 0.0, 0.0}};
+
+        int32_t meshInstanceIndex = -1;
+
+        if (!streamedNode.testTree.IsEmpty())
+        {
+            float instanceDistance;
+            const auto testBoxIndex = streamedNode.testTree.FindNearest(cameraFrustum, streamedNode.testBoxes,
+                                                                        cameraPosition, aUpdate.view.frustumDistance,
+                                                                        instanceDistance);
+
+            if (testBoxIndex < 0)
+                continue;
+
+            frustumResult = Red::FrustumResult::Intersecting;
+            testBox = streamedNode.testBoxes.Get(testBoxIndex);
+            meshInstanceIndex = static_cast<int32_t>(streamedNode.testTree.GetSourceIndex(testBoxIndex));
+        }
+        else
+        {
+            // The index has already tested the same bounds, so a node with a single box can't be outside here
+            frustumResult = Red::FrustumResult::Intersecting;
+
+            if (!streamedNode.testBoxes.IsEmpty())
+            {
+                testBox = streamedNode.testBoxes.Get(0);
+            }
+        }
+
+#ifndef NDEBUG
+        chunk.resolveDuration += std::chrono::steady_clock::now() - resolveStart;
+        const auto raycastStart = std::chrono::steady_clock::now();
+#endif
+
+        float distance;
+        if (Red::IsValidBox(testBox))
+        {
+            distance = Red::Distance(cameraPosition, testBox);
+        }
+        else
+        {
+            distance = Red::Distance(cameraPosition, streamedNode.transform.position);
+        }
+
+        auto inFrustum = (frustumResult != Red::FrustumResult::Outside && distance <= aUpdate.view.frustumDistance);
+        if (inFrustum)
+        {
+            if (streamedNode.nodeDefinition.instance->isVisibleInGame && streamedNode.isStaticMesh)
+            {
+                if (!streamedNode.testTree.IsEmpty())
+                {
+                    // The targeted instance isn't necessarily the nearest one in the frustum
+                    float instanceDistance;
+                    const auto testBoxIndex = streamedNode.testTree.FindNearest(
+                        cameraPosition, aUpdate.cameraInverseDirection, streamedNode.testBoxes, 0.0001f,
+                        aUpdate.view.targetingDistance, instanceDistance);
+
+                    if (testBoxIndex >= 0)
+                    {
+                        testBox = streamedNode.testBoxes.Get(testBoxIndex);
+                        distance = instanceDistance;
+                        meshInstanceIndex = static_cast<int32_t>(streamedNode.testTree.GetSourceIndex(testBoxIndex));
+
+                        chunk.targetedNodes.Push(distance, static_cast<uint32_t>(chunk.nodes.size()));
+                    }
+                }
+                else if (Red::IsValidBox(testBox) && distance >= 0.0001 &&
+                         distance <= aUpdate.view.targetingDistance)
+                {
+                    if (Red::Intersect(cameraPosition, aUpdate.cameraInverseDirection, testBox))
+                    {
+                        chunk.targetedNodes.Push(distance, static_cast<uint32_t>(chunk.nodes.size()));
+                    }
+                }
+            }
+        }
+        else
+        {
+            continue;
+        }
+
+#ifndef NDEBUG
+        chunk.raycastDuration += std::chrono::steady_clock::now() - raycastStart;
+#endif
+
+        const auto instanceHash = reinterpret_cast<uint64_t>(streamedNode.nodeInstance.instance);
+        chunk.nodes.push_back({streamedNode.nodeInstance, streamedNode.nodeDefinition,
+                               streamedNode.boundingBox, streamedNode.transform.position,
+                               streamedNode.transform.orientation, streamedNode.scale,
+                               testBox, distance, inFrustum, instanceHash, true, meshInstanceIndex});
+    }
+}
+
+Red::Box App::WorldInspector::GetStreamedNodeBounds(const WorldNodeStaticSceneData& aStreamedNode)
+{
+    if (aStreamedNode.testBoxes.IsEmpty())
+    {
+        Red::Box dummyBox{{-0.05, -0.05, -0.05, 1.0}, {0.05, 0.05, 0.05, 1.0}};
+        Red::TransformBox(dummyBox, aStreamedNode.transform);
+
+        return dummyBox;
+    }
+
+    const auto& testBoxes = aStreamedNode.testBoxes;
+
+    return {{*std::min_element(testBoxes.minX.begin(), testBoxes.minX.end()),
+             *std::min_element(testBoxes.minY.begin(), testBoxes.minY.end()),
+             *std::min_element(testBoxes.minZ.begin(), testBoxes.minZ.end()), 1.0f},
+            {*std::max_element(testBoxes.maxX.begin(), testBoxes.maxX.end()),
+             *std::max_element(testBoxes.maxY.begin(), testBoxes.maxY.end()),
+             *std::max_element(testBoxes.maxZ.begin(), testBoxes.maxZ.end()), 1.0f}};
+}
+
+size_t App::WorldInspector::GetStreamedNodeDataSize(const WorldNodeStaticSceneData& aStreamedNode)
+{
+    return aStreamedNode.testBoxes.GetMemorySize() + aStreamedNode.testTree.GetMemorySize();
+}
+
+App::MemoryUsage App::WorldInspector::GetStreamedNodesUsage()
+{
+    return {"WorldInspector.StreamedNodes", m_streamedNodes.size(),
+            MemoryAccounting::GetBytes(m_streamedNodes) + m_streamedNodesDataBytes, m_streamedNodesBudget};
+}
+
+void App::WorldInspector::CompactStreamedNodes()
+{
+    const auto usage = GetStreamedNodesUsage();
+
+    // The table only shrinks when it grew past the budget and a lot of nodes were unloaded since the last attempt,
+    // otherwise a table that is over budget because of its content would be rehashed on every update
+    if (!MemoryAccounting::IsOverBudget(usage) || usage.bytes < m_streamedNodesCompactSize)
+        return;
+
+    m_streamedNodes.rehash(0);
+
+    const auto compactedUsage = GetStreamedNodesUsage();
+    m_streamedNodesCompactSize = compactedUsage.bytes + compactedUsage.bytes / 4;
+
+    Core::Log::Info("WorldInspector: Compacted streamed nodes from {} to {} bytes, budget is {} bytes.", usage.bytes,
+                    compactedUsage.bytes, usage.budget);
+}
+
+void App::WorldInspector::CommitFrustumChanges(const Red::DynArray<WorldNodeRuntimeSceneData>& aFrustumNodes)
+{
+    const auto generation = ++m_frustumGeneration;
+
+    for (const auto& node : aFrustumNodes)
+    {
+        auto stateIt = m_frustumNodeStates.find(node.hash);
+
+        if (stateIt == m_frustumNodeStates.end())
+        {
+            m_frustumNodeStates.insert({node.hash, {node, generation, generation, generation}});
+            continue;
+        }
+
+        auto& state = stateIt.value();
+
+        // The distance changes with every camera move, so only a noticeable difference counts as a move
+        const auto moved = std::abs(state.node.distance - node.distance) > FrustumMoveTolerance ||
+                           std::memcmp(&state.node.position, &node.position, sizeof(node.position)) != 0 ||
+                           std::memcmp(&state.node.orientation, &node.orientation, sizeof(node.orientation)) != 0 ||
+                           std::memcmp(&state.node.testBox, &node.testBox, sizeof(node.testBox)) != 0;
+
+        if (moved)
+        {
+            state.node = node;
+            state.movedGeneration = generation;
+        }
+
+        state.seenGeneration = generation;
+    }
+
+    for (auto stateIt = m_frustumNodeStates.begin(); stateIt != m_frustumNodeStates.end();)
+    {
+        if (stateIt->second.seenGeneration != generation)
+        {
+            m_frustumRemovals.emplace_back(generation, stateIt->first);
+            stateIt = m_frustumNodeStates.erase(stateIt);
+        }
+        else
+        {
+            ++stateIt;
+        }
+    }
+
+    if (generation > FrustumHistorySize && m_frustumHistoryStart < generation - FrustumHistorySize)
+    {
+        m_frustumHistoryStart = generation - FrustumHistorySize;
+
+        const auto& historyEnd = std::find_if(m_frustumRemovals.begin(), m_frustumRemovals.end(),
+                                              [this](const std::pair<uint32_t, uint64_t>& aRemoval)
+                                              {
+                                                  return aRemoval.first > m_frustumHistoryStart;
+                                              });
+        m_frustumRemovals.erase(m_frustumRemovals.begin(), historyEnd);
+    }
+}
+
+void App::WorldInspector::ResetFrustumChanges()
+{
+    m_frustumNodeStates.clear();
+    m_frustumRemovals.clear();
+    m_frustumHistoryStart = ++m_frustumGeneration;
+}
+
+App::WorldNodeInstanceStaticData App::WorldInspector::ResolveSectorDataFromNodeID(uint64_t aNodeID)
+{
+    {
+        static const Red::GlobalNodeRef context{Red::NodeRef::GlobalRoot};
+
+        Red::NodeRef nodeRef{aNodeID};
+        Red::GlobalNodeRef resolvedRef{};
+        Red::CallGlobal("ResolveNodeRef", resolvedRef, nodeRef, context);
+
+        if (resolvedRef.hash != 0)
+        {
+            aNodeID = resolvedRef.hash;
+        }
+    }
+
+    return m_nodeRegistry->GetNodeStaticData(aNodeID);
+}
 
+App::WorldNodeInstanceStaticData App::WorldInspector::ResolveSectorDataFromNodeInstance(
+    const Red::WeakHandle<Red::worldINodeInstance>& aNodeInstance)
+{
+    return m_nodeRegistry->GetNodeStaticData(aNodeInstance);
+}
+
+Red::CString App::WorldInspector::ResolveNodeRefFromNodeHash(uint64_t aNodeID)
+{
+    if (!aNodeID)
+        return {};
+
+    {
+        static const Red::GlobalNodeRef context{Red::NodeRef::GlobalRoot};
+
+        Red::NodeRef nodeRef{aNodeID};
+        Red::GlobalNodeRef resolvedRef{};
+        Red::CallGlobal("ResolveNodeRef", resolvedRef, nodeRef, context);
+
+        if (resolvedRef.hash != 0)
+        {
+            aNodeID = resolvedRef.hash;
+        }
+    }
+
+    {
+        Red::CString debugStr;
+        Red::EntityID entityID{aNodeID};
+        Raw::EntityID::ToStringDEBUG(entityID, debugStr);
+
+        if (debugStr.Length() != 0)
+        {
+            std::string_view debugStrView(debugStr.c_str(), debugStr.Length());
+            if (!debugStrView.starts_with("UNKNOWN:") && !debugStrView.starts_with("dynamic:"))
+                return debugStr;
+        }
+    }
+
+    return {};
+}
+
+uint64_t App::WorldInspector::ComputeNodeRefHash(const Red::CString& aNodeRef)
+{
+    return Red::NodeRef(aNodeRef.c_str());
+}
+
+Red::EntityID App::WorldInspector::ResolveCommunityIDFromEntityID(uint64_t aEntityID)
+{
     auto entityStubSystem = Red::GetGameSystem<Red::IEntityStubSystem>();
     auto entityStub = entityStubSystem->FindStub(aEntityID);
 
     if (!entityStub)
+        return {};
+
+    return entityStub->stubState->spawnerId.entityId;
+}
+
+App::WorldCommunityEntryData App::WorldInspector::ResolveCommunityEntryDataFromEntityID(uint64_t aEntityID)
+{
+    auto entityStubSystem = Red::GetGameSystem<Red::IEntityStubSystem>();
+    auto communitySystem = Red::GetGameSystem<Red::ICommunitySystem>();
+
+    return ResolveCommunityEntryData(entityStubSystem, communitySystem, aEntityID);
+}
+
+Red::DynArray<App::WorldCommunityEntryData> App::WorldInspector::ResolveCommunityEntryDataFromEntityIDs(
+    const Red::DynArray<uint64_t>& aEntityIDs)
+{
+    Red::DynArray<WorldCommunityEntryData> communityEntries;
+    communityEntries.Reserve(aEntityIDs.size);
+
+    auto entityStubSystem = Red::GetGameSystem<Red::IEntityStubSystem>();
+    auto communitySystem = Red::GetGameSystem<Red::ICommunitySystem>();
+
+    for (const auto& entityID : aEntityIDs)
+    {
+        communityEntries.PushBack(ResolveCommunityEntryData(entityStubSystem, communitySystem, entityID));
+    }
+
+    return communityEntries;
+}
+
+App::WorldCommunityEntryData App::WorldInspector::ResolveCommunityEntryData(Red::IEntityStubSystem* aEntityStubSystem,
+                                                                            Red::ICommunitySystem* aCommunitySystem,
+                                                                            uint64_t aEntityID)
+{
+    WorldCommunityEntryData communityEntryData{};
+
+    auto entityStub = aEntityStubSystem->FindStub(aEntityID);
+
+    if (!entityStub)
+        return communityEntryData;
+
+    auto communityID = entityStub->stubState->spawnerId.entityId;
+    auto communityEntryName = entityStub->stubState->ownerCommunityEntryName;
+
+    Red::WeakPtr<Red::Community> community;
+    Raw::CommunitySystem::GetCommunity(aCommunitySystem, community, communityID);
+
+    if (!community)
+    {
         return communityEntryData;
+    }
+
+    auto communitySectorData = m_nodeRegistry->GetCommunityStaticData(communityID);
+
+    if (communitySectorData.communityID)
+    {
+        communityEntryData.sectorHash = communitySectorData.sectorHash;
+        communityEntryData.registryIndex = communitySectorData.registryIndex;
+        communityEntryData.communityIndex = communitySectorData.communityIndex;
+        communityEntryData.communityCount = communitySectorData.communityCount;
+        communityEntryData.communityID = communitySectorData.communityID;
+    }
+    else
+    {
+        communityEntryData.communityID = communityID;
+    }
+
+    const auto& communityEntries = community.instance->entries;
+    const auto communityEntryCount = communityEntries.size;
+
+    // The index is built from the registry data, which is expected to follow the order of the runtime entries,
+    // the entry is still verified and the index is corrected when the runtime order is different
+    const auto communityEntryStaticData =
+        m_nodeRegistry->GetCommunityEntryStaticData(communityID.hash, communityEntryName);
+    auto communityEntryIndex = communityEntryStaticData.entryIndex;
+
+    if (communityEntryIndex < 0 || communityEntryIndex >= static_cast<int32_t>(communityEntryCount) ||
+        communityEntries[communityEntryIndex]->name != communityEntryName)
+    {
+        communityEntryIndex = -1;
+
+        for (auto entryIndex = 0; entryIndex < static_cast<int32_t>(communityEntryCount); ++entryIndex)
+        {
+            if (communityEntries[entryIndex]->name == communityEntryName)
+            {
+                communityEntryIndex = entryIndex;
+                break;
+            }
+        }
+
+        if (communityEntryIndex < 0)
+            return communityEntryData;
+
+        m_nodeRegistry->UpdateCommunityEntryStaticData(
+            {communityID.hash, communityEntryName, communityEntryIndex, communityEntryCount, {}});
+    }
+
+    const auto& communityEntry = communityEntries[communityEntryIndex];
+
+    communityEntryData.entryName = communityEntryName;
+    communityEntryData.entryIndex = communityEntryIndex;
+    communityEntryData.entryCount = communityEntryCount;
+
+    if (communityEntry->unk2C >= 0 && communityEntry->unk2C < communityEntry->phases.size)
+    {
+        communityEntryData.entryPhase = communityEntry->phases[communityEntry->unk2C];
+    }
+
+    return communityEntryData;
+}
+
+App::WorldStreamingRequestStats App::WorldInspector::GetStreamingRequestStats()
+{
+    std::shared_lock _(m_postponedRequestsLock);
+
+    auto stats = m_streamingRequestStats;
+    const auto now = std::chrono::steady_clock::now();
+
+    for (const auto& [hash, postponedRequest] : m_postponedRequests)
+    {
+        switch (postponedRequest.state)
+        {
+        case WorldNodeStreamingState::WaitingForAttach:
+            ++stats.waitingForAttach;
+            break;
+        case WorldNodeStreamingState::WaitingForResource:
+            ++stats.waitingForResource;
+            break;
+        default:
+            ++stats.waitingForBounds;
+            break;
+        }
+
+        const std::chrono::duration<float> waitTime = now - postponedRequest.postponedAt;
+        stats.oldestWaitTime = std::max(stats.oldestWaitTime, waitTime.count());
+    }
+
+    stats.waiting = static_cast<uint32_t>(m_postponedRequests.size());
+
+    return stats;
+}
+
+Red::DynArray<App::MemoryUsage> App::WorldInspector::GetMemoryUsage()
+{
+    Core::Vector<MemoryUsage> records;
+
+    {
+        std::shared_lock _(m_streamedNodesLock);
+        records.push_back(GetStreamedNodesUsage());
+        records.push_back(m_streamedNodesBounds.GetMemoryUsage());
+    }
+
+    {
+        const auto snapshot = m_frustumSnapshot.load();
+
+        std::shared_lock _(m_frustumNodesLock);
+        records.push_back({"WorldInspector.FrustumNodes", snapshot->frustumNodes.size,
+                           MemoryAccounting::GetBytes(snapshot->frustumNodes) +
+                               MemoryAccounting::GetBytes(snapshot->targetedNodes) +
+                               MemoryAccounting::GetBytes(m_frustumNodeStates)});
+    }
+
+    {
+        std::unique_lock _(m_scannerLock);
+        records.push_back({"WorldInspector.ScannedNodes", m_scannedNodes.size(),
+                           MemoryAccounting::GetBytes(m_scannedNodes) + MemoryAccounting::GetBytes(m_scannedRecords)});
+    }
+
+    {
+        std::shared_lock _(m_postponedRequestsLock);
+        records.push_back({"WorldInspector.PostponedRequests", m_postponedRequests.size(),
+                           MemoryAccounting::GetBytes(m_postponedRequests)});
+    }
+
+    m_nodeRegistry->CollectMemoryUsage(records);
+    Core::Resolve<ObjectRegistry>()->CollectMemoryUsage(records);
+    Core::Resolve<ResourcePathRegistry>()->CollectMemoryUsage(records);
+
+    Red::DynArray<MemoryUsage> result;
+    result.Reserve(static_cast<uint32_t>(records.size()));
+
+    for (auto& record : records)
+    {
+        result.PushBack(record);
+    }
+
+    return result;
+}
+
+bool App::WorldInspector::SetMemoryBudget(Red::CName aName, uint64_t aBytes)
+{
+    if (aName == "WorldInspector.StreamedNodes")
+    {
+        std::unique_lock _(m_streamedNodesLock);
+        m_streamedNodesBudget = aBytes;
+        m_streamedNodesCompactSize = 0;
+        return true;
+    }
+
+    if (aName == "WorldInspector.BoundsCache")
+    {
+        std::unique_lock _(m_streamedNodesLock);
+        m_streamedNodesBounds.SetMemoryBudget(aBytes);
+        return true;
+    }
+
+    if (aName == "WorldNodeRegistry.NodeInstances")
+    {
+        m_nodeRegistry->SetNodeInstancesBudget(aBytes);
+        return true;
+    }
+
+    if (aName == "ObjectRegistry.Objects")
+    {
+        Core::Resolve<ObjectRegistry>()->SetObjectsBudget(aBytes);
+        return true;
+    }
+
+    return false;
+}
+
+void App::WorldInspector::LogMemoryUsage()
+{
+    uint64_t totalBytes = 0;
+
+    for (const auto& record : GetMemoryUsage())
+    {
+        if (record.budget)
+        {
+            Core::Log::Info("{}: {} entries, {} bytes, budget {} bytes.", record.name.ToString(), record.entries,
+                            record.bytes, record.budget);
+        }
+        else
+        {
+            Core::Log::Info("{}: {} entries, {} bytes.", record.name.ToString(), record.entries, record.bytes);
+        }
+
+        totalBytes += record.bytes;
+    }
+
+    Core::Log::Info("Total: {} bytes.", totalBytes);
+}
+
+App::WorldNodeRuntimeSceneData App::WorldInspector::FindStreamedNode(uint64_t aNodeID)
+{
+    auto nodeInstance = m_nodeRegistry->FindStreamedNodeInstance(aNodeID);
+
+    if (!nodeInstance)
+        return {};
+
+    const auto& [setup, nodeInstanceWeak, nodeDefinitionWeak] = m_nodeRegistry->GetNodeRuntimeData(nodeInstance);
+
+    if (!nodeInstanceWeak)
+        return {};
+
+    return {nodeInstanceWeak, nodeDefinitionWeak, {}, setup->transform.position, setup->transform.orientation};
+}
+
+Red::DynArray<App::WorldNodeRuntimeSceneData> App::WorldInspector::GetStreamedNodesInFrustum()
+{
+    return m_frustumSnapshot.load()->frustumNodes;
+}
+
+Red::DynArray<App::WorldNodeRuntimeSceneData> App::WorldInspector::GetStreamedNodesInCrosshair()
+{
+    return m_frustumSnapshot.load()->targetedNodes;
+}
+
+uint32_t App::WorldInspector::GetFrustumGeneration()
+{
+    std::shared_lock _(m_frustumNodesLock);
+    return m_frustumGeneration;
+}
+
+App::WorldFrustumChanges App::WorldInspector::GetFrustumChanges(uint32_t aSinceGeneration)
+{
+    std::shared_lock _(m_frustumNodesLock);
+
+    WorldFrustumChanges changes{};
+    changes.generation = m_frustumGeneration;
+    changes.reset = aSinceGeneration < m_frustumHistoryStart || aSinceGeneration > m_frustumGeneration;
+
+    if (changes.reset)
+    {
+        changes.added.Reserve(static_cast<uint32_t>(m_frustumNodeStates.size()));
+
+        for (const auto& [hash, state] : m_frustumNodeStates)
+        {
+            changes.added.PushBack(state.node);
+        }
+
+        return changes;
+    }
+
+    for (const auto& [hash, state] : m_frustumNodeStates)
+    {
+        if (state.addedGeneration > aSinceGeneration)
+        {
+            changes.added.PushBack(state.node);
+        }
+        else if (state.movedGeneration > aSinceGeneration)
+        {
+            changes.moved.PushBack(state.node);
+        }
+    }
+
+    for (auto removal = m_frustumRemovals.rbegin(); removal != m_frustumRemovals.rend(); ++removal)
+    {
+        if (removal->first <= aSinceGeneration)
+            break;
+
+        changes.removed.PushBack(removal->second);
+    }
+
+    return changes;
+}
+
+void App::WorldInspector::RegisterNodeGroup(Red::CName aNodeType, Red::CName aNodeGroup)
+{
+    {
+        std::unique_lock _(m_nodeClassesLock);
+        m_nodeGroups.insert_or_assign(aNodeType, aNodeGroup);
+        m_nodeClasses.clear();
+    }
+
+    // Groups are resolved together with the other fields, so the records have to be resolved again
+    {
+        std::unique_lock _(m_scannerLock);
+        m_scannedNodes.clear();
+        m_scannedRecords.clear();
+    }
+}
+
+uint32_t App::WorldInspector::ScanFrustumNodes()
+{
+#ifndef NDEBUG
+    const auto scanStart = std::chrono::steady_clock::now();
+#endif
+
+    const auto snapshot = m_frustumSnapshot.load();
+    Core::Vector<WorldNodeRuntimeSceneData> scannedNodes(snapshot->frustumNodes.begin(), snapshot->frustumNodes.end());
+
+    std::unique_lock _(m_scannerLock);
+
+    Core::Map<uint64_t, uint32_t> previousRecords;
+    previousRecords.reserve(m_scannedNodes.size());
+
+    for (uint32_t nodeIndex = 0; nodeIndex < m_scannedNodes.size(); ++nodeIndex)
+    {
+        previousRecords.emplace(m_scannedNodes[nodeIndex].hash, nodeIndex);
+    }
+
+    Core::Vector<WorldNodeQueryRecord> scannedRecords;
+    scannedRecords.reserve(scannedNodes.size());
+
+    uint32_t resolvedRecords = 0;
+
+    for (const auto& node : scannedNodes)
+    {
+        const auto& previousIt = previousRecords.find(node.hash);
+
+        // The address of a destroyed node can be reused by another one, so the handles must match as well
+        if (previousIt != previousRecords.end() && IsSameSceneNode(m_scannedNodes[previousIt->second], node))
+        {
+            scannedRecords.emplace_back(std::move(m_scannedRecords[previousIt->second]));
+        }
+        else
+        {
+            scannedRecords.emplace_back(ResolveQueryRecord(node));
+            ++resolvedRecords;
+        }
+    }
+
+    m_scannedNodes = std::move(scannedNodes);
+    m_scannedRecords = std::move(scannedRecords);
+
+#ifndef NDEBUG
+    const std::chrono::duration<double, std::milli> scanDuration = std::chrono::steady_clock::now() - scanStart;
+    Core::Log::Debug("ScanFrustumNodes nodes={} resolved={} time={:.3f}ms", m_scannedNodes.size(), resolvedRecords,
+                     scanDuration.count());
+#endif
+
+    return static_cast<uint32_t>(m_scannedNodes.size());
+}
+
+bool App::WorldInspector::IsSameSceneNode(const WorldNodeRuntimeSceneData& aNode,
+                                          const WorldNodeRuntimeSceneData& aOtherNode)
+{
+    return aNode.hash == aOtherNode.hash && aNode.nodeInstance.instance == aOtherNode.nodeInstance.instance &&
+           aNode.nodeInstance.refCount == aOtherNode.nodeInstance.refCount &&
+           aNode.nodeDefinition.instance == aOtherNode.nodeDefinition.instance &&
+           aNode.nodeDefinition.refCount == aOtherNode.nodeDefinition.refCount;
+}
+
+App::WorldNodeQueryResult App::WorldInspector::QueryScannedNodes(float aDistance, Red::CName aGroup,
+                                                                 const Red::CString& aTerm, uint32_t aOffset,
+                                                                 uint32_t aLimit)
+{
+#ifndef NDEBUG
+    const auto queryStart = std::chrono::steady_clock::now();
+#endif
+
+    const WorldNodeQuery query(aDistance, aGroup, {aTerm.c_str(), aTerm.Length()});
+
+    std::unique_lock _(m_scannerLock);
+
+    WorldNodeQueryResult result{};
+    result.total = static_cast<uint32_t>(m_scannedNodes.size());
+
+    const auto rankLimit = static_cast<uint32_t>(std::min<uint64_t>(static_cast<uint64_t>(aOffset) + aLimit,
+                                                                     result.total));
+
+    Core::Vector<WorldNodeTopK<uint32_t>::Entry> rankedNodes;
+
+    // The first pages are ranked while matching, only the nearest matches are kept
+    if (rankLimit <= m_scannerPageSize)
+    {
+        WorldNodeTopK<uint32_t> nearestNodes(rankLimit);
+
+        for (uint32_t nodeIndex = 0; nodeIndex < m_scannedNodes.size(); ++nodeIndex)
+        {
+            const auto& node = m_scannedNodes[nodeIndex];
+
+            if (!query.Matches(m_scannedRecords[nodeIndex], node.distance))
+                continue;
+
+            nearestNodes.Push(node.distance, nodeIndex);
+            ++result.matched;
+        }
+
+        nearestNodes.Take(rankedNodes);
+    }
+    // Pages beyond that are ranked on demand, all matches are partitioned around the page and only the page is sorted
+    else
+    {
+        for (uint32_t nodeIndex = 0; nodeIndex < m_scannedNodes.size(); ++nodeIndex)
+        {
+            const auto& node = m_scannedNodes[nodeIndex];
+
+            if (!query.Matches(m_scannedRecords[nodeIndex], node.distance))
+                continue;
+
+            rankedNodes.emplace_back(node.distance, nodeIndex);
+        }
+
+        result.matched = static_cast<uint32_t>(rankedNodes.size());
+
+        const auto pageBegin = rankedNodes.begin() + std::min(aOffset, result.matched);
+        const auto pageEnd = rankedNodes.begin() + std::min(rankLimit, result.matched);
+
+        std::nth_element(rankedNodes.begin(), pageBegin, rankedNodes.end());
+        std::partial_sort(pageBegin, pageEnd, rankedNodes.end());
+    }
+
+    for (auto rank = aOffset; rank < std::min(rankLimit, static_cast<uint32_t>(rankedNodes.size())); ++rank)
+    {
+        result.nodes.PushBack(m_scannedNodes[rankedNodes[rank].second]);
+    }
+
+#ifndef NDEBUG
+    const std::chrono::duration<double, std::milli> queryDuration = std::chrono::steady_clock::now() - queryStart;
+    Core::Log::Debug("QueryScannedNodes nodes={} matched={} time={:.3f}ms", result.total, result.matched,
+                     queryDuration.count());
+#endif
+
+    return result;
+}
+
+bool App::WorldInspector::StartTrace(const Red::CString& aFileName)
+{
+    return WorldTraceRecorder::Start(Env::TraceDir() / aFileName.c_str());
+}
+
+void App::WorldInspector::StopTrace()
+{
+    WorldTraceRecorder::Stop();
+}
+
+bool App::WorldInspector::IsTraceRecording()
+{
+    return WorldTraceRecorder::IsRecording();
+}
+
+void App::WorldInspector::StartStreamingProfiler()
+{
+    WorldStreamingProfiler::Start();
+}
+
+void App::WorldInspector::StopStreamingProfiler()
+{
+    WorldStreamingProfiler::Stop();
+}
+
+void App::WorldInspector::ResetStreamingProfiler()
+{
+    WorldStreamingProfiler::Reset();
+}
+
+bool App::WorldInspector::IsStreamingProfiling()
+{
+    return WorldStreamingProfiler::IsProfiling();
+}
+
+Red::DynArray<App::WorldStreamingLatencyStats> App::WorldInspector::GetStreamingLatencyStats()
+{
+    const auto stats = WorldStreamingProfiler::GetStats();
+
+    Red::DynArray<WorldStreamingLatencyStats> result;
+    result.Reserve(static_cast<uint32_t>(stats.size()));
+
+    for (const auto& entry : stats)
+    {
+        result.PushBack(entry);
+    }
+
+    return result;
+}
+
+bool App::WorldInspector::DumpStreamingLatency(const Red::CString& aFileName)
+{
+    return WorldStreamingProfiler::Dump(Env::TraceDir() / aFileName.c_str());
+}
+
+App::WorldNodeQueryRecord App::WorldInspector::ResolveQueryRecord(const WorldNodeRuntimeSceneData& aNode)
+{
+    const auto targetData = ResolveTarget(aNode.nodeInstance, aNode.nodeDefinition);
+
+    WorldNodeQueryRecord record;
+    record.nodeGroup = targetData.nodeGroup;
+
+    if (targetData.sectorHash)
+    {
+        record.SetExactField(std::to_string(targetData.instanceIndex));
+    }
+
+    for (const auto* field : {&targetData.sectorPath, &targetData.nodeRef, &targetData.parentRef,
+                              &targetData.meshPath, &targetData.materialPath, &targetData.effectPath,
+                              &targetData.templatePath, &targetData.recordID})
+    {
+        record.AddPartialField({field->c_str(), field->Length()});
+    }
+
+    if (targetData.nodeType)
+    {
+        record.AddPartialField(targetData.nodeType.ToString());
+    }
+
+    for (const auto& notifier : targetData.triggerNotifiers)
+    {
+        record.AddPartialField(notifier.ToString());
+    }
+
+    return record;
+}
+
+App::WorldNodeTargetData App::WorldInspector::ResolveTarget(
+    const Red::WeakHandle<Red::worldINodeInstance>& aNodeInstance,
+    const Red::WeakHandle<Red::worldNode>& aNodeDefinition)
+{
+    const auto resourcePaths = Core::Resolve<ResourcePathRegistry>();
+
+    WorldNodeTargetData targetData{};
+
+    if (aNodeInstance)
+    {
+        const auto sectorData = m_nodeRegistry->GetNodeStaticData(aNodeInstance);
+
+        if (sectorData.sectorHash)
+        {
+            targetData.sectorHash = sectorData.sectorHash;
+            targetData.sectorPath = resourcePaths->ResolvePathOrHash(sectorData.sectorHash).c_str();
+            targetData.instanceIndex = sectorData.instanceIndex;
+            targetData.instanceCount = sectorData.instanceCount;
+            targetData.nodeIndex = sectorData.nodeIndex;
+            targetData.nodeCount = sectorData.nodeCount;
+            targetData.nodeType = sectorData.nodeType;
+            targetData.nodeID = sectorData.nodeID;
+            targetData.parentID = sectorData.parentID;
+            targetData.debugName = sectorData.debugName;
+        }
+    }
+
+    if (auto nodeDefinition = aNodeDefinition.Lock())
+    {
+        auto* nodeInstance = nodeDefinition.instance;
+        const auto classData = GetNodeClassData(nodeDefinition->GetType());
+
+        targetData.nodeType = classData.nodeType;
+        targetData.nodeGroup = classData.nodeGroup;
+        targetData.isAreaNode = classData.isAreaNode;
+        targetData.isOccluderNode = classData.isOccluderNode;
+        targetData.isProxyMeshNode = classData.isProxyMeshNode;
+        targetData.isCommunityNode = classData.isCommunityNode;
+        targetData.isSpawnerNode = classData.isSpawnerNode;
+        targetData.isCollisionNode = classData.isCollisionNode;
+        targetData.isLightNode = classData.isLightNode;
+        targetData.isInstancedOccluderNode = classData.isInstancedOccluderNode;
+        targetData.isDeviceNode = classData.isDeviceNode;
+        targetData.isAISpotNode = classData.isAISpotNode;
+
+        targetData.meshPath = ResolveResourcePath(classData.meshProp, nodeInstance);
+        targetData.materialPath = ResolveResourcePath(classData.materialProp, nodeInstance);
+        targetData.effectPath = ResolveResourcePath(classData.effectProp, nodeInstance);
+        targetData.templatePath = ResolveResourcePath(classData.templateProp, nodeInstance);
+
+        if (classData.meshAppearanceProp)
+        {
+            targetData.meshAppearance = *classData.meshAppearanceProp->GetValuePtr<Red::CName>(nodeInstance);
+        }
+
+        if (classData.appearanceNameProp)
+        {
+            targetData.appearanceName = *classData.appearanceNameProp->GetValuePtr<Red::CName>(nodeInstance);
+        }
+
+        if (classData.recordProp)
+        {
+            const auto recordID = *classData.recordProp->GetValuePtr<Red::TweakDBID>(nodeInstance);
+            Red::CallStatic("TDBID", "ToStringDEBUG", targetData.recordID, recordID);
+        }
+
+        if (classData.notifiersProp)
+        {
+            for (const auto& notifier :
+                 *classData.notifiersProp->GetValuePtr<Red::DynArray<Red::Handle<Red::ISerializable>>>(nodeInstance))
+            {
+                if (notifier)
+                {
+                    targetData.triggerNotifiers.PushBack(notifier->GetType()->GetName());
+                }
+            }
+        }
+    }
+    else if (targetData.nodeType)
+    {
+        std::shared_lock _(m_nodeClassesLock);
+
+        const auto& groupIt = m_nodeGroups.find(targetData.nodeType);
+
+        if (groupIt != m_nodeGroups.end())
+        {
+            targetData.nodeGroup = groupIt->second;
+        }
+    }
+
+    if (targetData.nodeID)
+    {
+        targetData.nodeRef = ResolveNodeRefFromNodeHash(targetData.nodeID);
+    }
+
+    if (targetData.parentID)
+    {
+        targetData.parentRef = ResolveNodeRefFromNodeHash(targetData.parentID);
+    }
+
+    return targetData;
+}
+
+Red::DynArray<App::WorldNodeTargetData> App::WorldInspector::ResolveTargets(
+    const Red::DynArray<WorldNodeRuntimeSceneData>& aNodes)
+{
+    Red::DynArray<WorldNodeTargetData> targets;
+    targets.Reserve(aNodes.size);
+
+    for (const auto& node : aNodes)
+    {
+        auto targetData = ResolveTarget(node.nodeInstance, node.nodeDefinition);
+        targetData.hash = node.hash;
+
+        targets.PushBack(std::move(targetData));
+    }
+
+    return targets;
+}
+
+App::WorldInspector::NodeClassData App::WorldInspector::GetNodeClassData(Red::CClass* aClass)
+{
+    {
+        std::shared_lock _(m_nodeClassesLock);
+
+        const auto& classIt = m_nodeClasses.find(aClass);
+
+        if (classIt != m_nodeClasses.end())
+            return classIt->second;
+    }
 
-    auto communityID = entityStub->stubState->spawnerId.entityId;
-    auto communityEntryName = entityStub->stubState->ownerCommunityEntryName;
+    static const auto s_areaNodeType = Red::GetClass<Red::worldAreaShapeNode>();
+    static const auto s_occluderNodeType = Red::GetClass<Red::worldStaticOccluderMeshNode>();
+    static const auto s_proxyMeshNodeType = Red::GetClass<Red::worldPrefabProxyMeshNode>();
+    static const auto s_communityNodeType = Red::GetClass<Red::worldCompiledCommunityAreaNode>();
+    static const auto s_spawnerNodeType = Red::GetType("worldPopulationSpawnerNode");
+    static const auto s_collisionNodeType = Red::GetType("worldCollisionNode");
+    static const auto s_lightNodeType = Red::GetType("worldStaticLightNode");
+    static const auto s_instancedOccluderNodeType = Red::GetType("worldInstancedOccluderNode");
+    static const auto s_deviceNodeType = Red::GetType("worldDeviceNode");
+    static const auto s_spotNodeType = Red::GetType("worldAISpotNode");
+
+    const auto findProperty = [aClass](Red::CName aName, Red::CName aTypeName) -> const Red::CProperty*
+    {
+        const auto* prop = aClass->GetProperty(aName);
+        return (prop && prop->type->GetName() == aTypeName) ? prop : nullptr;
+    };
 
-    auto communitySystem = Red::GetGameSystem<Red::ICommunitySystem>();
+    const auto findResourceProperty = [aClass](std::initializer_list<Red::CName> aNames) -> const Red::CProperty*
+    {
+        for (const auto& name : aNames)
+        {
+            const auto* prop = aClass->GetProperty(name);
 
-    Red::WeakPtr<Red::Community> community;
-    Raw::CommunitySystem::GetCommunity(communitySystem, community, communityID);
+            if (prop && (prop->type->GetType() == Red::ERTTIType::ResourceReference ||
+                         prop->type->GetType() == Red::ERTTIType::ResourceAsyncReference))
+                return prop;
+        }
 
-    if (!community)
+        return nullptr;
+    };
+
+    NodeClassData classData{};
+    classData.nodeType = aClass->GetName();
+    classData.meshProp = findResourceProperty({"mesh", "meshRef"});
+    classData.materialProp = findResourceProperty({"material"});
+    classData.effectProp = findResourceProperty({"effect"});
+    classData.templateProp = findResourceProperty({"entityTemplate"});
+    classData.meshAppearanceProp = findProperty("meshAppearance", "CName");
+    classData.appearanceNameProp = findProperty("appearanceName", "CName");
+    classData.recordProp = findProperty("objectRecordId", "TweakDBID");
+    classData.isAreaNode = aClass->IsA(s_areaNodeType);
+    classData.isOccluderNode = aClass->IsA(s_occluderNodeType);
+    classData.isProxyMeshNode = aClass->IsA(s_proxyMeshNodeType);
+    classData.isCommunityNode = aClass->IsA(s_communityNodeType);
+    classData.isSpawnerNode = aClass->IsA(s_spawnerNodeType);
+    classData.isCollisionNode = aClass->IsA(s_collisionNodeType);
+    classData.isLightNode = aClass->IsA(s_lightNodeType);
+    classData.isInstancedOccluderNode = aClass->IsA(s_instancedOccluderNodeType);
+    classData.isDeviceNode = aClass->IsA(s_deviceNodeType);
+    classData.isAISpotNode = aClass->IsA(s_spotNodeType);
+
+    // The first matching group decides where the bounds of a streamed node come from
+    if (aClass->IsA(Red::GetClass<Red::worldMeshNode>()))
     {
-        return communityEntryData;
+        classData.boundsSource = NodeBoundsSource::Mesh;
+        classData.isStaticMesh = !aClass->IsA(Red::GetClass<Red::worldTerrainProxyMeshNode>()) &&
+                                 !aClass->IsA(Red::GetClass<Red::worldRoadProxyMeshNode>());
+    }
+    else if (aClass->IsA(Red::GetClass<Red::worldStaticDecalNode>()) ||
+             aClass->IsA(Red::GetClass<Red::worldBendedMeshNode>()) ||
+             aClass->IsA(Red::GetClass<Red::worldFoliageNode>()) ||
+             aClass->IsA(Red::GetClass<Red::worldEntityNode>()) ||
+             aClass->IsA(Red::GetClass<Red::worldAreaShapeNode>()) ||
+             aClass->IsA(Red::GetClass<Red::worldGeometryShapeNode>()) ||
+             aClass->IsA(Red::GetClass<Red::worldStaticOccluderMeshNode>()))
+    {
+        classData.boundsSource = NodeBoundsSource::Definition;
+        classData.isStaticMesh = !aClass->IsA(Red::GetClass<Red::worldAreaShapeNode>()) &&
+                                 !aClass->IsA(Red::GetClass<Red::worldGeometryShapeNode>()) &&
+                                 !aClass->IsA(Red::GetClass<Red::worldStaticOccluderMeshNode>());
+    }
+    else if (aClass->IsA(Red::GetClass<Red::worldInstancedMeshNode>()))
+    {
+        classData.boundsSource = NodeBoundsSource::Instances;
+        classData.isStaticMesh = true;
     }
 
-    auto communitySectorData = m_nodeRegistry->GetCommunityStaticData(communityID);
-
-    if (communitySectorData.communityID)
+    if (aClass->IsA(Red::GetClass<Red::worldEntityNodeInstance>()))
     {
-        communityEntryData.sectorHash = communitySectorData.sectorHash;
-        communityEntryData.registryIndex = communitySectorData.registryIndex;
-        communityEntryData.communityIndex = communitySectorData.communityIndex;
-        communityEntryData.communityCount = communitySectorData.communityCount;
-        communityEntryData.communityID = communitySectorData.communityID;
+        classData.isEntityNode = true;
     }
-    else
+    // else if (aClass->IsA(Red::GetClass<Red::worldInstancedDestructibleMeshNodeInstance>()))
+    // {
+    //     classData.collectRenderProxies = &CollectRenderProxies<Raw::WorldInstancedDestructibleMeshNodeInstance::RenderProxy>;
+    // }
+    else if (aClass->IsA(Red::GetClass<Red::worldMeshNodeInstance>()))
     {
-        communityEntryData.communityID = communityID;
+        classData.collectRenderProxies = &CollectRenderProxies<Raw::WorldMeshNodeInstance::RenderProxy>;
+    }
+    else if (aClass->IsA(Red::GetClass<Red::worldStaticDecalNodeInstance>()))
+    {
+        classData.collectRenderProxies = &CollectRenderProxies<Raw::WorldStaticDecalNodeInstance::RenderProxy>;
+    }
+    else if (aClass->IsA(Red::GetClass<Red::worldBendedMeshNodeInstance>()))
+    {
+        classData.collectRenderProxies = &CollectRenderProxies<Raw::WorldBendedMeshNodeInstance::RenderProxy>;
+    }
+    else if (aClass->IsA(Red::GetClass<Red::worldPhysicalDestructionNodeInstance>()))
+    {
+        classData.collectRenderProxies = &CollectRenderProxies<Raw::WorldPhysicalDestructionNodeInstance::RenderProxy>;
+    }
+    else if (aClass->IsA(Red::GetClass<Red::worldInstancedMeshNodeInstance>()))
+    {
+        classData.collectRenderProxies = &CollectRenderProxies<Raw::WorldInstancedMeshNodeInstance::RenderProxies>;
+    }
+    else if (aClass->IsA(Red::GetClass<Red::worldFoliageNodeInstance>()))
+    {
+        classData.collectRenderProxies = &CollectRenderProxies<Raw::WorldFoliageNodeInstance::RenderProxies>;
+    }
+    else if (aClass->IsA(Red::GetClass<Red::worldTerrainMeshNodeInstance>()))
+    {
+        classData.collectRenderProxies = &CollectRenderProxies<Raw::WorldTerrainMeshNodeInstance::RenderProxies>;
+    }
+    else if (aClass->IsA(Red::GetClass<Red::worldStaticLightNodeInstance>()))
+    {
+        classData.collectRenderProxies = &CollectRenderProxies<Raw::WorldStaticLightNodeInstance::RenderProxy>;
     }
 
-    const auto communityEntryCount = community.instance->entries.size;
-    for (auto communityEntryIndex = 0; communityEntryIndex < communityEntryCount; ++communityEntryIndex)
+    // Lights can be hidden, but don't support the highlight
+    if (!aClass->IsA(Red::GetClass<Red::worldStaticLightNodeInstance>()))
     {
-        const auto& communityEntry = community.instance->entries[communityEntryIndex];
-        if (communityEntry->name == communityEntryName)
+        classData.collectHighlightProxies = classData.collectRenderProxies;
+    }
+
+    if (const auto* prop = aClass->GetProperty("notifiers"))
+    {
+        if (prop->type->GetType() == Red::ERTTIType::Array &&
+            reinterpret_cast<const Red::CRTTIArrayType*>(prop->type)->GetInnerType()->GetType() ==
+                Red::ERTTIType::Handle)
         {
-            communityEntryData.entryName = communityEntryName;
-            communityEntryData.entryIndex = communityEntryIndex;
-            communityEntryData.entryCount = communityEntryCount;
+            classData.notifiersProp = prop;
+        }
+    }
 
-            if (communityEntry->unk2C >= 0 && communityEntry->unk2C < communityEntry->phases.size)
-            {
-                communityEntryData.entryPhase = communityEntry->phases[communityEntry->unk2C];
-            }
+    std::unique_lock _(m_nodeClassesLock);
 
-            break;
-        }
+    const auto& groupIt = m_nodeGroups.find(classData.nodeType);
+
+    if (groupIt != m_nodeGroups.end())
+    {
+        classData.nodeGroup = groupIt->second;
     }
 
-    return communityEntryData;
+    m_nodeClasses.insert_or_assign(aClass, classData);
+
+    return classData;
 }
 
-App::WorldNodeRuntimeSceneData App::WorldInspector::FindStreamedNode(uint64_t aNodeID)
+Red::CString App::WorldInspector::ResolveResourcePath(const Red::CProperty* aProp, void* aInstance)
 {
-    auto nodeInstance = m_nodeRegistry->FindStreamedNodeInstance(aNodeID);
-
-    if (!nodeInstance)
+    if (!aProp)
         return {};
 
-    const auto& [setup, nodeInstanceWeak, nodeDefinitionWeak] = m_nodeRegistry->GetNodeRuntimeData(nodeInstance);
-
-    if (!nodeInstanceWeak)
-        return {};
+    Red::ResourcePath resourcePath;
 
-    return {nodeInstanceWeak, nodeDefinitionWeak, {}, setup->transform.position, setup->transform.orientation};
-}
+    if (aProp->type->GetType() == Red::ERTTIType::ResourceReference)
+    {
+        resourcePath = aProp->GetValuePtr<Red::ResourceReference<>>(aInstance)->path;
+    }
+    else
+    {
+        resourcePath = aProp->GetValuePtr<Red::ResourceAsyncReference<>>(aInstance)->path;
+    }
 
-Red::DynArray<App::WorldNodeRuntimeSceneData> App::WorldInspector::GetStreamedNodesInFrustum()
-{
-    std::shared_lock _(m_frustumNodesLock);
-    return m_frustumNodes;
-}
+    if (!resourcePath)
+        return {};
 
-Red::DynArray<App::WorldNodeRuntimeSceneData> App::WorldInspector::GetStreamedNodesInCrosshair()
-{
-    std::shared_lock _(m_frustumNodesLock);
-    return m_targetedNodes;
+    return Core::Resolve<ResourcePathRegistry>()->ResolvePathOrHash(resourcePath);
 }
 
 App::WorldNodeRuntimeGeometryData App::WorldInspector::GetStreamedNodeGeometry(
@@ -561,6 +1898,36 @@ void App::WorldInspector::SetTargetingDistance(float aDistance)
     m_targetingDistance = std::clamp(aDistance, FrustumMinDistance, m_frustumDistance);
 }
 
+uint32_t App::WorldInspector::GetFrustumChunkSize() const
+{
+    return m_frustumChunkSize;
+}
+
+void App::WorldInspector::SetFrustumChunkSize(uint32_t aSize)
+{
+    m_frustumChunkSize = std::clamp(aSize, FrustumMinChunkSize, FrustumMaxChunkSize);
+}
+
+uint32_t App::WorldInspector::GetCrosshairLimit() const
+{
+    return m_crosshairLimit;
+}
+
+void App::WorldInspector::SetCrosshairLimit(uint32_t aLimit)
+{
+    m_crosshairLimit = std::clamp(aLimit, 1u, CrosshairMaxLimit);
+}
+
+uint32_t App::WorldInspector::GetScannerPageSize() const
+{
+    return m_scannerPageSize;
+}
+
+void App::WorldInspector::SetScannerPageSize(uint32_t aSize)
+{
+    m_scannerPageSize = std::clamp(aSize, ScannerMinPageSize, ScannerMaxPageSize);
+}
+
 bool App::WorldInspector::SetNodeVisibility(const Red::Handle<Red::worldINodeInstance>& aNodeInstance, bool aVisible)
 {
     return UpdateNodeVisibility(aNodeInstance, false, true);
@@ -574,7 +1941,12 @@ bool App::WorldInspector::ToggleNodeVisibility(const Red::Handle<Red::worldINode
 bool App::WorldInspector::UpdateNodeVisibility(const Red::Handle<Red::worldINodeInstance>& aNodeInstance,
                                                  bool aToggle, bool aVisible)
 {
-    if (Red::IsInstanceOf<Red::worldEntityNodeInstance>(aNodeInstance))
+    if (!aNodeInstance)
+        return false;
+
+    const auto classData = GetNodeClassData(aNodeInstance->GetType());
+
+    if (classData.isEntityNode)
     {
         if (aToggle)
             aVisible = !Raw::WorldNodeInstance::IsVisible(aNodeInstance);
@@ -583,86 +1955,239 @@ bool App::WorldInspector::UpdateNodeVisibility(const Red::Handle<Red::worldINode
         return true;
     }
 
-    // if (Red::IsInstanceOf<Red::worldInstancedDestructibleMeshNodeInstance>(aNodeInstance))
-    // {
-    //     return SetRenderProxyVisibility<Raw::WorldInstancedDestructibleMeshNodeInstance::RenderProxy>(aNodeInstance, aToggle, aVisible);
-    // }
+    if (!classData.collectRenderProxies)
+        return false;
 
-    if (Red::IsInstanceOf<Red::worldMeshNodeInstance>(aNodeInstance))
-    {
-        return SetRenderProxyVisibility<Raw::WorldMeshNodeInstance::RenderProxy>(aNodeInstance, aToggle, aVisible);
-    }
+    Core::Vector<Red::RenderProxy*> renderProxies;
+    classData.collectRenderProxies(aNodeInstance.instance, renderProxies);
 
-    if (Red::IsInstanceOf<Red::worldStaticDecalNodeInstance>(aNodeInstance))
-    {
-        return SetRenderProxyVisibility<Raw::WorldStaticDecalNodeInstance::RenderProxy>(aNodeInstance, aToggle, aVisible);
-    }
+    if (renderProxies.empty())
+        return false;
 
-    if (Red::IsInstanceOf<Red::worldBendedMeshNodeInstance>(aNodeInstance))
+    for (auto* renderProxy : renderProxies)
     {
-        return SetRenderProxyVisibility<Raw::WorldBendedMeshNodeInstance::RenderProxy>(aNodeInstance, aToggle, aVisible);
+        if (aToggle)
+            aVisible = !Raw::RenderProxy::IsVisible(renderProxy);
+
+        Raw::RenderProxy::SetVisibility(renderProxy, aVisible);
     }
 
-    if (Red::IsInstanceOf<Red::worldPhysicalDestructionNodeInstance>(aNodeInstance))
+    return true;
+}
+
+App::WorldNodeVisibilityResult App::WorldInspector::SetNodesVisibility(const WorldNodeSelector& aSelector,
+                                                                       bool aVisible)
+{
+    return UpdateNodesVisibility(aSelector, true, aVisible);
+}
+
+App::WorldNodeVisibilityResult App::WorldInspector::IsolateNodes(const WorldNodeSelector& aSelector)
+{
+    return UpdateNodesVisibility(aSelector, false, false);
+}
+
+App::WorldNodeVisibilityResult App::WorldInspector::RestoreNodesVisibility()
+{
+    return RestoreVisibilityLayers(1);
+}
+
+App::WorldNodeVisibilityResult App::WorldInspector::RestoreAllNodesVisibility()
+{
+    return RestoreVisibilityLayers(0xFFFFFFFF);
+}
+
+App::WorldNodeVisibilityResult App::WorldInspector::UpdateNodesVisibility(const WorldNodeSelector& aSelector,
+                                                                          bool aMatching, bool aVisible)
+{
+#ifndef NDEBUG
+    const auto updateStart = std::chrono::steady_clock::now();
+#endif
+
+    Core::Set<uint64_t> hashes;
+    hashes.reserve(aSelector.hashes.size);
+    for (const auto& hash : aSelector.hashes)
     {
-        return SetRenderProxyVisibility<Raw::WorldPhysicalDestructionNodeInstance::RenderProxy>(aNodeInstance, aToggle, aVisible);
+        hashes.insert(hash);
     }
 
-    if (Red::IsInstanceOf<Red::worldInstancedMeshNodeInstance>(aNodeInstance))
+    Core::Vector<Red::WeakHandle<Red::worldINodeInstance>> nodeInstances;
     {
-        return SetRenderProxyVisibility<Raw::WorldInstancedMeshNodeInstance::RenderProxies>(aNodeInstance, aToggle, aVisible);
+        std::shared_lock _(m_streamedNodesLock);
+        nodeInstances.reserve(m_streamedNodes.size());
+        for (const auto& [hash, streamedNode] : m_streamedNodes)
+        {
+            nodeInstances.push_back(streamedNode.nodeInstance);
+        }
     }
 
-    if (Red::IsInstanceOf<Red::worldFoliageNodeInstance>(aNodeInstance))
+    WorldNodeVisibilityResult result{};
+    Core::Vector<NodeVisibilityState> changes;
+    Core::Vector<Red::RenderProxy*> renderProxies;
+
+    std::unique_lock _(m_visibilityLock);
+
+    // Only the states that actually change are recorded, so a restore never touches anything else
+    for (const auto& nodeInstance : nodeInstances)
     {
-        return SetRenderProxyVisibility<Raw::WorldFoliageNodeInstance::RenderProxies>(aNodeInstance, aToggle, aVisible);
+        auto nodeInstanceRef = nodeInstance.Lock();
+
+        if (!nodeInstanceRef)
+            continue;
+
+        if (MatchesSelector(aSelector, hashes, nodeInstance) != aMatching)
+            continue;
+
+        ++result.matched;
+
+        const auto classData = GetNodeClassData(nodeInstanceRef->GetType());
+
+        if (classData.isEntityNode)
+        {
+            const auto visible = Raw::WorldNodeInstance::IsVisible(nodeInstanceRef);
+
+            if (visible != aVisible)
+            {
+                Raw::WorldNodeInstance::SetVisibility(nodeInstanceRef, aVisible);
+                changes.push_back({nodeInstance, NodeInstanceProxyIndex, visible});
+            }
+
+            continue;
+        }
+
+        if (!classData.collectRenderProxies)
+            continue;
+
+        renderProxies.clear();
+        classData.collectRenderProxies(nodeInstanceRef.instance, renderProxies);
+
+        for (uint32_t proxyIndex = 0; proxyIndex < renderProxies.size(); ++proxyIndex)
+        {
+            auto* renderProxy = renderProxies[proxyIndex];
+            const auto visible = Raw::RenderProxy::IsVisible(renderProxy);
+
+            if (visible != aVisible)
+            {
+                Raw::RenderProxy::SetVisibility(renderProxy, aVisible);
+                changes.push_back({nodeInstance, proxyIndex, visible});
+            }
+        }
     }
 
-    if (Red::IsInstanceOf<Red::worldTerrainMeshNodeInstance>(aNodeInstance))
+    result.changed = static_cast<uint32_t>(changes.size());
+
+    if (!changes.empty())
     {
-        return SetRenderProxyVisibility<Raw::WorldTerrainMeshNodeInstance::RenderProxies>(aNodeInstance, aToggle, aVisible);
+        m_visibilityLayers.emplace_back(std::move(changes));
     }
 
-    if (Red::IsInstanceOf<Red::worldStaticLightNodeInstance>(aNodeInstance))
+    result.layers = static_cast<uint32_t>(m_visibilityLayers.size());
+
+#ifndef NDEBUG
+    const std::chrono::duration<double, std::milli> updateDuration = std::chrono::steady_clock::now() - updateStart;
+    Core::Log::Debug("UpdateNodesVisibility nodes={} matched={} changed={} layers={} time={:.3f}ms",
+                     nodeInstances.size(), result.matched, result.changed, result.layers, updateDuration.count());
+#endif
+
+    return result;
+}
+
+App::WorldNodeVisibilityResult App::WorldInspector::RestoreVisibilityLayers(uint32_t aLayers)
+{
+    WorldNodeVisibilityResult result{};
+    Core::Vector<Red::RenderProxy*> renderProxies;
+
+    std::unique_lock _(m_visibilityLock);
+
+    // Layers are undone in the reverse order, so every state ends up as it was before the first change
+    for (; aLayers > 0 && !m_visibilityLayers.empty(); --aLayers)
     {
-        return SetRenderProxyVisibility<Raw::WorldStaticLightNodeInstance::RenderProxy>(aNodeInstance, aToggle, aVisible);
+        const auto& changes = m_visibilityLayers.back();
+
+        for (auto change = changes.rbegin(); change != changes.rend(); ++change)
+        {
+            auto nodeInstance = change->nodeInstance.Lock();
+
+            if (!nodeInstance)
+                continue;
+
+            ++result.matched;
+
+            if (change->proxyIndex == NodeInstanceProxyIndex)
+            {
+                Raw::WorldNodeInstance::SetVisibility(nodeInstance, change->visible);
+                ++result.changed;
+                continue;
+            }
+
+            const auto classData = GetNodeClassData(nodeInstance->GetType());
+
+            if (!classData.collectRenderProxies)
+                continue;
+
+            // The proxies can be recreated while the node stays streamed, only the ones still there are restored
+            renderProxies.clear();
+            classData.collectRenderProxies(nodeInstance.instance, renderProxies);
+
+            if (change->proxyIndex < renderProxies.size())
+            {
+                Raw::RenderProxy::SetVisibility(renderProxies[change->proxyIndex], change->visible);
+                ++result.changed;
+            }
+        }
+
+        m_visibilityLayers.pop_back();
     }
 
-    return false;
+    result.layers = static_cast<uint32_t>(m_visibilityLayers.size());
+
+    return result;
+}
+
+bool App::WorldInspector::MatchesSelector(const WorldNodeSelector& aSelector, const Core::Set<uint64_t>& aHashes,
+                                          const Red::WeakHandle<Red::worldINodeInstance>& aNodeInstance)
+{
+    if (!aHashes.empty() && !aHashes.contains(reinterpret_cast<uint64_t>(aNodeInstance.instance)))
+        return false;
+
+    if (!aSelector.sectorHash && !aSelector.nodeType && !aSelector.parentID)
+        return true;
+
+    const auto staticData = m_nodeRegistry->FindNodeStaticData(aNodeInstance);
+
+    if (aSelector.sectorHash && staticData.GetSectorHash() != aSelector.sectorHash)
+        return false;
+
+    if (aSelector.nodeType && staticData.GetNodeType() != aSelector.nodeType)
+        return false;
+
+    if (aSelector.parentID && staticData.GetParentID() != aSelector.parentID)
+        return false;
+
+    return true;
 }
 
 template<typename TRenderProxy>
-bool App::WorldInspector::SetRenderProxyVisibility(const Red::Handle<Red::worldINodeInstance>& aNodeInstance,
-                                                     bool aToggle, bool aVisible)
+void App::WorldInspector::CollectRenderProxies(Red::worldINodeInstance* aNodeInstance,
+                                               Core::Vector<Red::RenderProxy*>& aRenderProxies)
 {
     if constexpr (Red::IsArray<typename TRenderProxy::Type>)
     {
-        auto& renderProxies = TRenderProxy::Ref(aNodeInstance);
-
-        if (!renderProxies.size)
-            return false;
-
-        for (auto& renderProxy : renderProxies)
+        for (auto& renderProxy : TRenderProxy::Ref(aNodeInstance))
         {
-            if (aToggle)
-                aVisible = !Raw::RenderProxy::IsVisible(renderProxy);
-
-            Raw::RenderProxy::SetVisibility(renderProxy, aVisible);
+            if (renderProxy)
+            {
+                aRenderProxies.push_back(renderProxy.instance);
+            }
         }
-        return true;
     }
     else
     {
         auto& renderProxy = TRenderProxy::Ref(aNodeInstance);
 
-        if (!renderProxy)
-            return false;
-
-        if (aToggle)
-            aVisible = !Raw::RenderProxy::IsVisible(renderProxy);
-
-        Raw::RenderProxy::SetVisibility(renderProxy, aVisible);
-        return true;
+        if (renderProxy)
+        {
+            aRenderProxies.push_back(renderProxy.instance);
+        }
     }
 }
 
@@ -676,91 +2201,42 @@ bool App::WorldInspector::ApplyHighlightEffect(const Red::Handle<Red::ISerializa
 
     if (auto& nodeInstance = Red::Cast<Red::worldINodeInstance>(aObject))
     {
-        if (Red::IsInstanceOf<Red::worldEntityNodeInstance>(nodeInstance))
+        const auto classData = GetNodeClassData(nodeInstance->GetType());
+
+        if (classData.isEntityNode)
         {
             auto& entity = Raw::WorldEntityNodeInstance::Entity::Ref(nodeInstance);
             return SetEntityHighlightEffect(entity, aEffect);
         }
 
-        // if (Red::IsInstanceOf<Red::worldInstancedDestructibleMeshNodeInstance>(nodeInstance))
-        // {
-        //     return SetRenderProxyHighlightEffect<Raw::WorldInstancedDestructibleMeshNodeInstance::RenderProxy>(nodeInstance, aEffect);
-        // }
-
-        if (Red::IsInstanceOf<Red::worldMeshNodeInstance>(nodeInstance))
-        {
-            return SetRenderProxyHighlightEffect<Raw::WorldMeshNodeInstance::RenderProxy>(nodeInstance, aEffect);
-        }
-
-        if (Red::IsInstanceOf<Red::worldStaticDecalNodeInstance>(nodeInstance))
-        {
-            return SetRenderProxyHighlightEffect<Raw::WorldStaticDecalNodeInstance::RenderProxy>(nodeInstance, aEffect);
-        }
-
-        if (Red::IsInstanceOf<Red::worldBendedMeshNodeInstance>(nodeInstance))
-        {
-            return SetRenderProxyHighlightEffect<Raw::WorldBendedMeshNodeInstance::RenderProxy>(nodeInstance, aEffect);
-        }
-
-        if (Red::IsInstanceOf<Red::worldPhysicalDestructionNodeInstance>(nodeInstance))
-        {
-            return SetRenderProxyHighlightEffect<Raw::WorldPhysicalDestructionNodeInstance::RenderProxy>(nodeInstance, aEffect);
-        }
-
-        if (Red::IsInstanceOf<Red::worldInstancedMeshNodeInstance>(nodeInstance))
-        {
-            return SetRenderProxyHighlightEffect<Raw::WorldInstancedMeshNodeInstance::RenderProxies>(nodeInstance, aEffect);
-        }
-
-        if (Red::IsInstanceOf<Red::worldFoliageNodeInstance>(nodeInstance))
+        if (classData.collectHighlightProxies)
         {
-            return SetRenderProxyHighlightEffect<Raw::WorldFoliageNodeInstance::RenderProxies>(nodeInstance, aEffect);
-        }
+            Core::Vector<Red::RenderProxy*> renderProxies;
+            classData.collectHighlightProxies(nodeInstance.instance, renderProxies);
 
-        if (Red::IsInstanceOf<Red::worldTerrainMeshNodeInstance>(nodeInstance))
-        {
-            return SetRenderProxyHighlightEffect<Raw::WorldTerrainMeshNodeInstance::RenderProxies>(nodeInstance, aEffect);
+            return SetRenderProxyHighlightEffect(renderProxies, aEffect);
         }
     }
 
     return false;
 }
 
-template<typename TRenderProxy>
-bool App::WorldInspector::SetRenderProxyHighlightEffect(const Red::Handle<Red::worldINodeInstance>& aNodeInstance,
+bool App::WorldInspector::SetRenderProxyHighlightEffect(const Core::Vector<Red::RenderProxy*>& aRenderProxies,
                                                           const Red::Handle<Red::entRenderHighlightEvent>& aEffect)
 {
-    if constexpr (Red::IsArray<typename TRenderProxy::Type>)
-    {
-        auto& renderProxies = TRenderProxy::Ref(aNodeInstance);
-
-        if (!renderProxies.size)
-            return false;
+    if (aRenderProxies.empty())
+        return false;
 
-        Red::HighlightParams highlight{aEffect->seeThroughWalls, 0, aEffect->fillIndex, aEffect->outlineIndex,
-                                       aEffect->opacity, true};
+    Red::HighlightParams highlight{aEffect->seeThroughWalls, 0, aEffect->fillIndex, aEffect->outlineIndex,
+                                   aEffect->opacity, true};
 
-        for (auto& renderProxy : renderProxies)
-        {
-            Raw::RenderProxy::SetScanningState(renderProxy, Red::rendPostFx_ScanningState::Complete);
-            Raw::RenderProxy::SetHighlightParams(renderProxy, highlight);
-        }
-        return true;
-    }
-    else
+    for (auto* renderProxy : aRenderProxies)
     {
-        auto& renderProxy = TRenderProxy::Ref(aNodeInstance);
-
-        if (!renderProxy)
-            return false;
-
-        Red::HighlightParams highlight{aEffect->seeThroughWalls, 0, aEffect->fillIndex, aEffect->outlineIndex,
-                                       aEffect->opacity, true};
-
         Raw::RenderProxy::SetScanningState(renderProxy, Red::rendPostFx_ScanningState::Complete);
         Raw::RenderProxy::SetHighlightParams(renderProxy, highlight);
-        return true;
     }
+
+    return true;
 }
 
 bool App::WorldInspector::SetEntityHighlightEffect(const Red::Handle<Red::entEntity>& aEntity,
@@ -1,7 +1,14 @@
 #pragma once
 
+#include "App/Shared/MemoryUsage.hpp"
 #include "App/World/PhysicsTraceResult.hpp"
+#include "App/World/WorldNodeBoundsCache.hpp"
+#include "App/World/WorldNodeQuery.hpp"
 #include "App/World/WorldNodeRegistry.hpp"
+#include "App/World/WorldNodeSpatialIndex.hpp"
+#include "App/World/WorldNodeTopK.hpp"
+#include "App/World/WorldStreamingProfiler.hpp"
+#include "Red/BoxTree.hpp"
 
 namespace App
 {
@@ -14,6 +21,36 @@ struct WorldNodeStreamingRequest
     Red::CompiledNodeInstanceSetupInfo* nodeSetup;
 };
 
+enum class WorldNodeStreamingState : uint8_t
+{
+    Resolved,
+    Cancelled,
+    Destroyed,
+    WaitingForAttach,
+    WaitingForResource,
+    WaitingForBounds,
+};
+
+// Counters of streaming requests that couldn't be resolved right away.
+// The waiting counts and the oldest wait time describe the current queue, the rest are totals since the start.
+// Expired requests were dropped after waiting for too long, cancelled and destroyed requests were dropped
+// because the node was streamed out or its instance was destroyed while waiting.
+struct WorldStreamingRequestStats
+{
+    uint32_t waiting{0};
+    uint32_t waitingForAttach{0};
+    uint32_t waitingForResource{0};
+    uint32_t waitingForBounds{0};
+    float oldestWaitTime{0};
+    uint64_t postponed{0};
+    uint64_t retried{0};
+    uint64_t woken{0};
+    uint64_t resolved{0};
+    uint64_t expired{0};
+    uint64_t cancelled{0};
+    uint64_t destroyed{0};
+};
+
 struct WorldNodeStaticSceneData
 {
     Red::WeakHandle<Red::worldINodeInstance> nodeInstance;
@@ -21,7 +58,8 @@ struct WorldNodeStaticSceneData
     Red::Transform transform;
     Red::Vector3 scale;
     Red::Box boundingBox;
-    Core::Vector<Red::Box> testBoxes;
+    Red::BoxBatch testBoxes;
+    Red::BoxTree testTree;
     bool isStaticMesh{false};
 };
 
@@ -38,6 +76,83 @@ struct WorldNodeRuntimeSceneData
     bool frustum;
     uint64_t hash;
     bool resolved;
+    int32_t meshInstanceIndex{-1};
+};
+
+// Changes of the frustum nodes since the requested generation.
+// Removals should be applied before additions, a node can be removed and added again within the same range.
+// When the requested generation is no longer tracked, the reset flag is set and all nodes are reported as added.
+struct WorldFrustumChanges
+{
+    uint32_t generation;
+    bool reset;
+    Red::DynArray<WorldNodeRuntimeSceneData> added;
+    Red::DynArray<WorldNodeRuntimeSceneData> moved;
+    Red::DynArray<uint64_t> removed;
+};
+
+// Page of scanned nodes matching a query, sorted by distance.
+// The total is the number of scanned nodes, the matched count covers all pages.
+struct WorldNodeQueryResult
+{
+    uint32_t total;
+    uint32_t matched;
+    Red::DynArray<WorldNodeRuntimeSceneData> nodes;
+};
+
+// Streamed nodes to change the visibility of, every criterion that is set must match.
+// The hashes are the runtime hashes of the node instances as reported by the frustum queries.
+struct WorldNodeSelector
+{
+    uint64_t sectorHash{0};
+    Red::CName nodeType;
+    uint64_t parentID{0};
+    Red::DynArray<uint64_t> hashes;
+};
+
+// Outcome of a bulk visibility change, the layers are the changes that can still be restored.
+struct WorldNodeVisibilityResult
+{
+    uint32_t matched{0};
+    uint32_t changed{0};
+    uint32_t layers{0};
+};
+
+// Everything the scanner and the inspector show about a node definition and its sector.
+struct WorldNodeTargetData
+{
+    uint64_t hash;
+    Red::CName nodeType;
+    Red::CName nodeGroup;
+    uint64_t sectorHash;
+    Red::CString sectorPath;
+    int32_t instanceIndex{-1};
+    uint32_t instanceCount;
+    int32_t nodeIndex{-1};
+    uint32_t nodeCount;
+    uint64_t nodeID;
+    uint64_t parentID;
+    Red::CString debugName;
+    Red::CString nodeRef;
+    Red::CString parentRef;
+    Red::CString meshPath;
+    Red::CName meshAppearance;
+    Red::CString materialPath;
+    Red::CString effectPath;
+    Red::CString templatePath;
+    Red::CName appearanceName;
+    Red::CString recordID;
+    Red::DynArray<Red::CName> triggerNotifiers;
+    bool isAreaNode;
+    bool isOccluderNode;
+    bool isProxyMeshNode;
+    bool isCommunityNode;
+    bool isSpawnerNode;
+    bool isCollisionNode;
+    bool isLightNode;
+    bool isInstancedOccluderNode;
+    bool isDeviceNode;
+    bool isAISpotNode;
 };
 
 struct WorldNodeRuntimeGeometryData
@@ -55,14 +170,25 @@ struct WorldCommunityEntryData : WorldCommunityStaticData
     Red::CName entryPhase;
 };
 
-class WorldInspector
-    : public Red::IGameSystem
-    , public IWorldNodeInstanceWatcher
+class WorldInspector : public Red::IGameSystem
 {
 public:
     static constexpr auto FrustumUpdateFreq = 0.1f;
     static constexpr auto FrustumMinDistance = 120.0f;
     static constexpr auto FrustumMaxDistance = 999.0f;
+    static constexpr auto FrustumHistorySize = 100u;
+    static constexpr auto FrustumMoveTolerance = 0.5f;
+    static constexpr auto FrustumMinChunkSize = 16u;
+    static constexpr auto FrustumMaxChunkSize = 16384u;
+    static constexpr auto FrustumDefaultChunkSize = 512u;
+    static constexpr auto CrosshairMaxLimit = 64u;
+    static constexpr auto CrosshairDefaultLimit = 8u;
+    static constexpr auto ScannerMinPageSize = 10u;
+    static constexpr auto ScannerMaxPageSize = 10000u;
+    static constexpr auto ScannerDefaultPageSize = 200u;
+    static constexpr auto StreamingRetryMinDelay = 0.1f;
+    static constexpr auto StreamingRetryMaxDelay = 3.2f;
+    static constexpr auto StreamingRetryMaxAge = 30.0f;
 
     WorldInspector() = default;
 
@@ -70,6 +196,12 @@ public:
     void SetFrustumDistance(float aDistance);
     [[nodiscard]] float GetTargetingDistance() const;
     void SetTargetingDistance(float aDistance);
+    [[nodiscard]] uint32_t GetFrustumChunkSize() const;
+    void SetFrustumChunkSize(uint32_t aSize);
+    [[nodiscard]] uint32_t GetCrosshairLimit() const;
+    void SetCrosshairLimit(uint32_t aLimit);
+    [[nodiscard]] uint32_t GetScannerPageSize() const;
+    void SetScannerPageSize(uint32_t aSize);
 
     WorldNodeInstanceStaticData ResolveSectorDataFromNodeID(uint64_t aNodeID);
     WorldNodeInstanceStaticData ResolveSectorDataFromNodeInstance(const Red::WeakHandle<Red::worldINodeInstance>& aNodeInstance);
@@ -78,60 +210,261 @@ public:
     uint64_t ComputeNodeRefHash(const Red::CString& aNodeRef);
     Red::EntityID ResolveCommunityIDFromEntityID(uint64_t aEntityID);
     WorldCommunityEntryData ResolveCommunityEntryDataFromEntityID(uint64_t aEntityID);
+    Red::DynArray<WorldCommunityEntryData> ResolveCommunityEntryDataFromEntityIDs(
+        const Red::DynArray<uint64_t>& aEntityIDs);
+
+    WorldStreamingRequestStats GetStreamingRequestStats();
+    Red::DynArray<MemoryUsage> GetMemoryUsage();
+    bool SetMemoryBudget(Red::CName aName, uint64_t aBytes);
+    void LogMemoryUsage();
 
     WorldNodeRuntimeSceneData FindStreamedNode(uint64_t aNodeID);
     Red::DynArray<WorldNodeRuntimeSceneData> GetStreamedNodesInFrustum();
     Red::DynArray<WorldNodeRuntimeSceneData> GetStreamedNodesInCrosshair();
+    [[nodiscard]] uint32_t GetFrustumGeneration();
+    WorldFrustumChanges GetFrustumChanges(uint32_t aSinceGeneration);
     WorldNodeRuntimeGeometryData GetStreamedNodeGeometry(const Red::WeakHandle<Red::worldINodeInstance>& aNode);
 
+    void RegisterNodeGroup(Red::CName aNodeType, Red::CName aNodeGroup);
+    WorldNodeTargetData ResolveTarget(const Red::WeakHandle<Red::worldINodeInstance>& aNodeInstance,
+                                      const Red::WeakHandle<Red::worldNode>& aNodeDefinition);
+    Red::DynArray<WorldNodeTargetData> ResolveTargets(const Red::DynArray<WorldNodeRuntimeSceneData>& aNodes);
+    uint32_t ScanFrustumNodes();
+    WorldNodeQueryResult QueryScannedNodes(float aDistance, Red::CName aGroup, const Red::CString& aTerm,
+                                           uint32_t aOffset, uint32_t aLimit);
+
+    bool StartTrace(const Red::CString& aFileName);
+    void StopTrace();
+    bool IsTraceRecording();
+
+    void StartStreamingProfiler();
+    void StopStreamingProfiler();
+    void ResetStreamingProfiler();
+    bool IsStreamingProfiling();
+    Red::DynArray<WorldStreamingLatencyStats> GetStreamingLatencyStats();
+    bool DumpStreamingLatency(const Red::CString& aFileName);
+
     bool ApplyHighlightEffect(const Red::Handle<Red::ISerializable>& aObject,
                               const Red::Handle<Red::entRenderHighlightEvent>& aEffect);
     bool SetNodeVisibility(const Red::Handle<Red::worldINodeInstance>& aNodeInstance, bool aVisible);
     bool ToggleNodeVisibility(const Red::Handle<Red::worldINodeInstance>& aNodeInstance);
+    WorldNodeVisibilityResult SetNodesVisibility(const WorldNodeSelector& aSelector, bool aVisible);
+    WorldNodeVisibilityResult IsolateNodes(const WorldNodeSelector& aSelector);
+    WorldNodeVisibilityResult RestoreNodesVisibility();
+    WorldNodeVisibilityResult RestoreAllNodesVisibility();
 
     PhysicsTraceResultObject GetPhysicsTraceObject(Red::ScriptRef<Red::physicsTraceResult>& aTrace);
     Red::Vector4 ProjectWorldPoint(const Red::Vector4& aPoint);
 
 private:
+    struct PostponedRequest
+    {
+        WorldNodeStreamingRequest request;
+        WorldNodeStreamingState state;
+        uint32_t attempts;
+        std::chrono::steady_clock::time_point postponedAt;
+        std::chrono::steady_clock::time_point retryAt;
+        uint64_t queuedAt;
+    };
+
+    // Result of a frustum update, it's never changed once published, so readers can share it without locking.
+    struct FrustumSnapshot
+    {
+        Red::DynArray<WorldNodeRuntimeSceneData> frustumNodes;
+        Red::DynArray<WorldNodeRuntimeSceneData> targetedNodes;
+    };
+
+    struct FrustumNodeState
+    {
+        WorldNodeRuntimeSceneData node;
+        uint32_t addedGeneration;
+        uint32_t movedGeneration;
+        uint32_t seenGeneration;
+    };
+
+    using RenderProxyCollector = void (*)(Red::worldINodeInstance* aNodeInstance,
+                                          Core::Vector<Red::RenderProxy*>& aRenderProxies);
+
+    // Where the bounds of a streamed node come from.
+    enum class NodeBoundsSource : uint8_t
+    {
+        None,
+        Mesh,
+        Definition,
+        Instances,
+    };
+
+    // Properties and type checks of a node or node instance class, looked up once per class,
+    // so the hot paths need a single lookup instead of walking the class hierarchy for every node.
+    struct NodeClassData
+    {
+        Red::CName nodeType;
+        Red::CName nodeGroup;
+        const Red::CProperty* meshProp;
+        const Red::CProperty* materialProp;
+        const Red::CProperty* effectProp;
+        const Red::CProperty* templateProp;
+        const Red::CProperty* meshAppearanceProp;
+        const Red::CProperty* appearanceNameProp;
+        const Red::CProperty* recordProp;
+        const Red::CProperty* notifiersProp;
+        bool isAreaNode;
+        bool isOccluderNode;
+        bool isProxyMeshNode;
+        bool isCommunityNode;
+        bool isSpawnerNode;
+        bool isCollisionNode;
+        bool isLightNode;
+        bool isInstancedOccluderNode;
+        bool isDeviceNode;
+        bool isAISpotNode;
+        bool isStaticMesh;
+        NodeBoundsSource boundsSource;
+        bool isEntityNode;
+        RenderProxyCollector collectRenderProxies;
+        RenderProxyCollector collectHighlightProxies;
+    };
+
+    // Visibility of a node instance or one of its render proxies before a bulk change.
+    struct NodeVisibilityState
+    {
+        Red::WeakHandle<Red::worldINodeInstance> nodeInstance;
+        uint32_t proxyIndex;
+        bool visible;
+    };
+
+    static constexpr auto NodeInstanceProxyIndex = 0xFFFFFFFFu;
+
+    struct FrustumChunk
+    {
+        Core::Vector<WorldNodeRuntimeSceneData> nodes;
+        WorldNodeTopK<uint32_t> targetedNodes;
+#ifndef NDEBUG
+        std::chrono::duration<double, std::milli> resolveDuration{};
+        std::chrono::duration<double, std::milli> raycastDuration{};
+#endif
+    };
+
+    // Everything the result of a frustum update depends on, the update is skipped when it doesn't change.
+    struct FrustumView
+    {
+        Red::Frustum cameraFrustum;
+        Red::Vector4 cameraPosition{};
+        Red::Vector4 cameraForward{};
+        float frustumDistance{0};
+        float targetingDistance{0};
+        uint32_t crosshairLimit{0};
+        uint32_t streamedNodesVersion{0};
+    };
+
+    // State of a single frustum update shared by all workers.
+    // Workers that start after all chunks are taken return without touching anything but this state.
+    struct FrustumUpdate
+    {
+        FrustumView view;
+        Red::Vector4 cameraInverseDirection{};
+        const Core::Map<uint64_t, WorldNodeStaticSceneData>* streamedNodes{nullptr};
+        Core::Vector<uint64_t> candidateNodes;
+        uint32_t chunkSize{0};
+        Core::Vector<FrustumChunk> chunks;
+        std::atomic<uint32_t> nextChunk{0};
+        uint32_t finishedChunks{0};
+        std::mutex finishedLock;
+        std::condition_variable finishedEvent;
+    };
+
     void OnWorldAttached(Red::world::RuntimeScene*) override;
     void OnAfterWorldDetach() override;
     void OnRegisterUpdates(Red::UpdateRegistrar* aRegistrar) override;
 
-    void OnNodeStreamedIn(uint64_t aNodeHash,
-                          Red::worldNode* aNodeDefinition,
-                          Red::worldINodeInstance* aNodeInstance,
-                          Red::CompiledNodeInstanceSetupInfo* aNodeSetup) override;
-    void OnNodeStreamedOut(uint64_t aNodeHash) override;
+    void CollectStreamingRequests(Core::Map<uint64_t, WorldNodeStreamingRequest>& aRequests);
+    void CollectPostponedRequests(Core::Map<uint64_t, WorldNodeStreamingRequest>& aRequests);
+    void UpdatePostponedRequests(const Core::Map<uint64_t, WorldNodeStreamingRequest>& aRequests,
+                                 const Core::Vector<std::pair<uint64_t, WorldNodeStreamingState>>& aRequestStates);
+    static std::chrono::steady_clock::duration GetStreamingRetryDelay(uint32_t aAttempts);
+
+    WorldCommunityEntryData ResolveCommunityEntryData(Red::IEntityStubSystem* aEntityStubSystem,
+                                                      Red::ICommunitySystem* aCommunitySystem, uint64_t aEntityID);
 
     void UpdateStreamedNodes();
     void UpdateFrustumNodes();
+    bool IsFrustumViewChanged(const FrustumView& aView);
+    static uint32_t UpdateFrustumChunks(const Core::SharedPtr<FrustumUpdate>& aUpdate);
+    static void ProcessFrustumChunks(FrustumUpdate& aUpdate);
+    static void ProcessFrustumChunk(FrustumUpdate& aUpdate, uint32_t aChunkIndex);
+    void CommitFrustumChanges(const Red::DynArray<WorldNodeRuntimeSceneData>& aFrustumNodes);
+    void ResetFrustumChanges();
+
+    static Red::Box GetStreamedNodeBounds(const WorldNodeStaticSceneData& aStreamedNode);
+    static size_t GetStreamedNodeDataSize(const WorldNodeStaticSceneData& aStreamedNode);
+    MemoryUsage GetStreamedNodesUsage();
+    void CompactStreamedNodes();
+
+    WorldNodeQueryRecord ResolveQueryRecord(const WorldNodeRuntimeSceneData& aNode);
+    static bool IsSameSceneNode(const WorldNodeRuntimeSceneData& aNode, const WorldNodeRuntimeSceneData& aOtherNode);
+    NodeClassData GetNodeClassData(Red::CClass* aClass);
+    static Red::CString ResolveResourcePath(const Red::CProperty* aProp, void* aInstance);
 
     bool UpdateNodeVisibility(const Red::Handle<Red::worldINodeInstance>& aNodeInstance, bool aToggle, bool aVisible);
+    WorldNodeVisibilityResult UpdateNodesVisibility(const WorldNodeSelector& aSelector, bool aMatching,
+                                                    bool aVisible);
+    WorldNodeVisibilityResult RestoreVisibilityLayers(uint32_t aLayers);
+    bool MatchesSelector(const WorldNodeSelector& aSelector, const Core::Set<uint64_t>& aHashes,
+                         const Red::WeakHandle<Red::worldINodeInstance>& aNodeInstance);
     template<typename TRenderProxy>
-    bool SetRenderProxyVisibility(const Red::Handle<Red::worldINodeInstance>& aNodeInstance, bool aToggle, bool aVisible);
-    template<typename TRenderProxy>
-    bool SetRenderProxyHighlightEffect(const Red::Handle<Red::worldINodeInstance>& aNodeInstance,
-                                       const Red::Handle<Red::entRenderHighlightEvent>& aEffect);
+    static void CollectRenderProxies(Red::worldINodeInstance* aNodeInstance,
+                                     Core::Vector<Red::RenderProxy*>& aRenderProxies);
+    static bool SetRenderProxyHighlightEffect(const Core::Vector<Red::RenderProxy*>& aRenderProxies,
+                                              const Red::Handle<Red::entRenderHighlightEvent>& aEffect);
     bool SetEntityHighlightEffect(const Red::Handle<Red::entEntity>& aEntity,
                                   const Red::Handle<Red::entRenderHighlightEvent>& aEffect);
 
     Core::SharedPtr<WorldNodeRegistry> m_nodeRegistry;
+    Core::SharedPtr<WorldNodeEventRing> m_nodeEvents;
+    Core::Map<Red::worldINodeInstance*, uint64_t> m_nodeEventHashes; // Owned by the streaming update
     Red::gameICameraSystem* m_cameraSystem;
 
-    std::shared_mutex m_pendingRequestsLock;
-    Core::Map<uint64_t, WorldNodeStreamingRequest> m_pendingRequests;
+    std::shared_mutex m_postponedRequestsLock;
+    Core::Map<uint64_t, PostponedRequest> m_postponedRequests;
+    WorldStreamingRequestStats m_streamingRequestStats;
 
     std::shared_mutex m_streamedNodesLock;
     Core::Map<uint64_t, WorldNodeStaticSceneData> m_streamedNodes;
-
+    WorldNodeSpatialIndex m_streamedNodesIndex;
+    WorldNodeSpatialQuery m_streamedNodesQuery; // Owned by the frustum update, only one runs at a time
+    WorldNodeBoundsCache m_streamedNodesBounds;
+    uint32_t m_streamedNodesVersion{0};
+    uint64_t m_streamedNodesDataBytes{0};
+    uint64_t m_streamedNodesBudget{0};
+    uint64_t m_streamedNodesCompactSize{0};
+
+    std::atomic<Core::SharedPtr<const FrustumSnapshot>> m_frustumSnapshot{Core::MakeShared<const FrustumSnapshot>()};
+    Core::SharedPtr<FrustumSnapshot> m_frustumBackBuffer;
     std::shared_mutex m_frustumNodesLock;
-    Red::DynArray<WorldNodeRuntimeSceneData> m_frustumNodes;
-    Red::DynArray<WorldNodeRuntimeSceneData> m_targetedNodes;
+    Core::Map<uint64_t, FrustumNodeState> m_frustumNodeStates;
+    Core::Vector<std::pair<uint32_t, uint64_t>> m_frustumRemovals;
+    uint32_t m_frustumGeneration{0};
+    uint32_t m_frustumHistoryStart{1};
+    FrustumView m_frustumView;
+
+    std::mutex m_visibilityLock;
+    Core::Vector<Core::Vector<NodeVisibilityState>> m_visibilityLayers;
+
+    std::mutex m_scannerLock;
+    Core::Vector<WorldNodeRuntimeSceneData> m_scannedNodes;
+    Core::Vector<WorldNodeQueryRecord> m_scannedRecords;
+
+    std::shared_mutex m_nodeClassesLock;
+    Core::Map<Red::CClass*, NodeClassData> m_nodeClasses;
+    Core::Map<Red::CName, Red::CName> m_nodeGroups;
 
     float m_nodesUpdateDelay;
     volatile bool m_nodesUpdating;
     float m_frustumDistance{FrustumMinDistance};
     float m_targetingDistance{FrustumMinDistance};
+    uint32_t m_frustumChunkSize{FrustumDefaultChunkSize};
+    uint32_t m_crosshairLimit{CrosshairDefaultLimit};
+    uint32_t m_scannerPageSize{ScannerDefaultPageSize};
 
     RTTI_IMPL_TYPEINFO(App::WorldInspector);
     RTTI_IMPL_ALLOCATOR();
@@ -160,6 +493,84 @@ RTTI_DEFINE_CLASS(App::WorldNodeRuntimeSceneData, {
     RTTI_PROPERTY(distance);
     RTTI_PROPERTY(resolved);
     RTTI_PROPERTY(hash);
+    RTTI_PROPERTY(meshInstanceIndex);
+});
+
+RTTI_DEFINE_CLASS(App::WorldStreamingRequestStats, {
+    RTTI_PROPERTY(waiting);
+    RTTI_PROPERTY(waitingForAttach);
+    RTTI_PROPERTY(waitingForResource);
+    RTTI_PROPERTY(waitingForBounds);
+    RTTI_PROPERTY(oldestWaitTime);
+    RTTI_PROPERTY(postponed);
+    RTTI_PROPERTY(retried);
+    RTTI_PROPERTY(woken);
+    RTTI_PROPERTY(resolved);
+    RTTI_PROPERTY(expired);
+    RTTI_PROPERTY(cancelled);
+    RTTI_PROPERTY(destroyed);
+});
+
+RTTI_DEFINE_CLASS(App::WorldFrustumChanges, {
+    RTTI_PROPERTY(generation);
+    RTTI_PROPERTY(reset);
+    RTTI_PROPERTY(added);
+    RTTI_PROPERTY(moved);
+    RTTI_PROPERTY(removed);
+});
+
+RTTI_DEFINE_CLASS(App::WorldNodeQueryResult, {
+    RTTI_PROPERTY(total);
+    RTTI_PROPERTY(matched);
+    RTTI_PROPERTY(nodes);
+});
+
+RTTI_DEFINE_CLASS(App::WorldNodeSelector, {
+    RTTI_PROPERTY(sectorHash);
+    RTTI_PROPERTY(nodeType);
+    RTTI_PROPERTY(parentID);
+    RTTI_PROPERTY(hashes);
+});
+
+RTTI_DEFINE_CLASS(App::WorldNodeVisibilityResult, {
+    RTTI_PROPERTY(matched);
+    RTTI_PROPERTY(changed);
+    RTTI_PROPERTY(layers);
+});
+
+RTTI_DEFINE_CLASS(App::WorldNodeTargetData, {
+    RTTI_PROPERTY(hash);
+    RTTI_PROPERTY(nodeType);
+    RTTI_PROPERTY(nodeGroup);
+    RTTI_PROPERTY(sectorHash);
+    RTTI_PROPERTY(sectorPath);
+    RTTI_PROPERTY(instanceIndex);
+    RTTI_PROPERTY(instanceCount);
+    RTTI_PROPERTY(nodeIndex);
+    RTTI_PROPERTY(nodeCount);
+    RTTI_PROPERTY(nodeID);
+    RTTI_PROPERTY(parentID);
+    RTTI_PROPERTY(debugName);
+    RTTI_PROPERTY(nodeRef);
+    RTTI_PROPERTY(parentRef);
+    RTTI_PROPERTY(meshPath);
+    RTTI_PROPERTY(meshAppearance);
+    RTTI_PROPERTY(materialPath);
+    RTTI_PROPERTY(effectPath);
+    RTTI_PROPERTY(templatePath);
+    RTTI_PROPERTY(appearanceName);
+    RTTI_PROPERTY(recordID);
+    RTTI_PROPERTY(triggerNotifiers);
+    RTTI_PROPERTY(isAreaNode);
+    RTTI_PROPERTY(isOccluderNode);
+    RTTI_PROPERTY(isProxyMeshNode);
+    RTTI_PROPERTY(isCommunityNode);
+    RTTI_PROPERTY(isSpawnerNode);
+    RTTI_PROPERTY(isCollisionNode);
+    RTTI_PROPERTY(isLightNode);
+    RTTI_PROPERTY(isInstancedOccluderNode);
+    RTTI_PROPERTY(isDeviceNode);
+    RTTI_PROPERTY(isAISpotNode);
 });
 
 RTTI_DEFINE_CLASS(App::WorldNodeRuntimeGeometryData, {
@@ -188,6 +599,12 @@ RTTI_DEFINE_CLASS(App::WorldInspector, {
     RTTI_METHOD(SetFrustumDistance);
     RTTI_METHOD(GetTargetingDistance);
     RTTI_METHOD(SetTargetingDistance);
+    RTTI_METHOD(GetFrustumChunkSize);
+    RTTI_METHOD(SetFrustumChunkSize);
+    RTTI_METHOD(GetCrosshairLimit);
+    RTTI_METHOD(SetCrosshairLimit);
+    RTTI_METHOD(GetScannerPageSize);
+    RTTI_METHOD(SetScannerPageSize);
 
     RTTI_METHOD(ResolveSectorDataFromNodeID);
     RTTI_METHOD(ResolveSectorDataFromNodeInstance);
@@ -195,14 +612,39 @@ RTTI_DEFINE_CLASS(App::WorldInspector, {
     RTTI_METHOD(ComputeNodeRefHash);
     RTTI_METHOD(ResolveCommunityIDFromEntityID);
     RTTI_METHOD(ResolveCommunityEntryDataFromEntityID);
+    RTTI_METHOD(ResolveCommunityEntryDataFromEntityIDs);
+    RTTI_METHOD(GetStreamingRequestStats);
+    RTTI_METHOD(GetMemoryUsage);
+    RTTI_METHOD(SetMemoryBudget);
+    RTTI_METHOD(LogMemoryUsage);
     RTTI_METHOD(FindStreamedNode);
     RTTI_METHOD(GetStreamedNodesInFrustum);
     RTTI_METHOD(GetStreamedNodesInCrosshair);
+    RTTI_METHOD(GetFrustumGeneration);
+    RTTI_METHOD(GetFrustumChanges);
     RTTI_METHOD(GetStreamedNodeGeometry);
+    RTTI_METHOD(RegisterNodeGroup);
+    RTTI_METHOD(ResolveTarget);
+    RTTI_METHOD(ResolveTargets);
+    RTTI_METHOD(ScanFrustumNodes);
+    RTTI_METHOD(QueryScannedNodes);
+    RTTI_METHOD(StartTrace);
+    RTTI_METHOD(StopTrace);
+    RTTI_METHOD(IsTraceRecording);
+    RTTI_METHOD(StartStreamingProfiler);
+    RTTI_METHOD(StopStreamingProfiler);
+    RTTI_METHOD(ResetStreamingProfiler);
+    RTTI_METHOD(IsStreamingProfiling);
+    RTTI_METHOD(GetStreamingLatencyStats);
+    RTTI_METHOD(DumpStreamingLatency);
 
     RTTI_METHOD(ApplyHighlightEffect);
     RTTI_METHOD(SetNodeVisibility);
     RTTI_METHOD(ToggleNodeVisibility);
+    RTTI_METHOD(SetNodesVisibility);
+    RTTI_METHOD(IsolateNodes);
+    RTTI_METHOD(RestoreNodesVisibility);
+    RTTI_METHOD(RestoreAllNodesVisibility);
 
     RTTI_METHOD(GetPhysicsTraceObject);
     RTTI_METHOD(ProjectWorldPoint);
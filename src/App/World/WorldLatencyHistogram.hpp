@@ -0,0 +1,120 @@
+#pragma once
+
+#include <bit>
+
+namespace App
+{
+// Log-linear histogram in the spirit of HdrHistogram, every power of two range is split into 16 linear buckets.
+// A value keeps its 4 most significant bits, so a reported percentile is at most 1/16 above the recorded value.
+// The buckets are only allocated with the first sample, most histograms of a profiling session stay empty.
+class WorldLatencyHistogram
+{
+public:
+    static constexpr auto SubBucketBits = 4u;
+    static constexpr auto SubBucketCount = 1u << SubBucketBits;
+    static constexpr auto ValueBits = 40u;
+    static constexpr auto MaxValue = (uint64_t(1) << ValueBits) - 1;
+    static constexpr auto BucketCount = (ValueBits - SubBucketBits + 1) * SubBucketCount;
+
+    void Record(uint64_t aValue)
+    {
+        if (m_counts.empty())
+        {
+            m_counts.resize(BucketCount);
+        }
+
+        aValue = std::min(aValue, MaxValue);
+
+        ++m_counts[GetBucketIndex(aValue)];
+        ++m_samples;
+        m_max = std::max(m_max, aValue);
+    }
+
+    void Merge(const WorldLatencyHistogram& aOther)
+    {
+        if (aOther.m_counts.empty())
+            return;
+
+        if (m_counts.empty())
+        {
+            m_counts.resize(BucketCount);
+        }
+
+        for (uint32_t bucket = 0; bucket < BucketCount; ++bucket)
+        {
+            m_counts[bucket] += aOther.m_counts[bucket];
+        }
+
+        m_samples += aOther.m_samples;
+        m_max = std::max(m_max, aOther.m_max);
+    }
+
+    void Clear()
+    {
+        m_counts.clear();
+        m_samples = 0;
+        m_max = 0;
+    }
+
+    // Highest value of the bucket where the percentile falls, limited by the largest recorded value.
+    [[nodiscard]] uint64_t GetPercentile(double aPercentile) const
+    {
+        if (!m_samples)
+            return 0;
+
+        const auto rank = std::max(static_cast<uint64_t>(std::ceil(aPercentile / 100.0 * m_samples)), uint64_t(1));
+
+        uint64_t samples = 0;
+        for (uint32_t bucket = 0; bucket < BucketCount; ++bucket)
+        {
+            samples += m_counts[bucket];
+
+            if (samples >= rank)
+                return std::min(GetBucketUpperBound(bucket), m_max);
+        }
+
+        return m_max;
+    }
+
+    [[nodiscard]] uint64_t GetSamples() const
+    {
+        return m_samples;
+    }
+
+    [[nodiscard]] uint64_t GetMax() const
+    {
+        return m_max;
+    }
+
+    [[nodiscard]] bool IsEmpty() const
+    {
+        return m_samples == 0;
+    }
+
+private:
+    static uint32_t GetBucketIndex(uint64_t aValue)
+    {
+        if (aValue < SubBucketCount)
+            return static_cast<uint32_t>(aValue);
+
+        const auto shift = static_cast<uint32_t>(std::bit_width(aValue)) - 1 - SubBucketBits;
+
+        return (shift + 1) * SubBucketCount + static_cast<uint32_t>((aValue >> shift) - SubBucketCount);
+    }
+
+    static uint64_t GetBucketUpperBound(uint32_t aBucket)
+    {
+        if (aBucket < SubBucketCount)
+            return aBucket;
+
+        const auto shift = aBucket / SubBucketCount - 1;
+        const auto leadingBits = static_cast<uint64_t>(aBucket % SubBucketCount + SubBucketCount);
+
+        return ((leadingBits + 1) << shift) - 1;
+    }
+
+    Core::Vector<uint32_t> m_counts;
+    uint64_t m_samples{0};
+    uint64_t m_max{0};
+};
+}
@@ -0,0 +1,140 @@
+#include "WorldNodeBoundsCache.hpp"
+#include "App/Archives/ArchiveLoader.hpp"
+#include "Red/Transform.hpp"
+#include "Red/WorldNode.hpp"
+
+bool App::WorldNodeBoundsCache::GetBounds(const Red::Handle<Red::worldNode>& aNode, Red::Box& aBounds)
+{
+    const auto resourceGeneration = ArchiveLoader::GetResourceGeneration();
+
+    if (m_resourceGeneration != resourceGeneration)
+    {
+        if (!m_entries.empty())
+        {
+            m_entries.clear();
+            ++m_stats.invalidations;
+        }
+
+        m_resourceGeneration = resourceGeneration;
+    }
+
+    const auto& entryIt = m_entries.find(aNode.instance);
+
+    if (entryIt != m_entries.end() && !entryIt->second.node.Expired())
+    {
+        ++m_stats.hits;
+        entryIt.value().lastUse = ++m_useCounter;
+        aBounds = entryIt->second.bounds;
+        return true;
+    }
+
+    ++m_stats.misses;
+
+    Red::Box bounds{{1.0, 0.0, 0.0, 0.0}, {-1.0, 0.0, 0.0, 0.0}};
+    Raw::WorldNode::GetBoundingBox(aNode, bounds);
+
+    // Bounds can depend on resources that aren't loaded yet, so invalid results are asked for again next time
+    if (!Red::IsValidBox(bounds))
+        return false;
+
+    if (m_entries.size() >= m_pruneSize)
+    {
+        Prune();
+    }
+
+    if (MemoryAccounting::IsOverBudget(GetMemoryUsage()))
+    {
+        Evict();
+    }
+
+    m_entries.insert_or_assign(aNode.instance, Entry{aNode, bounds, ++m_useCounter});
+    aBounds = bounds;
+
+    return true;
+}
+
+void App::WorldNodeBoundsCache::Clear()
+{
+    m_entries.clear();
+    m_pruneSize = MinPruneSize;
+}
+
+void App::WorldNodeBoundsCache::SetMemoryBudget(uint64_t aBytes)
+{
+    m_memoryBudget = aBytes;
+}
+
+App::WorldNodeBoundsCacheStats App::WorldNodeBoundsCache::GetStats() const
+{
+    auto stats = m_stats;
+    stats.entries = static_cast<uint32_t>(m_entries.size());
+
+    return stats;
+}
+
+void App::WorldNodeBoundsCache::Prune()
+{
+    for (auto it = m_entries.begin(); it != m_entries.end();)
+    {
+        if (it->second.node.Expired())
+        {
+            it = m_entries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // The threshold follows the number of live definitions, so pruning stays amortized
+    m_pruneSize = std::max(MinPruneSize, static_cast<uint32_t>(m_entries.size()) * 2);
+}
+
+App::MemoryUsage App::WorldNodeBoundsCache::GetMemoryUsage() const
+{
+    return {"WorldInspector.BoundsCache", m_entries.size(), MemoryAccounting::GetBytes(m_entries), m_memoryBudget};
+}
+
+void App::WorldNodeBoundsCache::Evict()
+{
+    Prune();
+
+    if (m_entries.empty())
+        return;
+
+    // The bucket count is rounded up on rehash, so only half of the budget is filled to stay under it afterwards
+    const auto bytesPerEntry = MemoryAccounting::GetBytes(m_entries) / std::max<size_t>(m_entries.bucket_count(), 1);
+    const auto keepCount = std::min(m_entries.size(), static_cast<size_t>(m_memoryBudget / 2 / bytesPerEntry));
+
+    if (keepCount < m_entries.size())
+    {
+        Core::Vector<uint32_t> lastUses;
+        lastUses.reserve(m_entries.size());
+
+        for (const auto& [node, entry] : m_entries)
+        {
+            lastUses.push_back(entry.lastUse);
+        }
+
+        const auto threshold = lastUses.begin() + static_cast<ptrdiff_t>(lastUses.size() - keepCount);
+        std::nth_element(lastUses.begin(), threshold, lastUses.end());
+
+        const auto minLastUse = keepCount ? *threshold : std::numeric_limits<uint32_t>::max();
+
+        for (auto it = m_entries.begin(); it != m_entries.end();)
+        {
+            if (it->second.lastUse < minLastUse)
+            {
+                it = m_entries.erase(it);
+                ++m_stats.evictions;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    m_entries.rehash(0);
+    m_pruneSize = std::max(MinPruneSize, static_cast<uint32_t>(m_entries.size()) * 2);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "App/Shared/MemoryUsage.hpp"
+
+namespace App
+{
+struct WorldNodeBoundsCacheStats
+{
+    uint32_t entries{0};
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t invalidations{0};
+    uint64_t evictions{0};
+};
+
+// Local bounds of node definitions, shared by all instances of the same definition.
+// Entries keep a weak reference to the definition, so a new definition allocated at the same address is not
+// mistaken for the old one. Everything is dropped when archives are hot reloaded, because the bounds of some nodes
+// depend on the resources they reference. When the cache grows over its budget, the least recently used entries
+// are evicted, they're computed again on the next request.
+class WorldNodeBoundsCache
+{
+public:
+    static constexpr auto MinPruneSize = 4096u;
+
+    bool GetBounds(const Red::Handle<Red::worldNode>& aNode, Red::Box& aBounds);
+    void Clear();
+
+    void SetMemoryBudget(uint64_t aBytes);
+
+    [[nodiscard]] WorldNodeBoundsCacheStats GetStats() const;
+    [[nodiscard]] MemoryUsage GetMemoryUsage() const;
+
+private:
+    struct Entry
+    {
+        Red::WeakHandle<Red::worldNode> node;
+        Red::Box bounds;
+        uint32_t lastUse;
+    };
+
+    void Prune();
+    void Evict();
+
+    Core::Map<Red::worldNode*, Entry> m_entries;
+    uint32_t m_pruneSize{MinPruneSize};
+    uint32_t m_resourceGeneration{0};
+    uint32_t m_useCounter{0};
+    uint64_t m_memoryBudget{0};
+    WorldNodeBoundsCacheStats m_stats;
+};
+}
@@ -0,0 +1,115 @@
+#include "WorldNodeEventRing.hpp"
+
+App::WorldNodeEventRing::WorldNodeEventRing(uint32_t aCapacity)
+    : m_slots(GetSlotCount(aCapacity))
+    , m_mask(m_slots.size() - 1)
+{
+    for (uint64_t slotIndex = 0; slotIndex < m_slots.size(); ++slotIndex)
+    {
+        m_slots[slotIndex].sequence.store(slotIndex, std::memory_order_relaxed);
+    }
+}
+
+bool App::WorldNodeEventRing::Push(WorldNodeInstanceEvent&& aEvent)
+{
+    auto position = m_enqueuePos.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        auto& slot = m_slots[position & m_mask];
+        const auto sequence = slot.sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+
+        if (difference == 0)
+        {
+            if (m_enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                slot.event = std::move(aEvent);
+                slot.sequence.store(position + 1, std::memory_order_release);
+                m_pushed.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+
+            if (!m_overflowed.exchange(true, std::memory_order_relaxed))
+            {
+                m_overflows.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            return false;
+        }
+        else
+        {
+            position = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+uint32_t App::WorldNodeEventRing::Drain(Core::Vector<WorldNodeInstanceEvent>& aEvents, uint32_t aMaxEvents)
+{
+    uint32_t drained = 0;
+    auto position = m_dequeuePos.load(std::memory_order_relaxed);
+
+    while (drained < aMaxEvents)
+    {
+        auto& slot = m_slots[position & m_mask];
+        const auto sequence = slot.sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(position + 1);
+
+        if (difference == 0)
+        {
+            if (m_dequeuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                aEvents.push_back(std::move(slot.event));
+                slot.event = {};
+                slot.sequence.store(position + m_mask + 1, std::memory_order_release);
+                ++position;
+                ++drained;
+            }
+        }
+        else if (difference < 0)
+        {
+            break;
+        }
+        else
+        {
+            position = m_dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    m_drained.fetch_add(drained, std::memory_order_relaxed);
+
+    return drained;
+}
+
+bool App::WorldNodeEventRing::ConsumeOverflow()
+{
+    return m_overflowed.exchange(false, std::memory_order_acq_rel);
+}
+
+App::WorldNodeEventRingStats App::WorldNodeEventRing::GetStats() const
+{
+    WorldNodeEventRingStats stats{};
+    stats.capacity = static_cast<uint32_t>(m_slots.size());
+    stats.pushed = m_pushed.load(std::memory_order_relaxed);
+    stats.drained = m_drained.load(std::memory_order_relaxed);
+    stats.dropped = m_dropped.load(std::memory_order_relaxed);
+    stats.overflows = m_overflows.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+uint32_t App::WorldNodeEventRing::GetSlotCount(uint32_t aCapacity)
+{
+    uint32_t slotCount = 2;
+
+    while (slotCount < aCapacity && slotCount < (1u << 31))
+    {
+        slotCount <<= 1;
+    }
+
+    return slotCount;
+}
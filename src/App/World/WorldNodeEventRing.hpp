@@ -0,0 +1,63 @@
+#pragma once
+
+namespace App
+{
+enum class WorldNodeInstanceEventType : uint8_t
+{
+    StreamedIn,
+    StreamedOut,
+};
+
+// The instance is only an identity, it can be destroyed by the time the event is drained,
+// so the consumer resolves it through the registry and never dereferences it.
+struct WorldNodeInstanceEvent
+{
+    WorldNodeInstanceEventType type;
+    Red::worldINodeInstance* nodeInstance;
+};
+
+struct WorldNodeEventRingStats
+{
+    uint32_t capacity{0};
+    uint64_t pushed{0};
+    uint64_t drained{0};
+    uint64_t dropped{0};
+    uint64_t overflows{0};
+};
+
+// Bounded multi-producer queue of node events.
+// Producers never block, events that don't fit into the ring are dropped and the ring is marked as overflowed,
+// so the consumer knows it has to resynchronize its state.
+class WorldNodeEventRing
+{
+public:
+    static constexpr uint32_t DefaultCapacity = 1u << 16;
+
+    explicit WorldNodeEventRing(uint32_t aCapacity = DefaultCapacity);
+
+    bool Push(WorldNodeInstanceEvent&& aEvent);
+    uint32_t Drain(Core::Vector<WorldNodeInstanceEvent>& aEvents, uint32_t aMaxEvents = 0xFFFFFFFF);
+    bool ConsumeOverflow();
+
+    [[nodiscard]] WorldNodeEventRingStats GetStats() const;
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence{0};
+        WorldNodeInstanceEvent event{};
+    };
+
+    static uint32_t GetSlotCount(uint32_t aCapacity);
+
+    Core::Vector<Slot> m_slots;
+    uint64_t m_mask;
+    alignas(64) std::atomic<uint64_t> m_enqueuePos{0};
+    alignas(64) std::atomic<uint64_t> m_dequeuePos{0};
+    alignas(64) std::atomic<uint64_t> m_pushed{0};
+    std::atomic<uint64_t> m_drained{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<uint64_t> m_overflows{0};
+    std::atomic<bool> m_overflowed{false};
+};
+}
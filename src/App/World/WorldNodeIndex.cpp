@@ -0,0 +1,261 @@
+#include "WorldNodeIndex.hpp"
+
+namespace
+{
+using Header = App::WorldNodeIndexFormat::Header;
+using Record = App::WorldNodeIndexFormat::Record;
+}
+
+void App::WorldNodeIndex::Open(const std::filesystem::path& aPath)
+{
+    {
+        std::unique_lock _(m_lock);
+        m_path = aPath;
+
+        if (std::filesystem::exists(m_path) && Repair())
+        {
+            Map();
+        }
+    }
+
+    DropKnownRecords();
+
+    m_open = true;
+
+    Flush();
+}
+
+bool App::WorldNodeIndex::IsOpen() const
+{
+    return m_open;
+}
+
+bool App::WorldNodeIndex::Find(uint64_t aNodeID, WorldNodeIndexRecord& aRecord)
+{
+    std::shared_lock _(m_lock);
+
+    if (!m_records)
+        return false;
+
+    auto record = WorldNodeIndexFormat::FindRecord(m_records, m_sortedCount, m_recordCount, aNodeID);
+
+    if (!record)
+        return false;
+
+    aRecord = *record;
+    return true;
+}
+
+bool App::WorldNodeIndex::HasSector(uint64_t aSectorHash, uint64_t aSectorStamp, uint64_t aNodeID)
+{
+    // All records of a sector are written at once with the same stamp, so any node of the sector will do
+    WorldNodeIndexRecord record{};
+    return Find(aNodeID, record) && record.sectorHash == aSectorHash && record.sectorStamp == aSectorStamp;
+}
+
+void App::WorldNodeIndex::Append(Core::Vector<WorldNodeIndexRecord>& aRecords)
+{
+    std::unique_lock _(m_pendingLock);
+    m_pendingRecords.insert(m_pendingRecords.end(), aRecords.begin(), aRecords.end());
+}
+
+void App::WorldNodeIndex::Flush()
+{
+    if (!m_open)
+        return;
+
+    std::unique_lock _(m_pendingLock);
+
+    if (m_pendingRecords.empty() || m_path.empty())
+        return;
+
+    // After a failed write the file can end with a partial record, anything appended after it would be misaligned.
+    // The file is mapped and can't be truncated now, the partial record is dropped the next time it's opened.
+    if (m_writeFailed)
+    {
+        m_pendingRecords.clear();
+        return;
+    }
+
+    std::error_code error;
+    auto fileSize = std::filesystem::file_size(m_path, error);
+
+    if (!error && fileSize > sizeof(Header) && (fileSize - sizeof(Header)) % sizeof(Record) != 0)
+    {
+        m_writeFailed = true;
+        m_pendingRecords.clear();
+        return;
+    }
+
+    std::ofstream file(m_path, std::ios::binary | std::ios::app);
+
+    if (error || fileSize < sizeof(Header))
+    {
+        const auto header = WorldNodeIndexFormat::MakeHeader(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    file.write(reinterpret_cast<const char*>(m_pendingRecords.data()),
+               static_cast<std::streamsize>(m_pendingRecords.size() * sizeof(Record)));
+    file.flush();
+
+    if (file)
+    {
+        m_writtenCount += m_pendingRecords.size();
+    }
+    else
+    {
+        m_writeFailed = true;
+    }
+
+    m_pendingRecords.clear();
+}
+
+App::WorldNodeIndexStats App::WorldNodeIndex::GetStats()
+{
+    WorldNodeIndexStats stats{};
+    {
+        std::shared_lock _(m_lock);
+        stats.sortedRecords = m_sortedCount;
+        stats.appendedRecords = m_recordCount - m_sortedCount;
+    }
+    {
+        std::unique_lock _(m_pendingLock);
+        stats.pendingRecords = m_pendingRecords.size();
+        stats.writtenRecords = m_writtenCount;
+    }
+
+    return stats;
+}
+
+bool App::WorldNodeIndex::Repair()
+{
+    std::error_code error;
+    const auto fileSize = std::filesystem::file_size(m_path, error);
+
+    if (error)
+        return false;
+
+    Header header{};
+    {
+        std::ifstream file(m_path, std::ios::binary);
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+        // The file is written by an incompatible version or is damaged, a new one will be started
+        if (!file || !WorldNodeIndexFormat::IsValidHeader(header, fileSize))
+        {
+            file.close();
+            std::filesystem::remove(m_path, error);
+            return false;
+        }
+    }
+
+    const auto recordCount = WorldNodeIndexFormat::GetRecordCount(fileSize);
+    const auto recordsSize = sizeof(Header) + recordCount * sizeof(Record);
+
+    // A session that ended in the middle of a flush leaves a partial record at the end
+    if (fileSize != recordsSize)
+    {
+        std::filesystem::resize_file(m_path, recordsSize, error);
+
+        if (error)
+            return false;
+    }
+
+    if (recordCount - header.sortedCount > MaxAppendedRecords)
+        return Compact();
+
+    return true;
+}
+
+bool App::WorldNodeIndex::Compact()
+{
+    std::error_code error;
+    const auto fileSize = std::filesystem::file_size(m_path, error);
+
+    if (error)
+        return false;
+
+    const auto recordCount = WorldNodeIndexFormat::GetRecordCount(fileSize);
+
+    Core::Vector<Record> records(recordCount);
+    {
+        std::ifstream file(m_path, std::ios::binary);
+        file.seekg(sizeof(Header));
+        file.read(reinterpret_cast<char*>(records.data()), static_cast<std::streamsize>(recordCount * sizeof(Record)));
+
+        if (!file)
+            return false;
+    }
+
+    WorldNodeIndexFormat::CompactRecords(records);
+
+    auto tempPath = m_path;
+    tempPath += L".tmp";
+
+    {
+        std::ofstream tempFile(tempPath, std::ios::binary | std::ios::trunc);
+
+        const auto header = WorldNodeIndexFormat::MakeHeader(records.size());
+        tempFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        tempFile.write(reinterpret_cast<const char*>(records.data()),
+                       static_cast<std::streamsize>(records.size() * sizeof(Record)));
+
+        if (!tempFile)
+            return false;
+    }
+
+    std::filesystem::rename(tempPath, m_path, error);
+
+    return !error;
+}
+
+bool App::WorldNodeIndex::Map()
+{
+    m_file.reset(CreateFileW(m_path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                             nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
+
+    if (!m_file)
+        return false;
+
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(m_file.get(), &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(Header)))
+        return false;
+
+    m_mapping.reset(CreateFileMappingW(m_file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr));
+
+    if (!m_mapping)
+        return false;
+
+    m_view.reset(MapViewOfFile(m_mapping.get(), FILE_MAP_READ, 0, 0, 0));
+
+    if (!m_view)
+        return false;
+
+    const auto header = reinterpret_cast<const Header*>(m_view.get());
+
+    if (!WorldNodeIndexFormat::IsValidHeader(*header, fileSize.QuadPart))
+    {
+        m_view.reset();
+        return false;
+    }
+
+    m_records = reinterpret_cast<const Record*>(header + 1);
+    m_sortedCount = header->sortedCount;
+    m_recordCount = WorldNodeIndexFormat::GetRecordCount(fileSize.QuadPart);
+
+    return true;
+}
+
+void App::WorldNodeIndex::DropKnownRecords()
+{
+    std::unique_lock _(m_pendingLock);
+
+    // The sectors loaded while the index was opened couldn't be checked against it
+    std::erase_if(m_pendingRecords,
+                  [this](const WorldNodeIndexRecord& aRecord)
+                  {
+                      WorldNodeIndexRecord record{};
+                      return Find(aRecord.nodeID, record) && std::memcmp(&record, &aRecord, sizeof(record)) == 0;
+                  });
+}
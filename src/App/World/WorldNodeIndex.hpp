@@ -0,0 +1,61 @@
+#pragma once
+
+#include "App/World/WorldNodeIndexFormat.hpp"
+
+#include <wil/resource.h>
+
+namespace App
+{
+using WorldNodeIndexRecord = WorldNodeIndexFormat::Record;
+
+struct WorldNodeIndexStats
+{
+    uint64_t sortedRecords{0};
+    uint64_t appendedRecords{0};
+    uint64_t pendingRecords{0};
+    uint64_t writtenRecords{0};
+};
+
+// Persistent index of all nodes ever streamed, used to resolve the nodes of sectors that aren't loaded.
+// The file is memory mapped as is and new records are only appended. Appended records are searched linearly,
+// so the index is only compacted when it's opened with too many of them, support/nodeindex can compact it offline.
+// Records appended before the index is opened are queued, the ones already in the index are dropped when it opens.
+class WorldNodeIndex
+{
+public:
+    static constexpr auto MaxAppendedRecords = 8192u;
+
+    WorldNodeIndex() = default;
+
+    void Open(const std::filesystem::path& aPath);
+    [[nodiscard]] bool IsOpen() const;
+
+    bool Find(uint64_t aNodeID, WorldNodeIndexRecord& aRecord);
+    bool HasSector(uint64_t aSectorHash, uint64_t aSectorStamp, uint64_t aNodeID);
+
+    void Append(Core::Vector<WorldNodeIndexRecord>& aRecords);
+    void Flush();
+
+    WorldNodeIndexStats GetStats();
+
+private:
+    bool Repair();
+    bool Compact();
+    bool Map();
+    void DropKnownRecords();
+
+    std::shared_mutex m_lock;
+    std::filesystem::path m_path;
+    wil::unique_hfile m_file;
+    wil::unique_handle m_mapping;
+    wil::unique_mapview_ptr<void> m_view;
+    const WorldNodeIndexRecord* m_records{nullptr};
+    uint64_t m_sortedCount{0};
+    uint64_t m_recordCount{0};
+    uint64_t m_writtenCount{0};
+    std::mutex m_pendingLock;
+    Core::Vector<WorldNodeIndexRecord> m_pendingRecords;
+    bool m_writeFailed{false};
+    std::atomic<bool> m_open{false};
+};
+}
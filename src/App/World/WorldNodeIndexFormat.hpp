@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+// Binary layout of the persistent node index.
+// The file starts with a header followed by fixed size records, the first part of the records is sorted by node ID,
+// the rest are records appended in the later sessions until the file is compacted again.
+// This header has no engine dependencies, so it can be shared with the standalone tools.
+namespace App::WorldNodeIndexFormat
+{
+static_assert(std::endian::native == std::endian::little, "The index is stored in little endian");
+
+constexpr uint32_t Magic = 0x494E4852; // RHNI
+constexpr uint32_t Version = 2;
+
+struct Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t reserved;
+    uint64_t sortedCount;
+};
+static_assert(sizeof(Header) == 24);
+
+// Every record carries the stamp of its sector, so a sector whose content changed after a patch or mod update
+// no longer matches its records and is indexed again.
+struct Record
+{
+    uint64_t nodeID;
+    uint64_t sectorHash;
+    uint64_t sectorStamp;
+    uint64_t nodeType;
+    uint64_t parentID;
+    int32_t instanceIndex;
+    uint32_t instanceCount;
+    int32_t nodeIndex;
+    uint32_t nodeCount;
+};
+static_assert(sizeof(Record) == 56);
+
+inline Header MakeHeader(uint64_t aSortedCount)
+{
+    return {Magic, Version, sizeof(Record), 0, aSortedCount};
+}
+
+inline uint64_t GetRecordCount(uint64_t aFileSize)
+{
+    return aFileSize > sizeof(Header) ? (aFileSize - sizeof(Header)) / sizeof(Record) : 0;
+}
+
+inline bool IsValidHeader(const Header& aHeader, uint64_t aFileSize)
+{
+    return aFileSize >= sizeof(Header) && aHeader.magic == Magic && aHeader.version == Version &&
+           aHeader.recordSize == sizeof(Record) && aHeader.sortedCount <= GetRecordCount(aFileSize);
+}
+
+inline uint64_t MixStamp(uint64_t aStamp, uint64_t aValue)
+{
+    auto value = aStamp ^ (aValue + 0x9E3779B97F4A7C15);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+    return value ^ (value >> 31);
+}
+
+// Fingerprint of the indexed content of a sector, the records are summed up so the order doesn't matter.
+template<typename TRecords>
+inline uint64_t MakeSectorStamp(const TRecords& aRecords)
+{
+    uint64_t stamp = 0;
+
+    for (const auto& record : aRecords)
+    {
+        auto recordStamp = MixStamp(0, record.nodeID);
+        recordStamp = MixStamp(recordStamp, record.nodeType);
+        recordStamp = MixStamp(recordStamp, record.parentID);
+        recordStamp = MixStamp(recordStamp, (static_cast<uint64_t>(static_cast<uint32_t>(record.instanceIndex)) << 32) |
+                                                record.instanceCount);
+        recordStamp = MixStamp(recordStamp, (static_cast<uint64_t>(static_cast<uint32_t>(record.nodeIndex)) << 32) |
+                                                record.nodeCount);
+        stamp += recordStamp;
+    }
+
+    return stamp;
+}
+
+inline bool IsOrdered(const Record& a, const Record& b)
+{
+    return a.nodeID < b.nodeID;
+}
+
+inline const Record* FindRecord(const Record* aRecords, uint64_t aSortedCount, uint64_t aRecordCount,
+                                uint64_t aNodeID)
+{
+    // Appended records are newer, so they take precedence over the sorted ones
+    for (auto record = aRecords + aRecordCount; record != aRecords + aSortedCount;)
+    {
+        if ((--record)->nodeID == aNodeID)
+            return record;
+    }
+
+    auto sortedEnd = aRecords + aSortedCount;
+    auto record = std::lower_bound(aRecords, sortedEnd, aNodeID,
+                                   [](const Record& aRecord, uint64_t aValue)
+                                   {
+                                       return aRecord.nodeID < aValue;
+                                   });
+
+    if (record == sortedEnd || record->nodeID != aNodeID)
+        return nullptr;
+
+    return record;
+}
+
+// Sorts the records by node ID and keeps only the last record of every node.
+template<typename TRecords>
+inline void CompactRecords(TRecords& aRecords)
+{
+    std::stable_sort(aRecords.begin(), aRecords.end(), &IsOrdered);
+
+    auto last = aRecords.begin();
+    for (auto record = aRecords.begin(); record != aRecords.end(); ++record)
+    {
+        auto next = record + 1;
+        if (next == aRecords.end() || next->nodeID != record->nodeID)
+        {
+            *last++ = *record;
+        }
+    }
+
+    aRecords.erase(last, aRecords.end());
+}
+}
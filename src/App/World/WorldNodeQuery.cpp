@@ -0,0 +1,158 @@
+#include "WorldNodeQuery.hpp"
+
+#include <bit>
+#include <cstring>
+#include <emmintrin.h>
+
+namespace
+{
+constexpr auto FieldSeparator = '\n';
+
+// Compares the first and the last character of the term with 16 positions at once,
+// only the positions where both match are compared in full.
+size_t FindTerm(std::string_view aText, std::string_view aTerm, size_t aOffset = 0)
+{
+    const auto termSize = aTerm.size();
+
+    if (termSize < 2 || aText.size() < aOffset + termSize)
+        return aText.find(aTerm, aOffset);
+
+    const auto first = _mm_set1_epi8(aTerm.front());
+    const auto last = _mm_set1_epi8(aTerm.back());
+    const auto* text = aText.data();
+
+    auto position = aOffset;
+
+    for (; position + 16 + termSize - 1 <= aText.size(); position += 16)
+    {
+        const auto firstBlock = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + position));
+        const auto lastBlock = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + position + termSize - 1));
+        auto candidates = static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, firstBlock), _mm_cmpeq_epi8(last, lastBlock))));
+
+        while (candidates)
+        {
+            const auto candidate = position + std::countr_zero(candidates);
+
+            if (std::memcmp(text + candidate + 1, aTerm.data() + 1, termSize - 2) == 0)
+                return candidate;
+
+            candidates &= candidates - 1;
+        }
+    }
+
+    return aText.find(aTerm, position);
+}
+
+bool IsEmptyValue(std::string_view aValue)
+{
+    return aValue.empty() || aValue == "0" || aValue == "NONE";
+}
+}
+
+void App::WorldNodeQueryRecord::SetExactField(std::string_view aValue)
+{
+    exactField = WorldNodeQuery::Normalize(aValue);
+}
+
+void App::WorldNodeQueryRecord::AddPartialField(std::string_view aValue)
+{
+    auto value = WorldNodeQuery::Normalize(aValue);
+
+    if (!IsEmptyValue(value))
+    {
+        partialFields.append(value);
+        partialFields.push_back(FieldSeparator);
+    }
+}
+
+App::WorldNodeQuery::WorldNodeQuery(float aMaxDistance, Red::CName aGroup, std::string_view aTerm)
+    : m_maxDistance(aMaxDistance)
+    , m_group(aGroup)
+    , m_term(Normalize(aTerm))
+{
+    // Line breaks separate the fields of a record, the term can't span several fields
+    std::replace(m_term.begin(), m_term.end(), FieldSeparator, ' ');
+
+    for (size_t wordEnd = 0; wordEnd < m_term.size();)
+    {
+        const auto wordStart = m_term.find_first_not_of(" \t", wordEnd);
+
+        if (wordStart == std::string::npos)
+            break;
+
+        wordEnd = std::min(m_term.find_first_of(" \t", wordStart), m_term.size());
+        m_words.emplace_back(m_term.substr(wordStart, wordEnd - wordStart));
+    }
+
+    // A single word is already covered by the whole term
+    if (m_words.size() < 2)
+    {
+        m_words.clear();
+    }
+}
+
+bool App::WorldNodeQuery::Matches(const WorldNodeQueryRecord& aRecord, float aDistance) const
+{
+    if (m_maxDistance > 0 && aDistance > m_maxDistance)
+        return false;
+
+    if (m_group && aRecord.nodeGroup != m_group)
+        return false;
+
+    if (m_term.empty())
+        return true;
+
+    if (!IsEmptyValue(aRecord.exactField) && aRecord.exactField == m_term)
+        return true;
+
+    if (FindTerm(aRecord.partialFields, m_term) != std::string_view::npos)
+        return true;
+
+    // Words that aren't found in order across all fields can't be found within a single field either
+    if (m_words.empty() || !MatchesWords(aRecord.partialFields))
+        return false;
+
+    std::string_view fields(aRecord.partialFields);
+
+    for (size_t fieldStart = 0; fieldStart < fields.size();)
+    {
+        const auto fieldEnd = fields.find(FieldSeparator, fieldStart);
+
+        if (MatchesWords(fields.substr(fieldStart, fieldEnd - fieldStart)))
+            return true;
+
+        fieldStart = fieldEnd + 1;
+    }
+
+    return false;
+}
+
+std::string App::WorldNodeQuery::Normalize(std::string_view aValue)
+{
+    std::string normalized(aValue);
+
+    for (auto& c : normalized)
+    {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+
+    return normalized;
+}
+
+bool App::WorldNodeQuery::MatchesWords(std::string_view aValue) const
+{
+    size_t position = 0;
+
+    for (const auto& word : m_words)
+    {
+        position = FindTerm(aValue, word, position);
+
+        if (position == std::string_view::npos)
+            return false;
+
+        position += word.size();
+    }
+
+    return true;
+}
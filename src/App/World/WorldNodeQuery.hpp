@@ -0,0 +1,37 @@
+#pragma once
+
+namespace App
+{
+// Searchable fields of a node, resolved and normalized once when the node is scanned.
+// Partial fields are joined with line breaks, so the whole term is found with a single search.
+struct WorldNodeQueryRecord
+{
+    Red::CName nodeGroup;
+    std::string exactField;
+    std::string partialFields;
+
+    void SetExactField(std::string_view aValue);
+    void AddPartialField(std::string_view aValue);
+};
+
+// Filter compiled from the scanner inputs.
+// A partial field matches when it contains the whole term or all words of the term in the same order,
+// an exact field matches only the whole term. Empty distance, group or term don't filter anything.
+class WorldNodeQuery
+{
+public:
+    WorldNodeQuery(float aMaxDistance, Red::CName aGroup, std::string_view aTerm);
+
+    [[nodiscard]] bool Matches(const WorldNodeQueryRecord& aRecord, float aDistance) const;
+
+    static std::string Normalize(std::string_view aValue);
+
+private:
+    [[nodiscard]] bool MatchesWords(std::string_view aValue) const;
+
+    float m_maxDistance;
+    Red::CName m_group;
+    std::string m_term;
+    Core::Vector<std::string> m_words;
+};
+}
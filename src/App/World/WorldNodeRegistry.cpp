@@ -1,4 +1,26 @@
 #include "WorldNodeRegistry.hpp"
+#include "App/Archives/ArchiveLoader.hpp"
+#include "App/World/WorldStreamingProfiler.hpp"
+#include "App/World/WorldTraceRecorder.hpp"
+
+namespace
+{
+struct NodeRefUpdate
+{
+    Red::NodeRef nodeRef;
+    uint32_t row;
+    bool replace;
+};
+
+// Rough size of a hopscotch map entry with its neighborhood bitmap
+template<typename K, typename V>
+constexpr auto MapEntrySize = sizeof(K) + sizeof(V) + sizeof(uint64_t);
+}
+
+App::WorldNodeRegistry::WorldNodeRegistry(const std::filesystem::path& aNodeIndexPath)
+{
+    s_nodeIndexPath = aNodeIndexPath;
+}
 
 void App::WorldNodeRegistry::OnBootstrap()
 {
@@ -7,184 +29,739 @@ void App::WorldNodeRegistry::OnBootstrap()
     HookAfter<Raw::WorldNodeInstance::Initialize>(&OnNodeInstanceInitialize);
     HookAfter<Raw::WorldNodeInstance::Attach>(&OnNodeInstanceAttach);
     HookBefore<Raw::WorldNodeInstance::Detach>(&OnNodeInstanceDetach);
+
+    if (!s_nodeIndexPath.empty())
+    {
+        s_nodeIndexThread = std::thread([]() {
+            s_nodeIndex.Open(s_nodeIndexPath);
+
+            const auto indexStats = s_nodeIndex.GetStats();
+            LogInfo("WorldNodeRegistry: Loaded index of {} nodes.", indexStats.sortedRecords);
+        });
+    }
+}
+
+void App::WorldNodeRegistry::OnShutdown()
+{
+    // The index can still be repaired or compacted, it must be done with the file before it's destroyed
+    if (s_nodeIndexThread.joinable())
+    {
+        s_nodeIndexThread.join();
+    }
 }
 
 void App::WorldNodeRegistry::OnStreamingSectorLoad(Red::worldStreamingSector* aSector, uint64_t)
 {
-    std::scoped_lock _(s_nodeStaticDataLock, s_nodeInstanceDataLock);
+    if (WorldStreamingProfiler::IsProfiling())
+    {
+        WorldStreamingProfiler::RecordSectorLoad(aSector->path.hash, WorldStreamingProfiler::GetTimestamp());
+    }
+
     auto& buffer = Raw::StreamingSector::NodeBuffer::Ref(aSector);
     auto instanceCount = static_cast<uint32_t>(buffer.nodeSetups.end() - buffer.nodeSetups.begin());
     auto nodeCount = buffer.nodes.size;
-    auto sectorHash = aSector->path.hash;
 
-    for (auto& nodeRef : buffer.nodeRefs)
+    auto pendingSector = Core::MakeUnique<PendingSector>();
+    pendingSector->sector = aSector;
+    pendingSector->setupsBegin = buffer.nodeSetups.begin();
+    pendingSector->setupsEnd = buffer.nodeSetups.end();
+    pendingSector->sectorHash = aSector->path.hash;
+    pendingSector->sectorGeneration = ++s_sectorGeneration;
+    pendingSector->resourceGeneration = ArchiveLoader::GetResourceGeneration();
+    pendingSector->staticBlock = s_staticStore.FindBlock(pendingSector->sectorHash, instanceCount, nodeCount,
+                                                         pendingSector->resourceGeneration);
+    pendingSector->ingesting = false;
+
+    if (WorldTraceRecorder::IsRecording())
+    {
+        RecordSectorLoad(aSector);
+    }
+
+    // Debug names share the memory with the refs restored below, so they must be taken before the ingestion
+    if (!pendingSector->staticBlock)
     {
-        auto& nodeRefData = s_nodeRefToStaticDataMap[nodeRef];
-        if (!nodeRefData.sectorHash)
+        pendingSector->debugNames.resize(nodeCount);
+        for (uint32_t nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex)
         {
-            nodeRefData.sectorHash = sectorHash;
+            auto& node = buffer.nodes[nodeIndex];
+            if (node->ref.instance != node.instance && node->ref.refCount != node.refCount)
+            {
+                pendingSector->debugNames[nodeIndex] = std::move(*reinterpret_cast<Red::CString*>(&node->ref));
+            }
         }
     }
 
-    for (auto& nodeSetup : buffer.nodeSetups)
+    for (auto& node : buffer.nodes)
     {
-        auto* nodeDefinition = buffer.nodes[nodeSetup.nodeIndex].instance;
+        node->ref.instance = node.instance;
+        node->ref.refCount = node.refCount;
+    }
 
-        auto& nodeData = s_nodeSetupToStaticDataMap[&nodeSetup];
-        nodeData.sectorHash = sectorHash;
-        nodeData.instanceIndex = static_cast<int32_t>(&nodeSetup - buffer.nodeSetups.begin());
-        nodeData.instanceCount = instanceCount;
-        nodeData.nodeIndex = nodeSetup.nodeIndex;
-        nodeData.nodeCount = nodeCount;
-        nodeData.nodeType = nodeDefinition->GetType()->GetName();
-        nodeData.nodeID = nodeSetup.globalNodeID;
+    bool scheduleIngestion;
+    {
+        std::unique_lock _(s_pendingSectorsLock);
+        s_pendingSectors.emplace_back(std::move(pendingSector));
+        scheduleIngestion = !s_ingestionScheduled;
+        s_ingestionScheduled = true;
+    }
+
+    if (scheduleIngestion)
+    {
+        Red::JobQueue().Dispatch([] { IngestPendingSectors(); });
+    }
+}
 
-        if (nodeDefinition->ref.instance != buffer.nodes[nodeSetup.nodeIndex].instance &&
-            nodeDefinition->ref.refCount != buffer.nodes[nodeSetup.nodeIndex].refCount)
+void App::WorldNodeRegistry::IngestPendingSectors()
+{
+    while (true)
+    {
+        std::unique_lock ingestionLock(s_ingestionLock);
+        Core::Vector<PendingSector*> batch;
         {
-            nodeData.debugName = *reinterpret_cast<Red::CString*>(&nodeDefinition->ref);
+            std::unique_lock _(s_pendingSectorsLock);
+
+            if (s_pendingSectors.empty())
+            {
+                s_ingestionScheduled = false;
+                return;
+            }
+
+            for (auto& pendingSector : s_pendingSectors)
+            {
+                if (batch.size() == MaxIngestionBatch)
+                    break;
+
+                pendingSector->ingesting = true;
+                batch.push_back(pendingSector.get());
+            }
         }
 
-        if (nodeData.nodeID)
+#ifndef NDEBUG
+        const auto ingestionStart = std::chrono::steady_clock::now();
+#endif
+
+        auto generation = ++s_generation;
+
+        for (auto pendingSector : batch)
         {
-            s_nodeRefToStaticDataMap[nodeData.nodeID] = nodeData;
+            IngestSector(*pendingSector, generation);
         }
 
-        if (auto communityNode = Red::Cast<Red::worldCompiledCommunityAreaNode>(nodeDefinition))
         {
-            nodeData.nodeID = communityNode->sourceObjectId.hash;
-            s_nodeRefToStaticDataMap[nodeData.nodeID] = nodeData;
+            std::unique_lock pendingLock(s_pendingSectorsLock);
+            {
+                auto _ = LockUnique(s_sectorRangeLock);
+
+                for (auto pendingSector : batch)
+                {
+                    if (auto& sectorNodes = pendingSector->sectorNodes)
+                    {
+                        // The instances initialized while the sector was being ingested
+                        for (const auto& [nodeSetup, nodeInstance] : pendingSector->initializedNodes)
+                        {
+                            sectorNodes->nodeInstances[nodeSetup - sectorNodes->setupsBegin] = nodeInstance;
+                        }
+
+                        auto setupsEnd = sectorNodes->setupsEnd;
+                        s_sectorNodes[setupsEnd] = std::move(sectorNodes);
+                    }
+                }
+
+                s_staticStore.CommitGeneration(generation);
+                PublishSnapshot();
+            }
+
+            s_pendingSectors.erase(s_pendingSectors.begin(), s_pendingSectors.begin() + batch.size());
         }
-        else if (auto communityRegistryNode = Red::Cast<Red::worldCommunityRegistryNode>(nodeDefinition))
+
+        s_nodeIndex.Flush();
+
+#ifndef NDEBUG
+        const std::chrono::duration<double, std::milli> ingestionDuration =
+            std::chrono::steady_clock::now() - ingestionStart;
+        Core::Log::Debug("IngestPendingSectors generation={} sectors={} time={:.3f}ms", generation, batch.size(),
+                         ingestionDuration.count());
+#endif
+    }
+}
+
+void App::WorldNodeRegistry::IngestSector(PendingSector& aPendingSector, uint32_t aGeneration)
+{
+    auto& buffer = Raw::StreamingSector::NodeBuffer::Ref(aPendingSector.sector);
+    auto instanceCount = static_cast<uint32_t>(aPendingSector.setupsEnd - aPendingSector.setupsBegin);
+    auto nodeCount = buffer.nodes.size;
+    auto sectorHash = aPendingSector.sectorHash;
+
+    if (!aPendingSector.staticBlock)
+    {
+        aPendingSector.staticBlock = s_staticStore.FindBlock(sectorHash, instanceCount, nodeCount,
+                                                             aPendingSector.resourceGeneration);
+    }
+
+    // The static data only depends on the sector resource,
+    // so it's collected once and reused when the same sector is streamed again until the archives are reloaded
+    if (!aPendingSector.staticBlock)
+    {
+        Core::Vector<uint64_t> nodeSourceIDs;
+        Core::Vector<NodeRefUpdate> nodeRefUpdates;
+        Core::Vector<WorldCommunityStaticData> communityUpdates;
+        Core::Vector<WorldCommunityEntryStaticData> communityEntryUpdates;
+
+        nodeSourceIDs.resize(nodeCount);
+        nodeRefUpdates.reserve(buffer.nodeRefs.size + instanceCount);
+
+        auto block = s_staticStore.CreateBlock(sectorHash, instanceCount, nodeCount, aPendingSector.resourceGeneration);
+        block->generation = aGeneration;
+
+        for (uint32_t nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex)
+        {
+            auto* nodeDefinition = buffer.nodes[nodeIndex].instance;
+
+            block->nodeTypes[nodeIndex] = nodeDefinition->GetType()->GetName();
+
+            if (auto communityNode = Red::Cast<Red::worldCompiledCommunityAreaNode>(nodeDefinition))
+            {
+                nodeSourceIDs[nodeIndex] = communityNode->sourceObjectId.hash;
+            }
+            else if (auto communityRegistryNode = Red::Cast<Red::worldCommunityRegistryNode>(nodeDefinition))
+            {
+                const auto registryIndex = static_cast<int32_t>(nodeIndex);
+                const auto communityCount = communityRegistryNode->communitiesData.size;
+                for (auto communityIndex = 0; communityIndex < communityCount; ++communityIndex)
+                {
+                    const auto& communityItem = communityRegistryNode->communitiesData[communityIndex];
+                    const auto communityId = communityItem.communityId.entityId;
+
+                    communityUpdates.push_back({sectorHash, registryIndex, communityIndex, communityCount, communityId});
+
+                    const auto entryCount = communityItem.entriesInitialState.size;
+                    for (auto entryIndex = 0; entryIndex < entryCount; ++entryIndex)
+                    {
+                        const auto& entryState = communityItem.entriesInitialState[entryIndex];
+
+                        communityEntryUpdates.push_back({communityId.hash, entryState.entryName, entryIndex, entryCount,
+                                                         entryState.initialPhaseName});
+                    }
+                }
+            }
+            else if (auto proxyMeshNode = Red::Cast<Red::worldEntityProxyMeshNode>(nodeDefinition))
+            {
+                block->parentIDs[nodeIndex] = proxyMeshNode->ownerGlobalId.hash;
+            }
+        }
+
+        for (auto& nodeSetup : buffer.nodeSetups)
+        {
+            auto instanceIndex = &nodeSetup - buffer.nodeSetups.begin();
+            auto nodeSourceID = nodeSourceIDs[nodeSetup.nodeIndex];
+
+            block->nodeIndexes[instanceIndex] = nodeSetup.nodeIndex;
+            block->nodeIDs[instanceIndex] = nodeSourceID ? nodeSourceID : nodeSetup.globalNodeID;
+        }
+
+        auto supersededRow = WorldNodeStaticStore::InvalidRow;
+        auto staticBlock = s_staticStore.PublishBlock(std::move(block), aPendingSector.debugNames, supersededRow);
+        aPendingSector.debugNames.clear();
+
+        if (!staticBlock)
+            return;
+
+        aPendingSector.staticBlock = staticBlock;
+
+        for (auto& nodeRef : buffer.nodeRefs)
         {
-            const auto& registryIndex = nodeData.nodeIndex;
-            const auto communityCount = communityRegistryNode->communitiesData.size;
-            for (auto communityIndex = 0; communityIndex < communityCount; ++communityIndex)
+            nodeRefUpdates.push_back({nodeRef, WorldNodeStaticStore::SectorRowFlag | staticBlock->blockIndex, false});
+        }
+
+        for (auto& nodeSetup : buffer.nodeSetups)
+        {
+            auto row = staticBlock->baseRow + static_cast<uint32_t>(&nodeSetup - buffer.nodeSetups.begin());
+
+            if (nodeSetup.globalNodeID)
             {
-                const auto& communityItem = communityRegistryNode->communitiesData[communityIndex];
-                const auto communityId = communityItem.communityId.entityId;
+                nodeRefUpdates.push_back({nodeSetup.globalNodeID, row, true});
+            }
 
-                s_communityStaticDataMap[communityId] = {sectorHash, registryIndex,
-                                                         communityIndex, communityCount, communityId};
+            if (auto nodeSourceID = nodeSourceIDs[nodeSetup.nodeIndex])
+            {
+                nodeRefUpdates.push_back({nodeSourceID, row, true});
             }
         }
-        else if (auto proxyMeshNode = Red::Cast<Red::worldEntityProxyMeshNode>(nodeDefinition))
+
+        // Sectors known from the previous sessions are skipped, unless their content changed since then
+        const auto& firstNodeUpdate = std::find_if(nodeRefUpdates.begin(), nodeRefUpdates.end(),
+                                                   [](const NodeRefUpdate& aUpdate) { return aUpdate.replace; });
+
+        if (firstNodeUpdate != nodeRefUpdates.end())
         {
-            nodeData.parentID = proxyMeshNode->ownerGlobalId.hash;
+            Core::Vector<WorldNodeIndexRecord> indexRecords;
+            indexRecords.reserve(nodeRefUpdates.end() - firstNodeUpdate);
+
+            for (auto update = firstNodeUpdate; update != nodeRefUpdates.end(); ++update)
+            {
+                const auto instanceIndex = static_cast<int32_t>(update->row - staticBlock->baseRow);
+                const auto view = WorldNodeStaticDataView{staticBlock, instanceIndex};
+
+                indexRecords.push_back({update->nodeRef.hash, sectorHash, 0, view.GetNodeType().hash,
+                                        view.GetParentID(), instanceIndex, instanceCount, view.GetNodeIndex(),
+                                        nodeCount});
+            }
+
+            const auto sectorStamp = WorldNodeIndexFormat::MakeSectorStamp(indexRecords);
+
+            if (!s_nodeIndex.HasSector(sectorHash, sectorStamp, firstNodeUpdate->nodeRef.hash))
+            {
+                for (auto& indexRecord : indexRecords)
+                {
+                    indexRecord.sectorStamp = sectorStamp;
+                }
+
+                s_nodeIndex.Append(indexRecords);
+            }
         }
 
-        s_nodeSetupToRuntimeDataMap[&nodeSetup] = {&nodeSetup, {}, buffer.nodes[nodeSetup.nodeIndex]};
+        // Group the updates by shard, so that each shard is locked only once per sector,
+        // the stable sort keeps the original order of updates within the shard.
+        std::stable_sort(nodeRefUpdates.begin(), nodeRefUpdates.end(),
+                         [](const NodeRefUpdate& a, const NodeRefUpdate& b)
+                         {
+                             return GetShardIndex(a.nodeRef.hash) < GetShardIndex(b.nodeRef.hash);
+                         });
+
+        for (auto update = nodeRefUpdates.begin(); update != nodeRefUpdates.end();)
+        {
+            auto shardIndex = GetShardIndex(update->nodeRef.hash);
+            auto& nodeRefShard = s_nodeRefShards[shardIndex];
+            auto _ = LockUnique(nodeRefShard);
+
+            for (; update != nodeRefUpdates.end() && GetShardIndex(update->nodeRef.hash) == shardIndex; ++update)
+            {
+                if (update->replace)
+                {
+                    nodeRefShard.nodeRefToRowMap.insert_or_assign(update->nodeRef, update->row);
+                }
+                else
+                {
+                    // Refs to a sector stay with the first sector, unless it's the block replaced by this one
+                    const auto& [it, inserted] = nodeRefShard.nodeRefToRowMap.try_emplace(update->nodeRef, update->row);
+
+                    if (!inserted && it.value() == supersededRow)
+                    {
+                        it.value() = update->row;
+                    }
+                }
+            }
+        }
+
+        for (const auto& communityData : communityUpdates)
+        {
+            auto& nodeRefShard = GetNodeRefShard(communityData.communityID.hash);
+            auto _ = LockUnique(nodeRefShard);
+            nodeRefShard.communityStaticDataMap[communityData.communityID.hash] = communityData;
+        }
+
+        for (const auto& entryData : communityEntryUpdates)
+        {
+            auto& nodeRefShard = GetNodeRefShard(entryData.communityID);
+            auto _ = LockUnique(nodeRefShard);
+            nodeRefShard.communityEntryMap.insert_or_assign(
+                GetCommunityEntryKey(entryData.communityID, entryData.entryName), entryData);
+        }
     }
 
-    for (auto& node : buffer.nodes)
+    if (instanceCount > 0)
     {
-        node->ref.instance = node.instance;
-        node->ref.refCount = node.refCount;
+        auto sectorNodes = Core::MakeShared<SectorNodes>();
+        sectorNodes->setupsBegin = aPendingSector.setupsBegin;
+        sectorNodes->setupsEnd = aPendingSector.setupsEnd;
+        sectorNodes->sectorHash = sectorHash;
+        sectorNodes->sectorGeneration = aPendingSector.sectorGeneration;
+        sectorNodes->staticBlock = aPendingSector.staticBlock;
+        sectorNodes->nodeDefinitions.reserve(instanceCount);
+        sectorNodes->nodeInstances.resize(instanceCount);
+
+        for (auto nodeSetup = aPendingSector.setupsBegin; nodeSetup != aPendingSector.setupsEnd; ++nodeSetup)
+        {
+            sectorNodes->nodeDefinitions.emplace_back(buffer.nodes[nodeSetup->nodeIndex]);
+        }
+
+        aPendingSector.sectorNodes = std::move(sectorNodes);
     }
 }
 
-void App::WorldNodeRegistry::OnStreamingSectorDestruct(Red::worldStreamingSector* aSector)
+void App::WorldNodeRegistry::RecordSectorLoad(Red::worldStreamingSector* aSector)
 {
-    std::scoped_lock _(s_nodeStaticDataLock, s_nodeInstanceDataLock);
     auto& buffer = Raw::StreamingSector::NodeBuffer::Ref(aSector);
+    auto instanceCount = static_cast<uint32_t>(buffer.nodeSetups.end() - buffer.nodeSetups.begin());
+
+    Core::Vector<WorldTraceFormat::NodeSetup> traceSetups;
+    traceSetups.reserve(instanceCount);
 
-    size_t erased = 0;
     for (auto& nodeSetup : buffer.nodeSetups)
     {
-        if (auto nodeInstance = s_nodeSetupToRuntimeDataMap[&nodeSetup].nodeInstance.instance)
+        const auto& position = nodeSetup.transform.position;
+        const auto& orientation = nodeSetup.transform.orientation;
+        const auto& nodeDefinition = buffer.nodes[nodeSetup.nodeIndex];
+
+        traceSetups.push_back({reinterpret_cast<uint64_t>(&nodeSetup), nodeSetup.globalNodeID,
+                               nodeDefinition ? nodeDefinition->GetType()->GetName().hash : 0, nodeSetup.nodeIndex, 0,
+                               {position.X, position.Y, position.Z, position.W},
+                               {orientation.i, orientation.j, orientation.k, orientation.r},
+                               {nodeSetup.scale.X, nodeSetup.scale.Y, nodeSetup.scale.Z, 0.0f}});
+    }
+
+    WorldTraceRecorder::RecordSectorLoad({reinterpret_cast<uint64_t>(buffer.nodeSetups.end()), aSector->path.hash,
+                                          instanceCount, buffer.nodes.size},
+                                         traceSetups);
+}
+
+App::WorldNodeRegistry::PendingSector* App::WorldNodeRegistry::FindPendingSector(
+    Red::CompiledNodeInstanceSetupInfo* aNodeSetup)
+{
+    for (auto& pendingSector : s_pendingSectors)
+    {
+        if (pendingSector->setupsBegin <= aNodeSetup && aNodeSetup < pendingSector->setupsEnd)
+            return pendingSector.get();
+    }
+
+    return nullptr;
+}
+
+void App::WorldNodeRegistry::OnStreamingSectorDestruct(Red::worldStreamingSector* aSector)
+{
+#ifndef NDEBUG
+    const auto destructStart = std::chrono::steady_clock::now();
+#endif
+
+    auto& buffer = Raw::StreamingSector::NodeBuffer::Ref(aSector);
+
+    if (WorldTraceRecorder::IsRecording())
+    {
+        WorldTraceRecorder::RecordSectorUnload(reinterpret_cast<uint64_t>(buffer.nodeSetups.end()));
+    }
+
+    if (WorldStreamingProfiler::IsProfiling())
+    {
+        WorldStreamingProfiler::RecordSectorUnload(aSector->path.hash);
+    }
+
+    Core::Vector<Red::worldINodeInstance*> nodeInstances;
+    uint32_t sectorGeneration = 0;
+
+    {
+        std::unique_lock pendingLock(s_pendingSectorsLock);
+        const auto& it = std::find_if(s_pendingSectors.begin(), s_pendingSectors.end(),
+                                      [aSector](const auto& aPendingSector)
+                                      {
+                                          return aPendingSector->sector == aSector;
+                                      });
+
+        if (it != s_pendingSectors.end())
         {
-            const auto& currentNodeSetup = s_nodeInstanceToNodeSetupMap.find(nodeInstance);
-            if (currentNodeSetup != s_nodeInstanceToNodeSetupMap.end() && currentNodeSetup.value() == &nodeSetup)
+            if ((*it)->ingesting)
             {
-                s_nodeInstanceToNodeSetupMap.erase(currentNodeSetup);
+                // Wait for the current batch to be committed, so it can be cleaned up as usual
+                pendingLock.unlock();
+                std::unique_lock _(s_ingestionLock);
+            }
+            else
+            {
+                // The instances of a sector that was never ingested are only known to the pending sector
+                for (const auto& [nodeSetup, nodeInstance] : (*it)->initializedNodes)
+                {
+                    nodeInstances.push_back(nodeInstance.instance);
+                }
+
+                sectorGeneration = (*it)->sectorGeneration;
+                s_pendingSectors.erase(it);
             }
         }
+    }
 
-        erased += s_nodeSetupToStaticDataMap.erase(&nodeSetup);
-        s_nodeSetupToRuntimeDataMap.erase(&nodeSetup);
+    Core::SharedPtr<SectorNodes> sectorNodes;
+    {
+        auto _ = LockUnique(s_sectorRangeLock);
+        const auto& it = s_sectorNodes.find(buffer.nodeSetups.end());
+
+        if (it != s_sectorNodes.end() && it->second->setupsBegin == buffer.nodeSetups.begin())
+        {
+            sectorNodes = std::move(it->second);
+            s_sectorNodes.erase(it);
+            PublishSnapshot();
+        }
+    }
+
+    if (sectorNodes)
+    {
+        auto _ = LockShared(GetSectorShard(sectorNodes->sectorHash));
+
+        for (const auto& nodeInstance : sectorNodes->nodeInstances)
+        {
+            if (nodeInstance.instance)
+            {
+                nodeInstances.push_back(nodeInstance.instance);
+            }
+        }
+
+        sectorGeneration = sectorNodes->sectorGeneration;
+    }
+
+    EraseNodeInstances(nodeInstances, sectorGeneration);
+
+    const auto erased = sectorNodes ? sectorNodes->nodeDefinitions.size() : 0;
+    sectorNodes.reset();
+
+    if (IsNodeInstancesOverBudget())
+    {
+        EvictStaleNodeInstances();
     }
 
 #ifndef NDEBUG
-    LogInfo("WorldNodeRegistry: Cleaned up {} tracked nodes.", erased);
+    const std::chrono::duration<double, std::milli> destructDuration =
+        std::chrono::steady_clock::now() - destructStart;
+    Core::Log::Debug("OnStreamingSectorDestruct nodes={} time={:.3f}ms", erased, destructDuration.count());
+
+    const auto lockStats = GetLockStats();
+    LogInfo("WorldNodeRegistry: Cleaned up {} tracked nodes. "
+            "Lock contentions: sectors={}/{} refs={}/{} instances={}/{}.", erased,
+            lockStats.sectorContentions, lockStats.sectorLocks,
+            lockStats.nodeRefContentions, lockStats.nodeRefLocks,
+            lockStats.nodeInstanceContentions, lockStats.nodeInstanceLocks);
+
+    const auto memoryReport = GetMemoryReport();
+    LogInfo("WorldNodeRegistry: Static data of {} nodes and {} refs takes {} bytes ({:.1f} per node), "
+            "legacy layout would take {} bytes ({:.1f} per node).",
+            memoryReport.trackedNodes, memoryReport.trackedRefs,
+            memoryReport.storeBytes, memoryReport.storeBytesPerNode,
+            memoryReport.legacyBytes, memoryReport.legacyBytesPerNode);
 #endif
 }
 
 void App::WorldNodeRegistry::OnNodeInstanceInitialize(Red::worldINodeInstance* aNodeInstance,
                                                      Red::CompiledNodeInstanceSetupInfo* aNodeSetup, void*)
 {
-    std::unique_lock _(s_nodeInstanceDataLock);
-    s_nodeSetupToRuntimeDataMap[aNodeSetup].nodeInstance = Red::AsWeakHandle(aNodeInstance);
-    s_nodeInstanceToNodeSetupMap[aNodeInstance] = aNodeSetup;
+    const auto initializedAt = WorldStreamingProfiler::IsProfiling() ? WorldStreamingProfiler::GetTimestamp() : 0;
+
+    if (WorldTraceRecorder::IsRecording())
+    {
+        WorldTraceRecorder::RecordNodeInitialize(reinterpret_cast<uint64_t>(aNodeInstance),
+                                                 reinterpret_cast<uint64_t>(aNodeSetup));
+    }
+
+    uint64_t sectorHash = 0;
+    auto sectorGeneration = SetNodeInstance(aNodeSetup, aNodeInstance, sectorHash);
+
+    if (!sectorGeneration)
+    {
+        // The sector can still be waiting for ingestion, then the instance is assigned when the sector is committed
+        std::unique_lock _(s_pendingSectorsLock);
+
+        if (auto pendingSector = FindPendingSector(aNodeSetup))
+        {
+            pendingSector->initializedNodes.emplace_back(aNodeSetup, Red::AsWeakHandle(aNodeInstance));
+            sectorGeneration = pendingSector->sectorGeneration;
+            sectorHash = pendingSector->sectorHash;
+        }
+        else
+        {
+            sectorGeneration = SetNodeInstance(aNodeSetup, aNodeInstance, sectorHash);
+        }
+    }
+
+    {
+        auto& nodeInstanceShard = GetNodeInstanceShard(aNodeInstance);
+        auto _ = LockUnique(nodeInstanceShard);
+        const auto& [it, inserted] = nodeInstanceShard.nodeInstanceToNodeSetupMap.insert_or_assign(
+            aNodeInstance, NodeInstanceEntry{aNodeSetup, sectorGeneration});
+
+        if (inserted)
+        {
+            ++s_nodeInstanceCount;
+        }
+    }
+
+    if (initializedAt && aNodeSetup->node)
+    {
+        WorldStreamingProfiler::RecordNodeInitialize(aNodeInstance, aNodeSetup->node->GetType()->GetName(),
+                                                     sectorHash, initializedAt);
+    }
+}
+
+uint32_t App::WorldNodeRegistry::SetNodeInstance(Red::CompiledNodeInstanceSetupInfo* aNodeSetup,
+                                                 Red::worldINodeInstance* aNodeInstance, uint64_t& aSectorHash)
+{
+    auto rangeLock = LockShared(s_sectorRangeLock);
+    auto sectorNodes = FindSectorNodes(aNodeSetup);
+
+    if (!sectorNodes)
+        return 0;
+
+    aSectorHash = sectorNodes->sectorHash;
+
+    {
+        auto _ = LockUnique(GetSectorShard(sectorNodes->sectorHash));
+        sectorNodes->nodeInstances[aNodeSetup - sectorNodes->setupsBegin] = Red::AsWeakHandle(aNodeInstance);
+    }
+
+    return sectorNodes->sectorGeneration;
 }
 
 void App::WorldNodeRegistry::OnNodeInstanceAttach(Red::worldINodeInstance* aNodeInstance, void*)
 {
-    if (s_watchers.empty())
+    if (WorldStreamingProfiler::IsProfiling())
+    {
+        WorldStreamingProfiler::RecordNodeAttach(aNodeInstance, WorldStreamingProfiler::GetTimestamp());
+    }
+
+    if (WorldTraceRecorder::IsRecording())
+    {
+        WorldTraceRecorder::RecordNodeAttach(reinterpret_cast<uint64_t>(aNodeInstance));
+    }
+
+    auto watchers = s_watchers.load(std::memory_order_acquire);
+
+    if (!watchers || watchers->empty())
         return;
 
-    if (auto setupInfo = GetNodeSetupInfo(aNodeInstance))
+    for (const auto& watcher : *watchers)
     {
-        for (const auto& watcher : s_watchers)
-        {
-            watcher->OnNodeStreamedIn(reinterpret_cast<uint64_t>(setupInfo), setupInfo->node, aNodeInstance, setupInfo);
-        }
+        watcher->Push({WorldNodeInstanceEventType::StreamedIn, aNodeInstance});
     }
 }
 
 void App::WorldNodeRegistry::OnNodeInstanceDetach(Red::worldINodeInstance* aNodeInstance, void*)
 {
-    if (s_watchers.empty())
+    if (WorldStreamingProfiler::IsProfiling())
+    {
+        WorldStreamingProfiler::RecordNodeDetach(aNodeInstance);
+    }
+
+    if (WorldTraceRecorder::IsRecording())
+    {
+        WorldTraceRecorder::RecordNodeDetach(reinterpret_cast<uint64_t>(aNodeInstance));
+    }
+
+    auto watchers = s_watchers.load(std::memory_order_acquire);
+
+    if (!watchers || watchers->empty())
         return;
 
-    if (auto setupInfo = GetNodeSetupInfo(aNodeInstance))
+    for (const auto& watcher : *watchers)
     {
-        for (const auto& watcher : s_watchers)
-        {
-            watcher->OnNodeStreamedOut(reinterpret_cast<uint64_t>(setupInfo));
-        }
+        watcher->Push({WorldNodeInstanceEventType::StreamedOut, aNodeInstance});
     }
 }
 
-App::WorldNodeInstanceStaticData App::WorldNodeRegistry::GetNodeStaticData(Red::CompiledNodeInstanceSetupInfo* aNodeSetup)
+App::WorldNodeStaticDataView App::WorldNodeRegistry::FindNodeStaticData(Red::CompiledNodeInstanceSetupInfo* aNodeSetup)
 {
     if (!aNodeSetup)
         return {};
 
-    std::shared_lock _(s_nodeStaticDataLock);
-    const auto& it = s_nodeSetupToStaticDataMap.find(aNodeSetup);
+    // The sector holds its own block, which stays valid even after it's superseded in the store
+    auto _ = LockShared(s_sectorRangeLock);
+    auto sectorNodes = FindSectorNodes(aNodeSetup);
 
-    if (it == s_nodeSetupToStaticDataMap.end())
+    if (!sectorNodes)
         return {};
 
-    return it.value();
+    return {sectorNodes->staticBlock, static_cast<int32_t>(aNodeSetup - sectorNodes->setupsBegin)};
 }
 
-App::WorldNodeInstanceStaticData App::WorldNodeRegistry::GetNodeStaticData(Red::NodeRef aNodeRef)
+App::WorldNodeStaticDataView App::WorldNodeRegistry::FindNodeStaticData(Red::NodeRef aNodeRef)
 {
     if (!aNodeRef)
         return {};
 
-    std::shared_lock _(s_nodeStaticDataLock);
-    const auto& it = s_nodeRefToStaticDataMap.find(aNodeRef);
+    auto row = WorldNodeStaticStore::InvalidRow;
+    {
+        auto& nodeRefShard = GetNodeRefShard(aNodeRef);
+        auto _ = LockShared(nodeRefShard);
+        const auto& it = nodeRefShard.nodeRefToRowMap.find(aNodeRef);
 
-    if (it == s_nodeRefToStaticDataMap.end())
-        return {};
+        if (it == nodeRefShard.nodeRefToRowMap.end())
+            return {};
 
-    return it.value();
+        row = it.value();
+    }
+
+    return s_staticStore.GetView(row);
 }
 
-App::WorldNodeInstanceStaticData App::WorldNodeRegistry::GetNodeStaticData(const Red::WeakHandle<Red::worldINodeInstance>& aNode)
+App::WorldNodeStaticDataView App::WorldNodeRegistry::FindNodeStaticData(
+    const Red::WeakHandle<Red::worldINodeInstance>& aNode)
 {
     if (!aNode)
         return {};
 
-    std::shared_lock _(s_nodeInstanceDataLock);
-    const auto& it = s_nodeInstanceToNodeSetupMap.find(aNode.instance);
+    return FindNodeStaticData(GetNodeSetupInfo(aNode.instance));
+}
+
+App::WorldNodeInstanceStaticData App::WorldNodeRegistry::GetNodeStaticData(Red::NodeRef aNodeRef)
+{
+    if (auto view = FindNodeStaticData(aNodeRef))
+    {
+        auto nodeData = ToStaticData(view);
+
+        // The row of a community node is shared by its global ID and its source ID,
+        // the node is reported under the ID it was looked up with
+        if (view.HasNode())
+        {
+            nodeData.nodeID = aNodeRef.hash;
+        }
+
+        return nodeData;
+    }
 
-    if (it == s_nodeInstanceToNodeSetupMap.end())
+    // The sector of the node hasn't been streamed in this session
+    WorldNodeIndexRecord indexRecord{};
+    if (!aNodeRef || !s_nodeIndex.Find(aNodeRef.hash, indexRecord))
         return {};
 
-    return GetNodeStaticData(it.value());
+    WorldNodeInstanceStaticData nodeData{};
+    nodeData.sectorHash = indexRecord.sectorHash;
+    nodeData.instanceIndex = indexRecord.instanceIndex;
+    nodeData.instanceCount = indexRecord.instanceCount;
+    nodeData.nodeIndex = indexRecord.nodeIndex;
+    nodeData.nodeCount = indexRecord.nodeCount;
+    nodeData.nodeID = indexRecord.nodeID;
+    nodeData.parentID = indexRecord.parentID;
+    nodeData.nodeType = indexRecord.nodeType;
+
+    return nodeData;
+}
+
+App::WorldNodeInstanceStaticData App::WorldNodeRegistry::GetNodeStaticData(const Red::WeakHandle<Red::worldINodeInstance>& aNode)
+{
+    return ToStaticData(FindNodeStaticData(aNode));
+}
+
+App::WorldNodeInstanceStaticData App::WorldNodeRegistry::ToStaticData(const WorldNodeStaticDataView& aView)
+{
+    WorldNodeInstanceStaticData nodeData{};
+
+    if (!aView)
+        return nodeData;
+
+    nodeData.sectorHash = aView.GetSectorHash();
+
+    if (aView.HasNode())
+    {
+        nodeData.instanceIndex = aView.instanceIndex;
+        nodeData.instanceCount = aView.block->instanceCount;
+        nodeData.nodeIndex = aView.GetNodeIndex();
+        nodeData.nodeCount = aView.block->nodeCount;
+        nodeData.nodeID = aView.GetNodeID();
+        nodeData.parentID = aView.GetParentID();
+        nodeData.nodeType = aView.GetNodeType();
+
+        // Interned names are null terminated
+        if (auto debugName = aView.GetDebugName(); !debugName.empty())
+        {
+            nodeData.debugName = debugName.data();
+        }
+    }
+
+    return nodeData;
 }
 
 App::WorldNodeInstanceRuntimeData App::WorldNodeRegistry::GetNodeRuntimeData(Red::CompiledNodeInstanceSetupInfo* aNodeSetup)
@@ -192,13 +769,16 @@ App::WorldNodeInstanceRuntimeData App::WorldNodeRegistry::GetNodeRuntimeData(Red
     if (!aNodeSetup)
         return {};
 
-    std::shared_lock _(s_nodeInstanceDataLock);
-    const auto& it = s_nodeSetupToRuntimeDataMap.find(aNodeSetup);
+    auto rangeLock = LockShared(s_sectorRangeLock);
+    auto sectorNodes = FindSectorNodes(aNodeSetup);
 
-    if (it == s_nodeSetupToRuntimeDataMap.end())
+    if (!sectorNodes)
         return {};
 
-    return it.value();
+    const auto nodeIndex = aNodeSetup - sectorNodes->setupsBegin;
+
+    auto _ = LockShared(GetSectorShard(sectorNodes->sectorHash));
+    return {aNodeSetup, sectorNodes->nodeInstances[nodeIndex], sectorNodes->nodeDefinitions[nodeIndex]};
 }
 
 App::WorldNodeInstanceRuntimeData App::WorldNodeRegistry::GetNodeRuntimeData(
@@ -207,76 +787,235 @@ App::WorldNodeInstanceRuntimeData App::WorldNodeRegistry::GetNodeRuntimeData(
     if (!aNode)
         return {};
 
-    std::shared_lock _(s_nodeInstanceDataLock);
-    const auto& it = s_nodeInstanceToNodeSetupMap.find(aNode.instance);
+    return GetNodeRuntimeData(GetNodeSetupInfo(aNode.instance));
+}
+
+App::WorldNodeInstanceRuntimeData App::WorldNodeRegistry::ResolveNodeInstance(Red::worldINodeInstance* aNodeInstance)
+{
+    // The instance is only used as a key, since it can be destroyed already
+    auto nodeSetup = GetNodeSetupInfo(aNodeInstance);
 
-    if (it == s_nodeInstanceToNodeSetupMap.end())
+    if (!nodeSetup)
         return {};
 
-    return GetNodeRuntimeData(it.value());
+    auto nodeData = GetNodeRuntimeData(nodeSetup);
+
+    if (!nodeData.setup)
+    {
+        // The sector can still be waiting for ingestion, then the instance is only known to the pending sector
+        std::unique_lock _(s_pendingSectorsLock);
+
+        if (auto pendingSector = FindPendingSector(nodeSetup))
+        {
+            for (const auto& [initializedSetup, nodeInstance] : pendingSector->initializedNodes)
+            {
+                if (initializedSetup == nodeSetup)
+                {
+                    nodeData = {nodeSetup, nodeInstance, Red::AsWeakHandle(nodeSetup->node)};
+                }
+            }
+        }
+        else
+        {
+            nodeData = GetNodeRuntimeData(nodeSetup);
+        }
+    }
+
+    // The setup can be assigned to another instance in the meantime
+    if (nodeData.nodeInstance.instance != aNodeInstance)
+        return {};
+
+    return nodeData;
 }
 
 Red::CompiledNodeInstanceSetupInfo* App::WorldNodeRegistry::GetNodeSetupInfo(Red::worldINodeInstance* aNodeInstance)
 {
-    std::shared_lock _(s_nodeInstanceDataLock);
-    const auto& it = s_nodeInstanceToNodeSetupMap.find(aNodeInstance);
+    auto& nodeInstanceShard = GetNodeInstanceShard(aNodeInstance);
+    NodeInstanceEntry nodeInstanceEntry;
+    {
+        auto _ = LockShared(nodeInstanceShard);
+        const auto& it = nodeInstanceShard.nodeInstanceToNodeSetupMap.find(aNodeInstance);
 
-    if (it == s_nodeInstanceToNodeSetupMap.end())
-        return nullptr;
+        if (it == nodeInstanceShard.nodeInstanceToNodeSetupMap.end())
+            return nullptr;
 
-    return it.value();
+        nodeInstanceEntry = it.value();
+    }
+
+    // The entry is stale when its sector is gone or its setup now belongs to a sector loaded later
+    {
+        auto _ = LockShared(s_sectorRangeLock);
+        auto sectorNodes = FindSectorNodes(nodeInstanceEntry.setup);
+
+        if (sectorNodes && sectorNodes->sectorGeneration == nodeInstanceEntry.sectorGeneration)
+            return nodeInstanceEntry.setup;
+    }
+
+    // The sector can still be waiting for ingestion, the sectors are committed under the pending lock,
+    // so the loaded sectors are checked again while it's held
+    {
+        std::unique_lock pendingLock(s_pendingSectorsLock);
+        auto pendingSector = FindPendingSector(nodeInstanceEntry.setup);
+
+        if (pendingSector && pendingSector->sectorGeneration == nodeInstanceEntry.sectorGeneration)
+            return nodeInstanceEntry.setup;
+
+        auto _ = LockShared(s_sectorRangeLock);
+        auto sectorNodes = FindSectorNodes(nodeInstanceEntry.setup);
+
+        if (sectorNodes && sectorNodes->sectorGeneration == nodeInstanceEntry.sectorGeneration)
+            return nodeInstanceEntry.setup;
+    }
+
+    {
+        auto _ = LockUnique(nodeInstanceShard);
+        const auto& it = nodeInstanceShard.nodeInstanceToNodeSetupMap.find(aNodeInstance);
+
+        if (it != nodeInstanceShard.nodeInstanceToNodeSetupMap.end() &&
+            it.value().sectorGeneration == nodeInstanceEntry.sectorGeneration)
+        {
+            nodeInstanceShard.nodeInstanceToNodeSetupMap.erase(it);
+            --s_nodeInstanceCount;
+        }
+    }
+
+    return nullptr;
 }
 
 Core::Vector<App::WorldNodeInstanceRuntimeData> App::WorldNodeRegistry::GetAllStreamedNodes()
 {
+    auto snapshot = GetStreamedNodesSnapshot();
+
     Core::Vector<WorldNodeInstanceRuntimeData> nodes;
+    nodes.reserve(snapshot->nodeCount);
+
+    for (const auto& sector : snapshot->sectors)
     {
-        std::shared_lock _(s_nodeInstanceDataLock);
-        std::transform(s_nodeSetupToRuntimeDataMap.begin(), s_nodeSetupToRuntimeDataMap.end(),
-                       std::back_inserter(nodes), [](auto& v) { return v.second; });
+        const auto& sectorNodes = static_cast<const SectorNodes&>(*sector);
+        const auto nodeCount = sectorNodes.nodeDefinitions.size();
+
+        auto _ = LockShared(GetSectorShard(sectorNodes.sectorHash));
+        for (size_t nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex)
+        {
+            nodes.push_back({sectorNodes.setupsBegin + nodeIndex, sectorNodes.nodeInstances[nodeIndex],
+                             sectorNodes.nodeDefinitions[nodeIndex]});
+        }
     }
+
     return nodes;
 }
 
+Core::SharedPtr<const App::WorldStreamedNodesSnapshot> App::WorldNodeRegistry::GetStreamedNodesSnapshot()
+{
+    if (auto snapshot = s_snapshot.load(std::memory_order_acquire))
+        return snapshot;
+
+    static const Core::SharedPtr<const WorldStreamedNodesSnapshot> s_emptySnapshot =
+        Core::MakeShared<WorldStreamedNodesSnapshot>();
+    return s_emptySnapshot;
+}
+
 App::WorldCommunityStaticData App::WorldNodeRegistry::GetCommunityStaticData(uint64_t aCommunityID)
 {
     if (!aCommunityID)
         return {};
 
-    std::shared_lock _(s_nodeStaticDataLock);
-    const auto& it = s_communityStaticDataMap.find(aCommunityID);
+    auto& nodeRefShard = GetNodeRefShard(aCommunityID);
+    auto _ = LockShared(nodeRefShard);
+    const auto& it = nodeRefShard.communityStaticDataMap.find(aCommunityID);
 
-    if (it == s_communityStaticDataMap.end())
+    if (it == nodeRefShard.communityStaticDataMap.end())
         return {};
 
     return it.value();
 }
 
+App::WorldCommunityEntryStaticData App::WorldNodeRegistry::GetCommunityEntryStaticData(uint64_t aCommunityID,
+                                                                                       Red::CName aEntryName)
+{
+    if (!aCommunityID || !aEntryName.hash)
+        return {};
+
+    auto& nodeRefShard = GetNodeRefShard(aCommunityID);
+    auto _ = LockShared(nodeRefShard);
+    const auto& it = nodeRefShard.communityEntryMap.find(GetCommunityEntryKey(aCommunityID, aEntryName));
+
+    // The key is a hash of both values, so the stored values are compared to rule out collisions
+    if (it == nodeRefShard.communityEntryMap.end() || it->second.communityID != aCommunityID ||
+        it->second.entryName != aEntryName)
+        return {};
+
+    return it->second;
+}
+
+void App::WorldNodeRegistry::UpdateCommunityEntryStaticData(const WorldCommunityEntryStaticData& aEntryData)
+{
+    if (!aEntryData.communityID || !aEntryData.entryName.hash)
+        return;
+
+    auto& nodeRefShard = GetNodeRefShard(aEntryData.communityID);
+    auto _ = LockUnique(nodeRefShard);
+    nodeRefShard.communityEntryMap.insert_or_assign(GetCommunityEntryKey(aEntryData.communityID, aEntryData.entryName),
+                                                    aEntryData);
+}
+
 void App::WorldNodeRegistry::ClearRuntimeData()
 {
+    size_t cleared = 0;
     {
-        std::unique_lock _(s_nodeStaticDataLock);
-#ifndef NDEBUG
-        LogInfo("WorldNodeRegistry: Cleaned up {} tracked nodes.", s_nodeSetupToStaticDataMap.size());
-#endif
-        s_nodeSetupToStaticDataMap.clear();
-        s_communityStaticDataMap.clear();
+        auto _ = LockUnique(s_sectorRangeLock);
+
+        for (const auto& [setupsEnd, sectorNodes] : s_sectorNodes)
+        {
+            cleared += sectorNodes->nodeDefinitions.size();
+        }
+
+        s_sectorNodes.clear();
+        PublishSnapshot();
     }
+
+    for (auto& nodeInstanceShard : s_nodeInstanceShards)
     {
-        std::unique_lock _(s_nodeInstanceDataLock);
-        s_nodeSetupToRuntimeDataMap.clear();
-        s_nodeInstanceToNodeSetupMap.clear();
+        auto _ = LockUnique(nodeInstanceShard);
+        s_nodeInstanceCount -= nodeInstanceShard.nodeInstanceToNodeSetupMap.size();
+        nodeInstanceShard.nodeInstanceToNodeSetupMap.clear();
     }
+
+#ifndef NDEBUG
+    LogInfo("WorldNodeRegistry: Cleaned up {} tracked nodes.", cleared);
+#endif
 }
 
-void App::WorldNodeRegistry::RegisterWatcher(App::IWorldNodeInstanceWatcher* aWatcher)
+Core::SharedPtr<App::WorldNodeEventRing> App::WorldNodeRegistry::RegisterWatcher(uint32_t aCapacity)
 {
-    s_watchers.push_back(aWatcher);
+    auto watcher = Core::MakeShared<WorldNodeEventRing>(aCapacity);
+
+    std::unique_lock _(s_watchersLock);
+    auto watchers = Core::MakeShared<WatcherList>();
+
+    if (auto currentWatchers = s_watchers.load(std::memory_order_acquire))
+    {
+        *watchers = *currentWatchers;
+    }
+
+    watchers->push_back(watcher);
+    s_watchers.store(std::move(watchers), std::memory_order_release);
+
+    return watcher;
 }
 
-void App::WorldNodeRegistry::UnregisterWatcher(App::IWorldNodeInstanceWatcher* aWatcher)
+void App::WorldNodeRegistry::UnregisterWatcher(const Core::SharedPtr<WorldNodeEventRing>& aWatcher)
 {
-    s_watchers.erase(std::remove(s_watchers.begin(), s_watchers.end(), aWatcher), s_watchers.end());
+    std::unique_lock _(s_watchersLock);
+    auto watchers = Core::MakeShared<WatcherList>();
+
+    if (auto currentWatchers = s_watchers.load(std::memory_order_acquire))
+    {
+        *watchers = *currentWatchers;
+    }
+
+    watchers->erase(std::remove(watchers->begin(), watchers->end(), aWatcher), watchers->end());
+    s_watchers.store(std::move(watchers), std::memory_order_release);
 }
 
 Red::Handle<Red::worldINodeInstance> App::WorldNodeRegistry::FindStreamedNodeInstance(uint64_t aNodeID)
@@ -288,3 +1027,321 @@ Red::Handle<Red::worldINodeInstance> App::WorldNodeRegistry::FindStreamedNodeIns
 
     return nodeInstance;
 }
+
+App::WorldNodeRegistryLockStats App::WorldNodeRegistry::GetLockStats()
+{
+    WorldNodeRegistryLockStats stats{};
+
+    for (const auto& sectorShard : s_sectorShards)
+    {
+        stats.sectorLocks += sectorShard.locks.load(std::memory_order_relaxed);
+        stats.sectorContentions += sectorShard.contentions.load(std::memory_order_relaxed);
+    }
+
+    stats.sectorLocks += s_sectorRangeLock.locks.load(std::memory_order_relaxed);
+    stats.sectorContentions += s_sectorRangeLock.contentions.load(std::memory_order_relaxed);
+
+    for (const auto& nodeRefShard : s_nodeRefShards)
+    {
+        stats.nodeRefLocks += nodeRefShard.locks.load(std::memory_order_relaxed);
+        stats.nodeRefContentions += nodeRefShard.contentions.load(std::memory_order_relaxed);
+    }
+
+    for (const auto& nodeInstanceShard : s_nodeInstanceShards)
+    {
+        stats.nodeInstanceLocks += nodeInstanceShard.locks.load(std::memory_order_relaxed);
+        stats.nodeInstanceContentions += nodeInstanceShard.contentions.load(std::memory_order_relaxed);
+    }
+
+    return stats;
+}
+
+App::WorldNodeRegistryMemoryReport App::WorldNodeRegistry::GetMemoryReport()
+{
+    using LegacyStaticData = WorldNodeInstanceStaticData;
+
+    WorldNodeRegistryMemoryReport report{};
+
+    report.trackedNodes = GetStreamedNodesSnapshot()->nodeCount;
+
+    for (auto& nodeRefShard : s_nodeRefShards)
+    {
+        auto _ = LockShared(nodeRefShard);
+        report.trackedRefs += static_cast<uint32_t>(nodeRefShard.nodeRefToRowMap.size());
+    }
+
+    const auto storeStats = s_staticStore.GetStats();
+    report.staticRows = storeStats.rowCount;
+
+    // The legacy layout kept a full copy of the static data in both the setup map and the ref map,
+    // heap allocations of the debug names are not included in the estimate
+    report.legacyBytes = report.trackedNodes * MapEntrySize<Red::CompiledNodeInstanceSetupInfo*, LegacyStaticData> +
+                         report.trackedRefs * MapEntrySize<Red::NodeRef, LegacyStaticData>;
+
+    // The rows of the streamed nodes are computed from the setup offset and don't take any extra memory
+    report.storeBytes = report.trackedRefs * MapEntrySize<Red::NodeRef, uint32_t> +
+                        storeStats.columnBytes + storeStats.arenaBytes;
+
+    if (report.trackedNodes)
+    {
+        report.legacyBytesPerNode = static_cast<double>(report.legacyBytes) / report.trackedNodes;
+        report.storeBytesPerNode = static_cast<double>(report.storeBytes) / report.trackedNodes;
+    }
+
+    return report;
+}
+
+void App::WorldNodeRegistry::CollectMemoryUsage(Core::Vector<MemoryUsage>& aUsage)
+{
+    {
+        MemoryUsage usage{"WorldNodeRegistry.Sectors"};
+
+        auto _ = LockShared(s_sectorRangeLock);
+        usage.entries = s_sectorNodes.size();
+        usage.bytes = MemoryAccounting::GetBytes(s_sectorNodes);
+
+        for (const auto& [setupsEnd, sectorNodes] : s_sectorNodes)
+        {
+            usage.bytes += sizeof(SectorNodes) + MemoryAccounting::GetBytes(sectorNodes->nodeDefinitions) +
+                           MemoryAccounting::GetBytes(sectorNodes->nodeInstances);
+        }
+
+        aUsage.push_back(usage);
+    }
+
+    {
+        MemoryUsage usage{"WorldNodeRegistry.NodeRefs"};
+
+        for (auto& nodeRefShard : s_nodeRefShards)
+        {
+            auto _ = LockShared(nodeRefShard);
+            usage.entries += nodeRefShard.nodeRefToRowMap.size() + nodeRefShard.communityStaticDataMap.size() +
+                             nodeRefShard.communityEntryMap.size();
+            usage.bytes += MemoryAccounting::GetBytes(nodeRefShard.nodeRefToRowMap) +
+                           MemoryAccounting::GetBytes(nodeRefShard.communityStaticDataMap) +
+                           MemoryAccounting::GetBytes(nodeRefShard.communityEntryMap);
+        }
+
+        aUsage.push_back(usage);
+    }
+
+    aUsage.push_back(GetNodeInstancesUsage());
+
+    {
+        const auto storeStats = s_staticStore.GetStats();
+        aUsage.push_back({"WorldNodeRegistry.StaticStore", storeStats.rowCount,
+                          storeStats.columnBytes + storeStats.arenaBytes});
+    }
+}
+
+void App::WorldNodeRegistry::SetNodeInstancesBudget(uint64_t aBytes)
+{
+    s_nodeInstancesBudget = aBytes;
+    s_nodeInstanceEvictCount = 0;
+
+    if (IsNodeInstancesOverBudget())
+    {
+        EvictStaleNodeInstances();
+    }
+}
+
+App::MemoryUsage App::WorldNodeRegistry::GetNodeInstancesUsage()
+{
+    MemoryUsage usage{"WorldNodeRegistry.NodeInstances"};
+    usage.budget = s_nodeInstancesBudget;
+
+    for (auto& nodeInstanceShard : s_nodeInstanceShards)
+    {
+        auto _ = LockShared(nodeInstanceShard);
+        usage.entries += nodeInstanceShard.nodeInstanceToNodeSetupMap.size();
+        usage.bytes += MemoryAccounting::GetBytes(nodeInstanceShard.nodeInstanceToNodeSetupMap);
+    }
+
+    return usage;
+}
+
+bool App::WorldNodeRegistry::IsNodeInstancesOverBudget()
+{
+    const auto budget = s_nodeInstancesBudget.load(std::memory_order_relaxed);
+
+    if (!budget)
+        return false;
+
+    // Estimated from the running count, so the shards don't have to be locked on every unload.
+    // After an eviction the index has to grow by a quarter first, otherwise an index that is over budget
+    // because of live instances would be scanned on every unload.
+    const auto entrySize = MapEntrySize<Red::worldINodeInstance*, NodeInstanceEntry>;
+    const auto count = s_nodeInstanceCount.load(std::memory_order_relaxed);
+
+    return count * entrySize > budget && count >= s_nodeInstanceEvictCount.load(std::memory_order_relaxed);
+}
+
+void App::WorldNodeRegistry::EvictStaleNodeInstances()
+{
+    const auto usageBefore = GetNodeInstancesUsage();
+    uint32_t evicted = 0;
+
+    // Same order as the initialization hook, so the pending sectors can't be committed in the middle
+    std::unique_lock pendingLock(s_pendingSectorsLock);
+    auto rangeLock = LockShared(s_sectorRangeLock);
+
+    for (auto& nodeInstanceShard : s_nodeInstanceShards)
+    {
+        auto _ = LockUnique(nodeInstanceShard);
+        auto& nodeInstanceMap = nodeInstanceShard.nodeInstanceToNodeSetupMap;
+
+        // An entry is stale when its sector is gone or its setup belongs to a sector loaded later
+        for (auto it = nodeInstanceMap.begin(); it != nodeInstanceMap.end();)
+        {
+            const auto* sectorNodes = FindSectorNodes(it->second.setup);
+            const auto* pendingSector = sectorNodes ? nullptr : FindPendingSector(it->second.setup);
+            const auto stale = sectorNodes ? sectorNodes->sectorGeneration != it->second.sectorGeneration
+                                           : !pendingSector ||
+                                                 pendingSector->sectorGeneration != it->second.sectorGeneration;
+
+            if (stale)
+            {
+                it = nodeInstanceMap.erase(it);
+                --s_nodeInstanceCount;
+                ++evicted;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        nodeInstanceMap.rehash(0);
+    }
+
+    rangeLock.unlock();
+    pendingLock.unlock();
+
+    const auto count = s_nodeInstanceCount.load();
+    s_nodeInstanceEvictCount = count + count / 4;
+
+    const auto usageAfter = GetNodeInstancesUsage();
+    LogInfo("WorldNodeRegistry: Evicted {} stale node instances, {} -> {} bytes, budget {} bytes.", evicted,
+            usageBefore.bytes, usageAfter.bytes, usageAfter.budget);
+}
+
+void App::WorldNodeRegistry::EraseNodeInstances(Core::Vector<Red::worldINodeInstance*>& aNodeInstances,
+                                                uint32_t aSectorGeneration)
+{
+    if (aNodeInstances.empty())
+        return;
+
+    // Group the instances by shard, so that each shard is locked only once per sector
+    std::sort(aNodeInstances.begin(), aNodeInstances.end(),
+              [](Red::worldINodeInstance* a, Red::worldINodeInstance* b)
+              {
+                  return GetShardIndex(reinterpret_cast<uint64_t>(a)) < GetShardIndex(reinterpret_cast<uint64_t>(b));
+              });
+
+    for (auto nodeInstance = aNodeInstances.begin(); nodeInstance != aNodeInstances.end();)
+    {
+        auto shardIndex = GetShardIndex(reinterpret_cast<uint64_t>(*nodeInstance));
+        auto& nodeInstanceShard = s_nodeInstanceShards[shardIndex];
+        auto _ = LockUnique(nodeInstanceShard);
+        auto& nodeInstanceMap = nodeInstanceShard.nodeInstanceToNodeSetupMap;
+
+        for (; nodeInstance != aNodeInstances.end() &&
+               GetShardIndex(reinterpret_cast<uint64_t>(*nodeInstance)) == shardIndex;
+             ++nodeInstance)
+        {
+            // The instance can already be initialized again for a sector loaded later
+            const auto& it = nodeInstanceMap.find(*nodeInstance);
+
+            if (it != nodeInstanceMap.end() && it->second.sectorGeneration == aSectorGeneration)
+            {
+                nodeInstanceMap.erase(it);
+                --s_nodeInstanceCount;
+            }
+        }
+    }
+}
+
+std::shared_lock<std::shared_mutex> App::WorldNodeRegistry::LockShared(LockShard& aShard)
+{
+    std::shared_lock lock(aShard.mutex, std::try_to_lock);
+
+    if (!lock.owns_lock())
+    {
+        aShard.contentions.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+    }
+
+    aShard.locks.fetch_add(1, std::memory_order_relaxed);
+
+    return lock;
+}
+
+std::unique_lock<std::shared_mutex> App::WorldNodeRegistry::LockUnique(LockShard& aShard)
+{
+    std::unique_lock lock(aShard.mutex, std::try_to_lock);
+
+    if (!lock.owns_lock())
+    {
+        aShard.contentions.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+    }
+
+    aShard.locks.fetch_add(1, std::memory_order_relaxed);
+
+    return lock;
+}
+
+uint32_t App::WorldNodeRegistry::GetShardIndex(uint64_t aKey)
+{
+    return static_cast<uint32_t>((aKey * 0x9E3779B97F4A7C15ull) >> (64 - ShardBits));
+}
+
+uint64_t App::WorldNodeRegistry::GetCommunityEntryKey(uint64_t aCommunityID, Red::CName aEntryName)
+{
+    return aCommunityID ^ (aEntryName.hash * 0xC2B2AE3D27D4EB4Full + (aCommunityID << 6) + (aCommunityID >> 2));
+}
+
+App::WorldNodeRegistry::LockShard& App::WorldNodeRegistry::GetSectorShard(uint64_t aSectorHash)
+{
+    return s_sectorShards[GetShardIndex(aSectorHash)];
+}
+
+App::WorldNodeRegistry::SectorNodes* App::WorldNodeRegistry::FindSectorNodes(
+    Red::CompiledNodeInstanceSetupInfo* aNodeSetup)
+{
+    if (!aNodeSetup)
+        return nullptr;
+
+    const auto& it = s_sectorNodes.upper_bound(aNodeSetup);
+
+    if (it == s_sectorNodes.end() || it->second->setupsBegin > aNodeSetup)
+        return nullptr;
+
+    return it->second.get();
+}
+
+void App::WorldNodeRegistry::PublishSnapshot()
+{
+    auto snapshot = Core::MakeShared<WorldStreamedNodesSnapshot>();
+    snapshot->generation = ++s_snapshotGeneration;
+    snapshot->sectors.reserve(s_sectorNodes.size());
+
+    for (const auto& [setupsEnd, sectorNodes] : s_sectorNodes)
+    {
+        snapshot->sectors.emplace_back(sectorNodes);
+        snapshot->nodeCount += static_cast<uint32_t>(sectorNodes->nodeDefinitions.size());
+    }
+
+    s_snapshot.store(std::move(snapshot), std::memory_order_release);
+}
+
+App::WorldNodeRegistry::NodeRefShard& App::WorldNodeRegistry::GetNodeRefShard(uint64_t aNodeRef)
+{
+    return s_nodeRefShards[GetShardIndex(aNodeRef)];
+}
+
+App::WorldNodeRegistry::NodeInstanceShard& App::WorldNodeRegistry::GetNodeInstanceShard(
+    Red::worldINodeInstance* aNodeInstance)
+{
+    return s_nodeInstanceShards[GetShardIndex(reinterpret_cast<uint64_t>(aNodeInstance))];
+}
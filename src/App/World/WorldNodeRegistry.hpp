@@ -3,6 +3,10 @@
 #include "Core/Foundation/Feature.hpp"
 #include "Core/Hooking/HookingAgent.hpp"
 #include "Core/Logging/LoggingAgent.hpp"
+#include "App/World/WorldNodeEventRing.hpp"
+#include "App/World/WorldNodeIndex.hpp"
+#include "App/World/WorldNodeStaticStore.hpp"
+#include "App/Shared/MemoryUsage.hpp"
 #include "Red/StreamingSector.hpp"
 #include "Red/WorldNode.hpp"
 
@@ -30,6 +34,15 @@ struct WorldCommunityStaticData
     Red::EntityID communityID;
 };
 
+struct WorldCommunityEntryStaticData
+{
+    uint64_t communityID{0};
+    Red::CName entryName;
+    int32_t entryIndex{-1};
+    uint32_t entryCount{0};
+    Red::CName initialPhase;
+};
+
 struct WorldNodeInstanceRuntimeData
 {
     Red::CompiledNodeInstanceSetupInfo* setup{};
@@ -37,13 +50,46 @@ struct WorldNodeInstanceRuntimeData
     Red::WeakHandle<Red::worldNode> nodeDefinition;
 };
 
-struct IWorldNodeInstanceWatcher
+// Immutable part of the registry entries of a loaded sector,
+// the nodes are indexed by the offset of their setup from the beginning of the setup buffer.
+struct WorldStreamedSectorNodes
+{
+    Red::CompiledNodeInstanceSetupInfo* setupsBegin;
+    Red::CompiledNodeInstanceSetupInfo* setupsEnd;
+    uint64_t sectorHash;
+    uint32_t sectorGeneration;
+    Core::SharedPtr<const WorldNodeStaticBlock> staticBlock;
+    Core::Vector<Red::WeakHandle<Red::worldNode>> nodeDefinitions;
+};
+
+// Streamed sectors at the time of publication, a new snapshot is published whenever a sector is added or removed.
+// The snapshot is shared by all readers and released when the last reader drops it.
+struct WorldStreamedNodesSnapshot
+{
+    uint32_t generation{0};
+    uint32_t nodeCount{0};
+    Core::Vector<Core::SharedPtr<const WorldStreamedSectorNodes>> sectors;
+};
+
+struct WorldNodeRegistryLockStats
+{
+    uint64_t sectorLocks{0};
+    uint64_t sectorContentions{0};
+    uint64_t nodeRefLocks{0};
+    uint64_t nodeRefContentions{0};
+    uint64_t nodeInstanceLocks{0};
+    uint64_t nodeInstanceContentions{0};
+};
+
+struct WorldNodeRegistryMemoryReport
 {
-    virtual void OnNodeStreamedIn(uint64_t aNodeHash,
-                                  Red::worldNode* aNodeDefinition,
-                                  Red::worldINodeInstance* aNodeInstance,
-                                  Red::CompiledNodeInstanceSetupInfo* aNodeSetup) = 0;
-    virtual void OnNodeStreamedOut(uint64_t aNodeHash) = 0;
+    uint32_t trackedNodes{0};
+    uint32_t trackedRefs{0};
+    uint32_t staticRows{0};
+    size_t legacyBytes{0};
+    size_t storeBytes{0};
+    double legacyBytesPerNode{0};
+    double storeBytesPerNode{0};
 };
 
 class WorldNodeRegistry
@@ -52,20 +98,86 @@ class WorldNodeRegistry
     , public Core::HookingAgent
 {
 public:
+    WorldNodeRegistry(const std::filesystem::path& aNodeIndexPath = {});
+
+    WorldNodeStaticDataView FindNodeStaticData(Red::NodeRef aNodeRef);
+    WorldNodeStaticDataView FindNodeStaticData(const Red::WeakHandle<Red::worldINodeInstance>& aNode);
     WorldNodeInstanceStaticData GetNodeStaticData(Red::NodeRef aNodeRef);
     WorldNodeInstanceStaticData GetNodeStaticData(const Red::WeakHandle<Red::worldINodeInstance>& aNode);
     WorldNodeInstanceRuntimeData GetNodeRuntimeData(const Red::WeakHandle<Red::worldINodeInstance>& aNode);
+    WorldNodeInstanceRuntimeData ResolveNodeInstance(Red::worldINodeInstance* aNodeInstance);
     Core::Vector<WorldNodeInstanceRuntimeData> GetAllStreamedNodes();
+    Core::SharedPtr<const WorldStreamedNodesSnapshot> GetStreamedNodesSnapshot();
     WorldCommunityStaticData GetCommunityStaticData(uint64_t aCommunityID);
+    WorldCommunityEntryStaticData GetCommunityEntryStaticData(uint64_t aCommunityID, Red::CName aEntryName);
+    void UpdateCommunityEntryStaticData(const WorldCommunityEntryStaticData& aEntryData);
     void ClearRuntimeData();
 
-    void RegisterWatcher(IWorldNodeInstanceWatcher* aWatcher);
-    void UnregisterWatcher(IWorldNodeInstanceWatcher* aWatcher);
+    Core::SharedPtr<WorldNodeEventRing> RegisterWatcher(uint32_t aCapacity = WorldNodeEventRing::DefaultCapacity);
+    void UnregisterWatcher(const Core::SharedPtr<WorldNodeEventRing>& aWatcher);
 
     Red::Handle<Red::worldINodeInstance> FindStreamedNodeInstance(uint64_t aNodeID);
 
+    WorldNodeRegistryLockStats GetLockStats();
+    WorldNodeRegistryMemoryReport GetMemoryReport();
+    void CollectMemoryUsage(Core::Vector<MemoryUsage>& aUsage);
+    void SetNodeInstancesBudget(uint64_t aBytes);
+
 protected:
+    static constexpr auto ShardBits = 5u;
+    static constexpr auto ShardCount = 1u << ShardBits;
+
+    struct LockShard
+    {
+        std::shared_mutex mutex;
+        std::atomic<uint64_t> locks{0};
+        std::atomic<uint64_t> contentions{0};
+    };
+
+    struct NodeRefShard : LockShard
+    {
+        Core::Map<Red::NodeRef, uint32_t> nodeRefToRowMap;
+        Core::Map<uint64_t, WorldCommunityStaticData> communityStaticDataMap;
+        Core::Map<uint64_t, WorldCommunityEntryStaticData> communityEntryMap;
+    };
+
+    struct NodeInstanceEntry
+    {
+        Red::CompiledNodeInstanceSetupInfo* setup;
+        uint32_t sectorGeneration;
+    };
+
+    struct NodeInstanceShard : LockShard
+    {
+        Core::Map<Red::worldINodeInstance*, NodeInstanceEntry> nodeInstanceToNodeSetupMap;
+    };
+
+    // All registry entries of a loaded sector, so the whole sector is dropped at once on unload.
+    // The node instances are assigned after the sector is published and are guarded by the sector shard.
+    struct SectorNodes : WorldStreamedSectorNodes
+    {
+        Core::Vector<Red::WeakHandle<Red::worldINodeInstance>> nodeInstances;
+    };
+
+    struct PendingSector
+    {
+        Red::worldStreamingSector* sector;
+        Red::CompiledNodeInstanceSetupInfo* setupsBegin;
+        Red::CompiledNodeInstanceSetupInfo* setupsEnd;
+        uint64_t sectorHash;
+        uint32_t sectorGeneration;
+        uint32_t resourceGeneration;
+        Core::Vector<Red::CString> debugNames;
+        Core::Vector<std::pair<Red::CompiledNodeInstanceSetupInfo*, Red::WeakHandle<Red::worldINodeInstance>>> initializedNodes;
+        Core::SharedPtr<const WorldNodeStaticBlock> staticBlock;
+        Core::SharedPtr<SectorNodes> sectorNodes;
+        bool ingesting;
+    };
+
+    static constexpr auto MaxIngestionBatch = 64u;
+
     void OnBootstrap() override;
+    void OnShutdown() override;
 
     static void OnStreamingSectorLoad(Red::worldStreamingSector* aSector, uint64_t);
     static void OnStreamingSectorDestruct(Red::worldStreamingSector* aSector);
@@ -74,19 +186,78 @@ protected:
     static void OnNodeInstanceAttach(Red::worldINodeInstance* aNodeInstance, void*);
     static void OnNodeInstanceDetach(Red::worldINodeInstance* aNodeInstance, void*);
 
-    static WorldNodeInstanceStaticData GetNodeStaticData(Red::CompiledNodeInstanceSetupInfo* aNodeSetup);
+    static void IngestPendingSectors();
+    static void IngestSector(PendingSector& aPendingSector, uint32_t aGeneration);
+    static PendingSector* FindPendingSector(Red::CompiledNodeInstanceSetupInfo* aNodeSetup);
+    static void RecordSectorLoad(Red::worldStreamingSector* aSector);
+    static uint32_t SetNodeInstance(Red::CompiledNodeInstanceSetupInfo* aNodeSetup,
+                                    Red::worldINodeInstance* aNodeInstance, uint64_t& aSectorHash);
+
+    static WorldNodeStaticDataView FindNodeStaticData(Red::CompiledNodeInstanceSetupInfo* aNodeSetup);
+    static WorldNodeInstanceStaticData ToStaticData(const WorldNodeStaticDataView& aView);
     static WorldNodeInstanceRuntimeData GetNodeRuntimeData(Red::CompiledNodeInstanceSetupInfo* aNodeSetup);
     static Red::CompiledNodeInstanceSetupInfo* GetNodeSetupInfo(Red::worldINodeInstance* aNodeInstance);
 
-    inline static std::shared_mutex s_nodeStaticDataLock;
-    inline static std::shared_mutex s_nodeInstanceDataLock;
-    inline static Core::Map<Red::NodeRef, WorldNodeInstanceStaticData> s_nodeRefToStaticDataMap;
-    inline static Core::Map<Red::CompiledNodeInstanceSetupInfo*, WorldNodeInstanceStaticData> s_nodeSetupToStaticDataMap;
-    inline static Core::Map<Red::CompiledNodeInstanceSetupInfo*, WorldNodeInstanceRuntimeData> s_nodeSetupToRuntimeDataMap;
-    inline static Core::Map<Red::worldINodeInstance*, Red::CompiledNodeInstanceSetupInfo*> s_nodeInstanceToNodeSetupMap;
-    inline static Core::Map<uint64_t, WorldCommunityStaticData> s_communityStaticDataMap;
+    static std::shared_lock<std::shared_mutex> LockShared(LockShard& aShard);
+    static std::unique_lock<std::shared_mutex> LockUnique(LockShard& aShard);
+
+    static uint32_t GetShardIndex(uint64_t aKey);
+    static uint64_t GetCommunityEntryKey(uint64_t aCommunityID, Red::CName aEntryName);
+    static LockShard& GetSectorShard(uint64_t aSectorHash);
+    static SectorNodes* FindSectorNodes(Red::CompiledNodeInstanceSetupInfo* aNodeSetup);
+    static void PublishSnapshot();
+    static MemoryUsage GetNodeInstancesUsage();
+    static bool IsNodeInstancesOverBudget();
+    static void EvictStaleNodeInstances();
+    static void EraseNodeInstances(Core::Vector<Red::worldINodeInstance*>& aNodeInstances,
+                                   uint32_t aSectorGeneration);
+    static NodeRefShard& GetNodeRefShard(uint64_t aNodeRef);
+    static NodeInstanceShard& GetNodeInstanceShard(Red::worldINodeInstance* aNodeInstance);
+
+    // Loaded sectors are keyed by the end of the setup buffer and guarded by the range lock,
+    // the runtime data of the nodes is guarded by the sector shard of the sector hash.
+    // The reverse index of node instances is cleaned up on unload using the instances known to the sector,
+    // the entries are also validated by the sector generation on lookup, since an instance can be initialized
+    // for a sector that was never registered. When the index grows over its budget, the stale entries
+    // are evicted after a sector unload.
+    inline static std::array<LockShard, ShardCount> s_sectorShards;
+    inline static std::array<NodeRefShard, ShardCount> s_nodeRefShards;
+    inline static std::array<NodeInstanceShard, ShardCount> s_nodeInstanceShards;
+    inline static LockShard s_sectorRangeLock;
+    inline static Core::SortedMap<Red::CompiledNodeInstanceSetupInfo*, Core::SharedPtr<SectorNodes>> s_sectorNodes;
+    inline static std::atomic<uint32_t> s_sectorGeneration{0};
+    inline static std::atomic<uint64_t> s_nodeInstancesBudget{0};
+    inline static std::atomic<uint64_t> s_nodeInstanceCount{0};
+    inline static std::atomic<uint64_t> s_nodeInstanceEvictCount{0};
+
+    // Published under the range lock, read without any locks.
+    inline static std::atomic<Core::SharedPtr<const WorldStreamedNodesSnapshot>> s_snapshot;
+    inline static uint32_t s_snapshotGeneration{0};
+
+    // The ref maps hold row indices into the store, the rows of a block superseded after archives reload resolve
+    // to nothing. The sector nodes hold their block, so it stays alive until the sector is unloaded.
+    inline static WorldNodeStaticStore s_staticStore;
+
+    // Nodes of all sectors streamed in the previous sessions, new sectors are appended after each ingestion batch.
+    // The index is opened by a background thread, which is joined on shutdown.
+    inline static WorldNodeIndex s_nodeIndex;
+    inline static std::filesystem::path s_nodeIndexPath;
+    inline static std::thread s_nodeIndexThread;
+
+    // Loaded sectors are queued by the streaming hook and ingested in batches by a job,
+    // each batch becomes visible to the queries at once when its generation is committed.
+    inline static std::mutex s_pendingSectorsLock;
+    inline static Core::Vector<Core::UniquePtr<PendingSector>> s_pendingSectors;
+    inline static std::mutex s_ingestionLock;
+    inline static bool s_ingestionScheduled{false};
+    inline static uint32_t s_generation{0};
+
+    // Attach and detach events are pushed to the ring of every watcher, the list is replaced on registration,
+    // so the hooks only need to load it. The events only carry the instance, they're resolved by the watchers.
+    using WatcherList = Core::Vector<Core::SharedPtr<WorldNodeEventRing>>;
 
-    inline static Core::Vector<IWorldNodeInstanceWatcher*> s_watchers;
+    inline static std::mutex s_watchersLock;
+    inline static std::atomic<Core::SharedPtr<const WatcherList>> s_watchers;
 };
 }
 
@@ -0,0 +1,317 @@
+#include "WorldNodeSpatialIndex.hpp"
+#include "Red/Math.hpp"
+
+namespace
+{
+constexpr auto CoordBits = 20u;
+constexpr auto CoordMask = (1ull << CoordBits) - 1;
+constexpr auto DepthShift = CoordBits * 3;
+constexpr auto RootCell = 0ull;
+
+float GetCellSize(uint32_t aDepth)
+{
+    return (App::WorldNodeSpatialIndex::WorldExtent * 2.0f) / static_cast<float>(1u << aDepth);
+}
+
+uint32_t GetCellCoord(uint64_t aCell, uint32_t aAxis)
+{
+    return static_cast<uint32_t>((aCell >> (CoordBits * (2 - aAxis))) & CoordMask);
+}
+}
+
+App::WorldNodeSpatialIndex::WorldNodeSpatialIndex()
+{
+    Clear();
+}
+
+bool App::WorldNodeSpatialIndex::Insert(uint64_t aKey, const Red::Box& aBox)
+{
+    const auto replaced = Remove(aKey);
+    const auto cellKey = FindCell(aBox);
+
+    {
+        auto& cell = m_cells[cellKey];
+        m_locations[aKey] = {cellKey, static_cast<uint32_t>(cell.keys.size())};
+        cell.boxes.Push(aBox);
+        cell.keys.push_back(aKey);
+    }
+
+    // The map can rehash on every insertion, so the cells are looked up again on every step
+    for (auto cell = cellKey;; cell = GetParentCellKey(cell))
+    {
+        m_cells[cell].subtreeSize++;
+
+        if (GetCellDepth(cell) == 0)
+            break;
+
+        m_cells[GetParentCellKey(cell)].childMask |= static_cast<uint8_t>(1u << GetChildIndex(cell));
+    }
+
+    return !replaced;
+}
+
+bool App::WorldNodeSpatialIndex::Remove(uint64_t aKey)
+{
+    const auto& locationIt = m_locations.find(aKey);
+
+    if (locationIt == m_locations.end())
+        return false;
+
+    const auto location = locationIt->second;
+    m_locations.erase(locationIt);
+
+    {
+        auto& cell = m_cells.find(location.cell).value();
+        const auto lastIndex = static_cast<uint32_t>(cell.keys.size() - 1);
+
+        if (location.index != lastIndex)
+        {
+            cell.boxes.Set(location.index, cell.boxes.Get(lastIndex));
+            cell.keys[location.index] = cell.keys[lastIndex];
+            m_locations.find(cell.keys[location.index]).value().index = location.index;
+        }
+
+        cell.boxes.Pop();
+        cell.keys.pop_back();
+    }
+
+    for (auto cell = location.cell;; cell = GetParentCellKey(cell))
+    {
+        auto cellIt = m_cells.find(cell);
+        auto& subtreeSize = cellIt.value().subtreeSize;
+
+        if (--subtreeSize == 0 && GetCellDepth(cell) != 0)
+        {
+            m_cells.erase(cellIt);
+            auto& parentCell = m_cells.find(GetParentCellKey(cell)).value();
+            parentCell.childMask &= static_cast<uint8_t>(~(1u << GetChildIndex(cell)));
+        }
+
+        if (GetCellDepth(cell) == 0)
+            break;
+    }
+
+    return true;
+}
+
+void App::WorldNodeSpatialIndex::Clear()
+{
+    m_cells.clear();
+    m_locations.clear();
+    m_cells[RootCell] = {};
+}
+
+void App::WorldNodeSpatialIndex::Query(Red::Frustum& aFrustum, const Red::Vector4& aOrigin, float aMaxDistance,
+                                       WorldNodeSpatialQuery& aQuery, Core::Vector<uint64_t>& aResult) const
+{
+    Walk(&aFrustum, aOrigin, aMaxDistance, aQuery, aResult);
+}
+
+void App::WorldNodeSpatialIndex::Query(const Red::Vector4& aOrigin, float aMaxDistance,
+                                       WorldNodeSpatialQuery& aQuery, Core::Vector<uint64_t>& aResult) const
+{
+    Walk(nullptr, aOrigin, aMaxDistance, aQuery, aResult);
+}
+
+uint32_t App::WorldNodeSpatialIndex::GetSize() const
+{
+    return static_cast<uint32_t>(m_locations.size());
+}
+
+App::WorldNodeSpatialIndexStats App::WorldNodeSpatialIndex::GetStats(const WorldNodeSpatialQuery& aQuery) const
+{
+    return {static_cast<uint32_t>(m_locations.size()), static_cast<uint32_t>(m_cells.size()), aQuery.visitedCells,
+            aQuery.testedEntries, aQuery.planeTests};
+}
+
+void App::WorldNodeSpatialIndex::Walk(Red::Frustum* aFrustum, const Red::Vector4& aOrigin, float aMaxDistance,
+                                      WorldNodeSpatialQuery& aQuery, Core::Vector<uint64_t>& aResult) const
+{
+    const auto maxDistanceSquared = aMaxDistance * aMaxDistance;
+
+    aQuery.visitedCells = 0;
+    aQuery.testedEntries = 0;
+    aQuery.planeTests = 0;
+
+    // Hints of removed cells are never looked up again, they're dropped once they outnumber the live cells
+    if (aQuery.hints.size() > m_cells.size() * 2)
+    {
+        aQuery.hints.clear();
+    }
+
+    aQuery.stack.clear();
+    aQuery.stack.emplace_back(RootCell, false);
+
+    while (!aQuery.stack.empty())
+    {
+        auto [cellKey, inside] = aQuery.stack.back();
+        aQuery.stack.pop_back();
+
+        const auto& cellIt = m_cells.find(cellKey);
+
+        if (cellIt == m_cells.end())
+            continue;
+
+        const auto& cell = cellIt->second;
+        auto& hints = aQuery.hints[cellKey];
+
+        // The root also holds the entries outside of the world bounds, so it can't be culled
+        if (cellKey != RootCell)
+        {
+            alignas(16) const Red::Box bounds = GetLooseBounds(cellKey);
+
+            if (Red::DistanceSquared(aOrigin, bounds) > maxDistanceSquared)
+                continue;
+
+            if (aFrustum && !inside)
+            {
+                const auto result = aFrustum->Test(bounds, hints.frustumPlane, aQuery.planeTests);
+
+                if (result == Red::FrustumResult::Outside)
+                    continue;
+
+                // Everything in the subtree is inside as well, so the frustum tests can be skipped
+                inside = (result == Red::FrustumResult::Inside);
+            }
+        }
+
+        ++aQuery.visitedCells;
+
+        // Most cells hold only a few entries, for those the batch setup costs more than it saves
+        if (cell.keys.size() >= MinBatchSize)
+        {
+            const auto entryCount = cell.boxes.GetSize();
+            const auto testFrustum = aFrustum && !inside;
+
+            aQuery.distances.resize(entryCount);
+            Red::DistanceSquared(aOrigin, cell.boxes, aQuery.distances.data());
+
+            if (testFrustum)
+            {
+                aQuery.frustumResults.resize(entryCount);
+                Red::TestFrustum(*aFrustum, cell.boxes, aQuery.frustumResults.data());
+                aQuery.planeTests += entryCount * Red::Frustum::NumberOfPlanes;
+            }
+
+            for (uint32_t entryIndex = 0; entryIndex < entryCount; ++entryIndex)
+            {
+                if (aQuery.distances[entryIndex] > maxDistanceSquared)
+                    continue;
+
+                if (testFrustum && aQuery.frustumResults[entryIndex] == Red::FrustumResult::Outside)
+                    continue;
+
+                aResult.push_back(cell.keys[entryIndex]);
+            }
+
+            aQuery.testedEntries += entryCount;
+        }
+        else
+        {
+            hints.frustumPlanes.resize(cell.keys.size());
+
+            for (uint32_t entryIndex = 0; entryIndex < cell.keys.size(); ++entryIndex)
+            {
+                alignas(16) const Red::Box box = cell.boxes.Get(entryIndex);
+
+                ++aQuery.testedEntries;
+
+                if (Red::DistanceSquared(aOrigin, box) > maxDistanceSquared)
+                    continue;
+
+                if (aFrustum && !inside &&
+                    aFrustum->Test(box, hints.frustumPlanes[entryIndex], aQuery.planeTests) ==
+                        Red::FrustumResult::Outside)
+                    continue;
+
+                aResult.push_back(cell.keys[entryIndex]);
+            }
+        }
+
+        for (uint32_t child = 0; child < 8; ++child)
+        {
+            if (cell.childMask & (1u << child))
+            {
+                aQuery.stack.emplace_back(GetChildCellKey(cellKey, child), inside);
+            }
+        }
+    }
+}
+
+uint64_t App::WorldNodeSpatialIndex::MakeCellKey(uint32_t aDepth, uint32_t aX, uint32_t aY, uint32_t aZ)
+{
+    return (static_cast<uint64_t>(aDepth) << DepthShift) | (static_cast<uint64_t>(aX) << (CoordBits * 2)) |
+           (static_cast<uint64_t>(aY) << CoordBits) | static_cast<uint64_t>(aZ);
+}
+
+uint64_t App::WorldNodeSpatialIndex::GetParentCellKey(uint64_t aCell)
+{
+    return MakeCellKey(GetCellDepth(aCell) - 1, GetCellCoord(aCell, 0) >> 1, GetCellCoord(aCell, 1) >> 1,
+                       GetCellCoord(aCell, 2) >> 1);
+}
+
+uint64_t App::WorldNodeSpatialIndex::GetChildCellKey(uint64_t aCell, uint32_t aChild)
+{
+    return MakeCellKey(GetCellDepth(aCell) + 1, (GetCellCoord(aCell, 0) << 1) | (aChild & 1),
+                       (GetCellCoord(aCell, 1) << 1) | ((aChild >> 1) & 1),
+                       (GetCellCoord(aCell, 2) << 1) | ((aChild >> 2) & 1));
+}
+
+uint32_t App::WorldNodeSpatialIndex::GetChildIndex(uint64_t aCell)
+{
+    return (GetCellCoord(aCell, 0) & 1) | ((GetCellCoord(aCell, 1) & 1) << 1) | ((GetCellCoord(aCell, 2) & 1) << 2);
+}
+
+uint32_t App::WorldNodeSpatialIndex::GetCellDepth(uint64_t aCell)
+{
+    return static_cast<uint32_t>(aCell >> DepthShift);
+}
+
+uint64_t App::WorldNodeSpatialIndex::FindCell(const Red::Box& aBox)
+{
+    const float center[3] = {(aBox.Min.X + aBox.Max.X) * 0.5f, (aBox.Min.Y + aBox.Max.Y) * 0.5f,
+                             (aBox.Min.Z + aBox.Max.Z) * 0.5f};
+    const auto extent = std::max({aBox.Max.X - aBox.Min.X, aBox.Max.Y - aBox.Min.Y, aBox.Max.Z - aBox.Min.Z});
+
+    for (const auto& value : center)
+    {
+        if (!(value >= -WorldExtent && value < WorldExtent))
+            return RootCell;
+    }
+
+    uint32_t depth = 0;
+    while (depth < MaxDepth && GetCellSize(depth + 1) >= extent)
+    {
+        ++depth;
+    }
+
+    const auto cellSize = GetCellSize(depth);
+    const auto maxCoord = (1u << depth) - 1;
+
+    uint32_t coords[3];
+    for (auto axis = 0; axis < 3; ++axis)
+    {
+        const auto coord = static_cast<uint32_t>((center[axis] + WorldExtent) / cellSize);
+        coords[axis] = std::min(coord, maxCoord);
+    }
+
+    return MakeCellKey(depth, coords[0], coords[1], coords[2]);
+}
+
+Red::Box App::WorldNodeSpatialIndex::GetLooseBounds(uint64_t aCell)
+{
+    const auto cellSize = GetCellSize(GetCellDepth(aCell));
+    const auto halfSize = cellSize * 0.5f;
+
+    Red::Box bounds{};
+    bounds.Min.X = -WorldExtent + static_cast<float>(GetCellCoord(aCell, 0)) * cellSize - halfSize;
+    bounds.Min.Y = -WorldExtent + static_cast<float>(GetCellCoord(aCell, 1)) * cellSize - halfSize;
+    bounds.Min.Z = -WorldExtent + static_cast<float>(GetCellCoord(aCell, 2)) * cellSize - halfSize;
+    bounds.Min.W = 1.0f;
+    bounds.Max.X = bounds.Min.X + cellSize * 2.0f;
+    bounds.Max.Y = bounds.Min.Y + cellSize * 2.0f;
+    bounds.Max.Z = bounds.Min.Z + cellSize * 2.0f;
+    bounds.Max.W = 1.0f;
+
+    return bounds;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Red/BoxBatch.hpp"
+
+namespace App
+{
+struct WorldNodeSpatialIndexStats
+{
+    uint32_t entries{0};
+    uint32_t cells{0};
+    uint32_t visitedCells{0};
+    uint32_t testedEntries{0};
+    uint32_t planeTests{0};
+};
+
+// Scratch buffers and frustum plane hints of one caller.
+// The queries only read the index, so callers with their own query state can query it at the same time.
+// The hints only decide which plane is tested first, they're kept per cell and entry index
+// and simply go stale when the entries are moved around.
+struct WorldNodeSpatialQuery
+{
+    struct CellHints
+    {
+        uint8_t frustumPlane{0};
+        Core::Vector<uint8_t> frustumPlanes;
+    };
+
+    Core::Map<uint64_t, CellHints> hints;
+    Core::Vector<std::pair<uint64_t, bool>> stack;
+    Core::Vector<float> distances;
+    Core::Vector<Red::FrustumResult> frustumResults;
+    uint32_t visitedCells{0};
+    uint32_t testedEntries{0};
+    uint32_t planeTests{0};
+};
+
+// Loose octree of node bounds, updated incrementally as nodes are streamed in and out.
+// Every entry is stored in the deepest cell that is at least as large as the entry and contains its center,
+// the cells are extended by half of their size on each side, so entries never have to be split or moved up.
+// Entries outside of the world bounds are kept in the root, which is always visited.
+// Cells and entries remember the frustum plane that rejected them last in the query state of the caller,
+// the camera rarely moves far between queries.
+class WorldNodeSpatialIndex
+{
+public:
+    static constexpr auto MaxDepth = 10u;
+    static constexpr auto WorldExtent = 8192.0f;
+    static constexpr auto MinBatchSize = 4u;
+
+    WorldNodeSpatialIndex();
+
+    bool Insert(uint64_t aKey, const Red::Box& aBox);
+    bool Remove(uint64_t aKey);
+    void Clear();
+
+    // Collects keys of entries not outside of the frustum and not farther than the distance from the origin.
+    void Query(Red::Frustum& aFrustum, const Red::Vector4& aOrigin, float aMaxDistance,
+               WorldNodeSpatialQuery& aQuery, Core::Vector<uint64_t>& aResult) const;
+    void Query(const Red::Vector4& aOrigin, float aMaxDistance, WorldNodeSpatialQuery& aQuery,
+               Core::Vector<uint64_t>& aResult) const;
+
+    [[nodiscard]] uint32_t GetSize() const;
+    [[nodiscard]] WorldNodeSpatialIndexStats GetStats(const WorldNodeSpatialQuery& aQuery) const;
+
+private:
+    struct Cell
+    {
+        Red::BoxBatch boxes;
+        Core::Vector<uint64_t> keys;
+        uint32_t subtreeSize{0};
+        uint8_t childMask{0};
+    };
+
+    struct Location
+    {
+        uint64_t cell;
+        uint32_t index;
+    };
+
+    static uint64_t MakeCellKey(uint32_t aDepth, uint32_t aX, uint32_t aY, uint32_t aZ);
+    static uint64_t GetParentCellKey(uint64_t aCell);
+    static uint64_t GetChildCellKey(uint64_t aCell, uint32_t aChild);
+    static uint32_t GetChildIndex(uint64_t aCell);
+    static uint32_t GetCellDepth(uint64_t aCell);
+    static uint64_t FindCell(const Red::Box& aBox);
+    static Red::Box GetLooseBounds(uint64_t aCell);
+
+    void Walk(Red::Frustum* aFrustum, const Red::Vector4& aOrigin, float aMaxDistance,
+              WorldNodeSpatialQuery& aQuery, Core::Vector<uint64_t>& aResult) const;
+
+    Core::Map<uint64_t, Cell> m_cells;
+    Core::Map<uint64_t, Location> m_locations;
+};
+}
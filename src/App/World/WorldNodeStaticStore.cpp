@@ -0,0 +1,200 @@
+#include "WorldNodeStaticStore.hpp"
+
+Core::UniquePtr<App::WorldNodeStaticBlock> App::WorldNodeStaticStore::CreateBlock(uint64_t aSectorHash,
+                                                                                 uint32_t aInstanceCount,
+                                                                                 uint32_t aNodeCount,
+                                                                                 uint32_t aResourceGeneration)
+{
+    auto block = Core::MakeUnique<WorldNodeStaticBlock>();
+    block->sectorHash = aSectorHash;
+    block->resourceGeneration = aResourceGeneration;
+    block->instanceCount = aInstanceCount;
+    block->nodeCount = aNodeCount;
+
+    // Wider columns go first to keep every column naturally aligned
+    const auto nodeIDsSize = sizeof(uint64_t) * aInstanceCount;
+    const auto nodeTypesSize = sizeof(Red::CName) * aNodeCount;
+    const auto parentIDsSize = sizeof(uint64_t) * aNodeCount;
+    const auto debugNamesSize = sizeof(const char*) * aNodeCount;
+    const auto nodeIndexesSize = sizeof(uint16_t) * aInstanceCount;
+
+    block->storage.resize(nodeIDsSize + nodeTypesSize + parentIDsSize + debugNamesSize + nodeIndexesSize);
+
+    auto* data = block->storage.data();
+    block->nodeIDs = reinterpret_cast<uint64_t*>(data);
+    data += nodeIDsSize;
+    block->nodeTypes = reinterpret_cast<Red::CName*>(data);
+    data += nodeTypesSize;
+    block->parentIDs = reinterpret_cast<uint64_t*>(data);
+    data += parentIDsSize;
+    block->debugNames = reinterpret_cast<const char**>(data);
+    data += debugNamesSize;
+    block->nodeIndexes = reinterpret_cast<uint16_t*>(data);
+
+    return block;
+}
+
+Core::SharedPtr<const App::WorldNodeStaticBlock> App::WorldNodeStaticStore::PublishBlock(
+    Core::UniquePtr<WorldNodeStaticBlock> aBlock, const Core::Vector<Red::CString>& aDebugNames,
+    uint32_t& aSupersededRow)
+{
+    std::unique_lock _(m_lock);
+
+    aSupersededRow = InvalidRow;
+
+    if (static_cast<uint64_t>(m_nextRow) + aBlock->instanceCount >= SectorRowFlag)
+        return nullptr;
+
+    for (uint32_t nodeIndex = 0; nodeIndex < aBlock->nodeCount && nodeIndex < aDebugNames.size(); ++nodeIndex)
+    {
+        const auto& debugName = aDebugNames[nodeIndex];
+        if (debugName.Length() != 0)
+        {
+            aBlock->debugNames[nodeIndex] = InternString({debugName.c_str(), debugName.Length()});
+        }
+    }
+
+    aBlock->blockIndex = static_cast<uint32_t>(m_blocks.size());
+    aBlock->baseRow = m_nextRow;
+
+    m_nextRow += aBlock->instanceCount;
+    m_columnBytes += aBlock->storage.size();
+
+    const auto& [it, inserted] = m_blocksBySector.insert({aBlock->sectorHash, aBlock->blockIndex});
+
+    if (!inserted)
+    {
+        auto& supersededSlot = m_blocks[it.value()];
+
+        if (supersededSlot.block)
+        {
+            m_columnBytes -= supersededSlot.block->storage.size();
+            supersededSlot.block.reset();
+        }
+
+        aSupersededRow = SectorRowFlag | it.value();
+        it.value() = aBlock->blockIndex;
+    }
+
+    Core::SharedPtr<const WorldNodeStaticBlock> block = std::move(aBlock);
+    m_blocks.push_back({block->baseRow, block});
+
+    return block;
+}
+
+Core::SharedPtr<const App::WorldNodeStaticBlock> App::WorldNodeStaticStore::FindBlock(uint64_t aSectorHash,
+                                                                                      uint32_t aInstanceCount,
+                                                                                      uint32_t aNodeCount,
+                                                                                      uint32_t aResourceGeneration)
+{
+    std::shared_lock _(m_lock);
+    const auto& it = m_blocksBySector.find(aSectorHash);
+
+    if (it == m_blocksBySector.end())
+        return nullptr;
+
+    const auto& block = m_blocks[it.value()].block;
+
+    // The sector resource could have changed with the archives even when the counts are the same
+    if (block->instanceCount != aInstanceCount || block->nodeCount != aNodeCount ||
+        block->resourceGeneration != aResourceGeneration)
+        return nullptr;
+
+    return block;
+}
+
+void App::WorldNodeStaticStore::CommitGeneration(uint32_t aGeneration)
+{
+    std::unique_lock _(m_lock);
+    m_generation = aGeneration;
+}
+
+App::WorldNodeStaticDataView App::WorldNodeStaticStore::GetView(uint32_t aRow)
+{
+    if (aRow == InvalidRow)
+        return {};
+
+    std::shared_lock _(m_lock);
+
+    if (aRow & SectorRowFlag)
+    {
+        const auto blockIndex = aRow & ~SectorRowFlag;
+
+        if (blockIndex >= m_blocks.size())
+            return {};
+
+        const auto& block = m_blocks[blockIndex].block;
+
+        if (!block || block->generation > m_generation)
+            return {};
+
+        return {block, WorldNodeStaticDataView::SectorOnly};
+    }
+
+    auto it = std::upper_bound(m_blocks.begin(), m_blocks.end(), aRow,
+                               [](uint32_t aValue, const BlockSlot& aSlot)
+                               {
+                                   return aValue < aSlot.baseRow;
+                               });
+
+    if (it == m_blocks.begin())
+        return {};
+
+    const auto& block = (--it)->block;
+
+    // Blocks of the sectors that are still being ingested stay hidden until their generation is committed
+    if (!block || aRow >= block->baseRow + block->instanceCount || block->generation > m_generation)
+        return {};
+
+    return {block, static_cast<int32_t>(aRow - block->baseRow)};
+}
+
+App::WorldNodeStaticStoreStats App::WorldNodeStaticStore::GetStats()
+{
+    std::shared_lock _(m_lock);
+
+    WorldNodeStaticStoreStats stats{};
+    stats.rowCount = m_nextRow;
+    stats.stringCount = static_cast<uint32_t>(m_strings.size());
+    stats.columnBytes = m_columnBytes + m_blocks.size() * sizeof(BlockSlot);
+    stats.arenaBytes = m_arenaBytes;
+
+    for (const auto& slot : m_blocks)
+    {
+        if (slot.block)
+        {
+            ++stats.blockCount;
+            stats.nodeCount += slot.block->nodeCount;
+            stats.columnBytes += sizeof(WorldNodeStaticBlock);
+        }
+    }
+
+    return stats;
+}
+
+const char* App::WorldNodeStaticStore::InternString(std::string_view aString)
+{
+    const auto& it = m_strings.find(aString);
+
+    if (it != m_strings.end())
+        return it->data();
+
+    const auto requiredSize = aString.size() + 1;
+
+    if (m_arena.empty() || m_arena.back().capacity() - m_arena.back().size() < requiredSize)
+    {
+        auto& chunk = m_arena.emplace_back();
+        chunk.reserve(std::max(ArenaChunkSize, requiredSize));
+        m_arenaBytes += chunk.capacity();
+    }
+
+    // The chunk never grows past its reserved capacity, so the interned strings never move
+    auto& chunk = m_arena.back();
+    auto* interned = chunk.data() + chunk.size();
+    chunk.insert(chunk.end(), aString.begin(), aString.end());
+    chunk.push_back('\0');
+
+    m_strings.insert({interned, aString.size()});
+
+    return interned;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+namespace App
+{
+// Static data of all node instances of a sector packed into a single allocation.
+// Per instance columns are indexed by the instance index, per node columns by the node index.
+// The resource generation is the one the sector was loaded with, the block isn't reused after archives reload.
+struct WorldNodeStaticBlock
+{
+    uint64_t sectorHash{0};
+    uint32_t blockIndex{0};
+    uint32_t baseRow{0};
+    uint32_t instanceCount{0};
+    uint32_t nodeCount{0};
+    uint32_t generation{0};
+    uint32_t resourceGeneration{0};
+
+    uint64_t* nodeIDs{nullptr};
+    uint16_t* nodeIndexes{nullptr};
+    Red::CName* nodeTypes{nullptr};
+    uint64_t* parentIDs{nullptr};
+    const char** debugNames{nullptr};
+
+    Core::Vector<uint8_t> storage;
+};
+
+struct WorldNodeStaticDataView
+{
+    static constexpr auto SectorOnly = -1;
+
+    [[nodiscard]] inline explicit operator bool() const noexcept
+    {
+        return block != nullptr;
+    }
+
+    [[nodiscard]] inline bool HasNode() const noexcept
+    {
+        return block && instanceIndex >= 0;
+    }
+
+    [[nodiscard]] inline uint64_t GetSectorHash() const noexcept
+    {
+        return block ? block->sectorHash : 0;
+    }
+
+    [[nodiscard]] inline int32_t GetNodeIndex() const noexcept
+    {
+        return HasNode() ? block->nodeIndexes[instanceIndex] : -1;
+    }
+
+    [[nodiscard]] inline uint64_t GetNodeID() const noexcept
+    {
+        return HasNode() ? block->nodeIDs[instanceIndex] : 0;
+    }
+
+    [[nodiscard]] inline uint64_t GetParentID() const noexcept
+    {
+        return HasNode() ? block->parentIDs[GetNodeIndex()] : 0;
+    }
+
+    [[nodiscard]] inline Red::CName GetNodeType() const noexcept
+    {
+        return HasNode() ? block->nodeTypes[GetNodeIndex()] : Red::CName{};
+    }
+
+    [[nodiscard]] inline std::string_view GetDebugName() const noexcept
+    {
+        if (!HasNode())
+            return {};
+
+        auto debugName = block->debugNames[GetNodeIndex()];
+        return debugName ? debugName : std::string_view{};
+    }
+
+    Core::SharedPtr<const WorldNodeStaticBlock> block;
+    int32_t instanceIndex{SectorOnly};
+};
+
+struct WorldNodeStaticStoreStats
+{
+    uint32_t blockCount{0};
+    uint32_t rowCount{0};
+    uint32_t nodeCount{0};
+    uint32_t stringCount{0};
+    size_t columnBytes{0};
+    size_t arenaBytes{0};
+};
+
+class WorldNodeStaticStore
+{
+public:
+    // Row values with this flag refer to a whole sector block instead of a single node instance.
+    static constexpr uint32_t SectorRowFlag = 0x80000000;
+    static constexpr uint32_t InvalidRow = 0xFFFFFFFF;
+
+    Core::UniquePtr<WorldNodeStaticBlock> CreateBlock(uint64_t aSectorHash, uint32_t aInstanceCount,
+                                                      uint32_t aNodeCount, uint32_t aResourceGeneration);
+    Core::SharedPtr<const WorldNodeStaticBlock> PublishBlock(Core::UniquePtr<WorldNodeStaticBlock> aBlock,
+                                                             const Core::Vector<Red::CString>& aDebugNames,
+                                                             uint32_t& aSupersededRow);
+    Core::SharedPtr<const WorldNodeStaticBlock> FindBlock(uint64_t aSectorHash, uint32_t aInstanceCount,
+                                                          uint32_t aNodeCount, uint32_t aResourceGeneration);
+
+    void CommitGeneration(uint32_t aGeneration);
+
+    WorldNodeStaticDataView GetView(uint32_t aRow);
+    WorldNodeStaticStoreStats GetStats();
+
+private:
+    static constexpr size_t ArenaChunkSize = 256 * 1024;
+
+    // Blocks superseded by a newer block of the same sector are released from their slot,
+    // their rows are never reused and resolve to nothing, the readers holding them keep them alive.
+    struct BlockSlot
+    {
+        uint32_t baseRow;
+        Core::SharedPtr<const WorldNodeStaticBlock> block;
+    };
+
+    const char* InternString(std::string_view aString);
+
+    std::shared_mutex m_lock;
+    Core::Vector<BlockSlot> m_blocks;
+    Core::Map<uint64_t, uint32_t> m_blocksBySector;
+    Core::Vector<Core::Vector<char>> m_arena;
+    Core::Set<std::string_view> m_strings;
+    uint32_t m_nextRow{0};
+    uint32_t m_generation{0};
+    size_t m_columnBytes{0};
+    size_t m_arenaBytes{0};
+};
+}
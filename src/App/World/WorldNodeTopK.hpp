@@ -0,0 +1,74 @@
+#pragma once
+
+namespace App
+{
+// Bounded selection of the entries with the smallest keys, used to rank nodes by distance while they're processed.
+// The entries are kept in a max heap, so an entry that doesn't make it is rejected with a single comparison.
+// Ties are broken by the value, so the result doesn't depend on the order the entries came in.
+template<typename T>
+class WorldNodeTopK
+{
+public:
+    using Entry = std::pair<float, T>;
+
+    explicit WorldNodeTopK(uint32_t aLimit = 0)
+        : m_limit(aLimit)
+    {
+    }
+
+    void Reset(uint32_t aLimit)
+    {
+        m_entries.clear();
+        m_limit = aLimit;
+    }
+
+    bool Push(float aKey, const T& aValue)
+    {
+        if (m_limit == 0)
+            return false;
+
+        if (m_entries.size() < m_limit)
+        {
+            m_entries.emplace_back(aKey, aValue);
+            std::push_heap(m_entries.begin(), m_entries.end());
+            return true;
+        }
+
+        if (!(Entry{aKey, aValue} < m_entries.front()))
+            return false;
+
+        std::pop_heap(m_entries.begin(), m_entries.end());
+        m_entries.back() = {aKey, aValue};
+        std::push_heap(m_entries.begin(), m_entries.end());
+
+        return true;
+    }
+
+    // Sorts the kept entries by key and moves them out, the selection is empty afterwards.
+    void Take(Core::Vector<Entry>& aEntries)
+    {
+        std::sort_heap(m_entries.begin(), m_entries.end());
+        aEntries = std::move(m_entries);
+        m_entries.clear();
+    }
+
+    [[nodiscard]] const Core::Vector<Entry>& GetEntries() const
+    {
+        return m_entries;
+    }
+
+    [[nodiscard]] uint32_t GetSize() const
+    {
+        return static_cast<uint32_t>(m_entries.size());
+    }
+
+    [[nodiscard]] uint32_t GetLimit() const
+    {
+        return m_limit;
+    }
+
+private:
+    Core::Vector<Entry> m_entries;
+    uint32_t m_limit;
+};
+}
@@ -0,0 +1,311 @@
+#include "WorldStreamingProfiler.hpp"
+#include "Core/Facades/Log.hpp"
+
+void App::WorldStreamingProfiler::Start()
+{
+    std::unique_lock _(s_lock);
+
+    if (s_profiling)
+        return;
+
+    s_startTimestamp = GetTimestamp();
+    s_startTime = std::chrono::steady_clock::now();
+
+    s_profiling.store(true, std::memory_order_release);
+
+    Core::Log::Info("WorldStreamingProfiler: Profiling started.");
+}
+
+void App::WorldStreamingProfiler::Stop()
+{
+    std::unique_lock _(s_lock);
+
+    if (!s_profiling)
+        return;
+
+    s_profiling.store(false, std::memory_order_release);
+
+    // Nodes in the middle of streaming would never be completed
+    s_sectorLoads.clear();
+    s_pendingNodes.clear();
+    s_pendingSectorNodes.clear();
+
+    Core::Log::Info("WorldStreamingProfiler: Profiling stopped, {} nodes attached.",
+                    s_totalHistograms[static_cast<size_t>(WorldStreamingStage::Attach)].GetSamples());
+}
+
+void App::WorldStreamingProfiler::Reset()
+{
+    std::unique_lock _(s_lock);
+
+    for (auto& histogram : s_totalHistograms)
+    {
+        histogram.Clear();
+    }
+
+    s_nodeTypeHistograms.clear();
+    s_sectorHistograms.clear();
+}
+
+bool App::WorldStreamingProfiler::IsProfiling()
+{
+    return s_profiling.load(std::memory_order_relaxed);
+}
+
+void App::WorldStreamingProfiler::RecordSectorLoad(uint64_t aSectorHash, uint64_t aTimestamp)
+{
+    std::unique_lock _(s_lock);
+
+    // The flag is checked again under the lock, the hooks can race with stopping
+    if (!s_profiling)
+        return;
+
+    s_sectorLoads[aSectorHash] = aTimestamp;
+}
+
+void App::WorldStreamingProfiler::RecordSectorUnload(uint64_t aSectorHash)
+{
+    std::unique_lock _(s_lock);
+
+    if (!s_profiling)
+        return;
+
+    s_sectorLoads.erase(aSectorHash);
+
+    // Instances that were initialized but never attached are destroyed with the sector,
+    // they're grouped by sector, so only the instances of this sector are visited
+    const auto& sectorIt = s_pendingSectorNodes.find(aSectorHash);
+    if (sectorIt == s_pendingSectorNodes.end())
+        return;
+
+    for (auto* nodeInstance : sectorIt->second)
+    {
+        s_pendingNodes.erase(nodeInstance);
+    }
+
+    s_pendingSectorNodes.erase(sectorIt);
+}
+
+void App::WorldStreamingProfiler::RecordNodeInitialize(Red::worldINodeInstance* aNodeInstance, Red::CName aNodeType,
+                                                       uint64_t aSectorHash, uint64_t aTimestamp)
+{
+    std::unique_lock _(s_lock);
+
+    if (!s_profiling)
+        return;
+
+    const auto& sectorIt = s_sectorLoads.find(aSectorHash);
+    if (sectorIt != s_sectorLoads.end() && aTimestamp > sectorIt->second)
+    {
+        Record(WorldStreamingStage::Initialize, aNodeType, aSectorHash, aTimestamp - sectorIt->second);
+    }
+
+    // An instance can be initialized again, then it's only pending for the last sector
+    const auto& nodeIt = s_pendingNodes.find(aNodeInstance);
+    if (nodeIt != s_pendingNodes.end())
+    {
+        ErasePendingNode(nodeIt);
+    }
+
+    s_pendingNodes[aNodeInstance] = {aTimestamp, aSectorHash, aNodeType};
+    s_pendingSectorNodes[aSectorHash].insert(aNodeInstance);
+}
+
+void App::WorldStreamingProfiler::RecordNodeAttach(Red::worldINodeInstance* aNodeInstance, uint64_t aTimestamp)
+{
+    std::unique_lock _(s_lock);
+
+    if (!s_profiling)
+        return;
+
+    const auto& nodeIt = s_pendingNodes.find(aNodeInstance);
+    if (nodeIt == s_pendingNodes.end())
+        return;
+
+    const auto pendingNode = nodeIt->second;
+    ErasePendingNode(nodeIt);
+
+    if (aTimestamp > pendingNode.initializedAt)
+    {
+        Record(WorldStreamingStage::Attach, pendingNode.nodeType, pendingNode.sectorHash,
+               aTimestamp - pendingNode.initializedAt);
+    }
+}
+
+void App::WorldStreamingProfiler::RecordNodeDetach(Red::worldINodeInstance* aNodeInstance)
+{
+    std::unique_lock _(s_lock);
+
+    if (!s_profiling)
+        return;
+
+    const auto& nodeIt = s_pendingNodes.find(aNodeInstance);
+    if (nodeIt != s_pendingNodes.end())
+    {
+        ErasePendingNode(nodeIt);
+    }
+}
+
+void App::WorldStreamingProfiler::ErasePendingNode(
+    Core::Map<Red::worldINodeInstance*, PendingNode>::const_iterator aNodeIt)
+{
+    // Empty groups are kept until their sector is unloaded
+    const auto& sectorIt = s_pendingSectorNodes.find(aNodeIt->second.sectorHash);
+    if (sectorIt != s_pendingSectorNodes.end())
+    {
+        sectorIt.value().erase(aNodeIt->first);
+    }
+
+    s_pendingNodes.erase(aNodeIt);
+}
+
+void App::WorldStreamingProfiler::RecordPostponedWait(Red::CName aNodeType, uint64_t aPostponedAt,
+                                                      uint64_t aTimestamp)
+{
+    std::unique_lock _(s_lock);
+
+    if (!s_profiling)
+        return;
+
+    if (aTimestamp > aPostponedAt)
+    {
+        Record(WorldStreamingStage::Postponed, aNodeType, 0, aTimestamp - aPostponedAt);
+    }
+}
+
+void App::WorldStreamingProfiler::Record(WorldStreamingStage aStage, Red::CName aNodeType, uint64_t aSectorHash,
+                                         uint64_t aTicks)
+{
+    const auto stage = static_cast<size_t>(aStage);
+
+    s_totalHistograms[stage].Record(aTicks);
+
+    if (aNodeType)
+    {
+        s_nodeTypeHistograms[aNodeType][stage].Record(aTicks);
+    }
+
+    if (aSectorHash)
+    {
+        s_sectorHistograms[aSectorHash][stage].Record(aTicks);
+    }
+}
+
+Core::Vector<App::WorldStreamingLatencyStats> App::WorldStreamingProfiler::GetStats()
+{
+    std::unique_lock _(s_lock);
+
+    Core::Vector<WorldStreamingLatencyStats> stats;
+
+    const auto ticksPerMs = GetTicksPerMs();
+
+    if (ticksPerMs <= 0.0)
+        return stats;
+
+    CollectStats(stats, s_totalHistograms, {}, 0, ticksPerMs);
+
+    for (const auto& [nodeType, histograms] : s_nodeTypeHistograms)
+    {
+        CollectStats(stats, histograms, nodeType, 0, ticksPerMs);
+    }
+
+    for (const auto& [sectorHash, histograms] : s_sectorHistograms)
+    {
+        CollectStats(stats, histograms, {}, sectorHash, ticksPerMs);
+    }
+
+    return stats;
+}
+
+void App::WorldStreamingProfiler::CollectStats(Core::Vector<WorldStreamingLatencyStats>& aStats,
+                                               const StageHistograms& aHistograms, Red::CName aNodeType,
+                                               uint64_t aSectorHash, double aTicksPerMs)
+{
+    for (size_t stage = 0; stage < aHistograms.size(); ++stage)
+    {
+        const auto& histogram = aHistograms[stage];
+
+        if (histogram.IsEmpty())
+            continue;
+
+        aStats.push_back({GetStageName(static_cast<WorldStreamingStage>(stage)), aNodeType, aSectorHash,
+                          histogram.GetSamples(),
+                          static_cast<float>(static_cast<double>(histogram.GetPercentile(50.0)) / aTicksPerMs),
+                          static_cast<float>(static_cast<double>(histogram.GetPercentile(99.0)) / aTicksPerMs),
+                          static_cast<float>(static_cast<double>(histogram.GetMax()) / aTicksPerMs)});
+    }
+}
+
+bool App::WorldStreamingProfiler::Dump(const std::filesystem::path& aPath)
+{
+    const auto stats = GetStats();
+
+    std::error_code error;
+    std::filesystem::create_directories(aPath.parent_path(), error);
+
+    auto csvPath = aPath;
+    auto jsonPath = aPath;
+    csvPath.replace_extension(".csv");
+    jsonPath.replace_extension(".json");
+
+    std::ofstream csvFile(csvPath, std::ios::trunc);
+    std::ofstream jsonFile(jsonPath, std::ios::trunc);
+
+    if (!csvFile || !jsonFile)
+    {
+        Core::Log::Error("WorldStreamingProfiler: Can't write to {}.", aPath.string());
+        return false;
+    }
+
+    // The sector hash is written as a string, JSON readers usually can't represent all 64-bit integers
+    csvFile << "stage,nodeType,sectorHash,samples,p50Ms,p99Ms,maxMs\n";
+    jsonFile << "[\n";
+
+    for (size_t i = 0; i < stats.size(); ++i)
+    {
+        const auto& entry = stats[i];
+        const auto stage = entry.stage.ToString();
+        const auto nodeType = entry.nodeType ? entry.nodeType.ToString() : "";
+
+        csvFile << std::format("{},{},{},{},{:.4f},{:.4f},{:.4f}\n", stage, nodeType, entry.sectorHash,
+                               entry.samples, entry.p50, entry.p99, entry.max);
+
+        jsonFile << std::format(R"(  {{"stage": "{}", "nodeType": "{}", "sectorHash": "{}", "samples": {}, )"
+                                R"("p50Ms": {:.4f}, "p99Ms": {:.4f}, "maxMs": {:.4f}}}{})",
+                                stage, nodeType, entry.sectorHash, entry.samples, entry.p50, entry.p99, entry.max,
+                                i + 1 < stats.size() ? ",\n" : "\n");
+    }
+
+    jsonFile << "]\n";
+
+    Core::Log::Info("WorldStreamingProfiler: Written {} records to {}.", stats.size(), csvPath.string());
+
+    return true;
+}
+
+double App::WorldStreamingProfiler::GetTicksPerMs()
+{
+    // The TSC runs at a constant rate on all supported CPUs, so the rate is measured over the whole session
+    const auto elapsedTicks = GetTimestamp() - s_startTimestamp;
+    const std::chrono::duration<double, std::milli> elapsedTime = std::chrono::steady_clock::now() - s_startTime;
+
+    if (!s_startTimestamp || elapsedTime.count() <= 0.0)
+        return 0.0;
+
+    return static_cast<double>(elapsedTicks) / elapsedTime.count();
+}
+
+Red::CName App::WorldStreamingProfiler::GetStageName(WorldStreamingStage aStage)
+{
+    switch (aStage)
+    {
+    case WorldStreamingStage::Initialize:
+        return "Initialize";
+    case WorldStreamingStage::Attach:
+        return "Attach";
+    case WorldStreamingStage::Postponed:
+        return "Postponed";
+    default:
+        return {};
+    }
+}
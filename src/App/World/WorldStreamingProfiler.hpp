@@ -0,0 +1,95 @@
+#pragma once
+
+#include "App/World/WorldLatencyHistogram.hpp"
+
+#include <intrin.h>
+
+namespace App
+{
+enum class WorldStreamingStage : uint8_t
+{
+    Initialize, // From the sector post load to the node instance initialization
+    Attach,     // From the node instance initialization to the attachment
+    Postponed,  // Time spent by a node in the postponed queue of the inspector
+    Count,
+};
+
+// Latencies in milliseconds, a zero sector hash means all sectors and an empty node type means all node types.
+struct WorldStreamingLatencyStats
+{
+    Red::CName stage;
+    Red::CName nodeType;
+    uint64_t sectorHash{0};
+    uint64_t samples{0};
+    float p50{0};
+    float p99{0};
+    float max{0};
+};
+
+// Measures how long node instances take to go through the streaming stages, per node type and per sector.
+// The stages are timestamped with the TSC, the ticks are only converted to time when the results are requested.
+// The hooks only check a flag while nothing is profiled.
+class WorldStreamingProfiler
+{
+public:
+    static void Start();
+    static void Stop();
+    static void Reset();
+
+    [[nodiscard]] static bool IsProfiling();
+
+    [[nodiscard]] inline static uint64_t GetTimestamp()
+    {
+        return __rdtsc();
+    }
+
+    static void RecordSectorLoad(uint64_t aSectorHash, uint64_t aTimestamp);
+    static void RecordSectorUnload(uint64_t aSectorHash);
+    static void RecordNodeInitialize(Red::worldINodeInstance* aNodeInstance, Red::CName aNodeType,
+                                     uint64_t aSectorHash, uint64_t aTimestamp);
+    static void RecordNodeAttach(Red::worldINodeInstance* aNodeInstance, uint64_t aTimestamp);
+    static void RecordNodeDetach(Red::worldINodeInstance* aNodeInstance);
+    static void RecordPostponedWait(Red::CName aNodeType, uint64_t aPostponedAt, uint64_t aTimestamp);
+
+    [[nodiscard]] static Core::Vector<WorldStreamingLatencyStats> GetStats();
+    static bool Dump(const std::filesystem::path& aPath);
+
+private:
+    using StageHistograms = std::array<WorldLatencyHistogram, static_cast<size_t>(WorldStreamingStage::Count)>;
+
+    struct PendingNode
+    {
+        uint64_t initializedAt;
+        uint64_t sectorHash;
+        Red::CName nodeType;
+    };
+
+    static void Record(WorldStreamingStage aStage, Red::CName aNodeType, uint64_t aSectorHash, uint64_t aTicks);
+    static void ErasePendingNode(Core::Map<Red::worldINodeInstance*, PendingNode>::const_iterator aNodeIt);
+    static void CollectStats(Core::Vector<WorldStreamingLatencyStats>& aStats, const StageHistograms& aHistograms,
+                             Red::CName aNodeType, uint64_t aSectorHash, double aTicksPerMs);
+    static double GetTicksPerMs();
+    static Red::CName GetStageName(WorldStreamingStage aStage);
+
+    inline static std::atomic<bool> s_profiling{false};
+    inline static std::mutex s_lock;
+    inline static Core::Map<uint64_t, uint64_t> s_sectorLoads;
+    inline static Core::Map<Red::worldINodeInstance*, PendingNode> s_pendingNodes;
+    inline static Core::Map<uint64_t, Core::Set<Red::worldINodeInstance*>> s_pendingSectorNodes;
+    inline static StageHistograms s_totalHistograms;
+    inline static Core::Map<Red::CName, StageHistograms> s_nodeTypeHistograms;
+    inline static Core::Map<uint64_t, StageHistograms> s_sectorHistograms;
+    inline static uint64_t s_startTimestamp{0};
+    inline static std::chrono::steady_clock::time_point s_startTime;
+};
+}
+
+RTTI_DEFINE_CLASS(App::WorldStreamingLatencyStats, {
+    RTTI_PROPERTY(stage);
+    RTTI_PROPERTY(nodeType);
+    RTTI_PROPERTY(sectorHash);
+    RTTI_PROPERTY(samples);
+    RTTI_PROPERTY(p50);
+    RTTI_PROPERTY(p99);
+    RTTI_PROPERTY(max);
+});
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+
+// Binary layout of the world streaming traces.
+// The file starts with a header followed by events in the order they were recorded, every event is an event header
+// followed by the payload of its type, sector loads are followed by the setups of all node instances of the sector.
+// Engine objects are identified by their addresses, which are only meaningful within a single trace.
+// This header has no engine dependencies, so it can be shared with the standalone tools.
+namespace App::WorldTraceFormat
+{
+static_assert(std::endian::native == std::endian::little, "The trace is stored in little endian");
+
+constexpr uint32_t Magic = 0x54574852; // RHWT
+constexpr uint32_t Version = 1;
+
+enum class EventType : uint16_t
+{
+    SectorLoad = 1,
+    SectorUnload = 2,
+    NodeInitialize = 3,
+    NodeAttach = 4,
+    NodeDetach = 5,
+    NodeBounds = 6,
+    NodeRemove = 7,
+    CameraUpdate = 8,
+    WorldDetach = 9,
+    IndexClear = 10,
+};
+
+struct Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t eventHeaderSize;
+    uint32_t reserved;
+};
+static_assert(sizeof(Header) == 16);
+
+struct EventHeader
+{
+    EventType type;
+    uint16_t reserved;
+    uint32_t size;  // Size of the payload following the header
+    uint64_t time;  // Nanoseconds since the start of the recording
+};
+static_assert(sizeof(EventHeader) == 16);
+
+// Sectors are identified by the end of their setup buffer, same as in the registry.
+struct SectorLoad
+{
+    uint64_t sectorKey;
+    uint64_t sectorHash;
+    uint32_t instanceCount;
+    uint32_t nodeCount;
+};
+static_assert(sizeof(SectorLoad) == 24);
+
+struct NodeSetup
+{
+    uint64_t setupKey;
+    uint64_t nodeID;
+    uint64_t nodeType;
+    uint32_t nodeIndex;
+    uint32_t reserved;
+    float position[4];
+    float orientation[4];
+    float scale[4];
+};
+static_assert(sizeof(NodeSetup) == 80);
+
+struct SectorUnload
+{
+    uint64_t sectorKey;
+};
+static_assert(sizeof(SectorUnload) == 8);
+
+struct NodeInitialize
+{
+    uint64_t instanceKey;
+    uint64_t setupKey;
+};
+static_assert(sizeof(NodeInitialize) == 16);
+
+struct NodeAttach
+{
+    uint64_t instanceKey;
+};
+static_assert(sizeof(NodeAttach) == 8);
+
+using NodeDetach = NodeAttach;
+
+// Bounds of a streamed node as inserted into the spatial index of the inspector.
+struct NodeBounds
+{
+    uint64_t nodeKey;
+    float min[4];
+    float max[4];
+};
+static_assert(sizeof(NodeBounds) == 40);
+
+struct NodeRemove
+{
+    uint64_t nodeKey;
+};
+static_assert(sizeof(NodeRemove) == 8);
+
+// The frustum is stored as is, the masks select the box corner tested against each plane.
+struct CameraUpdate
+{
+    float position[4];
+    float forward[4];
+    float planes[6][4];
+    uint32_t masks[6][4];
+    float frustumDistance;
+    float targetingDistance;
+    uint32_t reserved[2];
+};
+static_assert(sizeof(CameraUpdate) == 240);
+
+inline Header MakeHeader()
+{
+    return {Magic, Version, sizeof(EventHeader), 0};
+}
+
+inline bool IsValidHeader(const Header& aHeader)
+{
+    return aHeader.magic == Magic && aHeader.version == Version && aHeader.eventHeaderSize == sizeof(EventHeader);
+}
+
+inline const char* GetEventName(EventType aType)
+{
+    switch (aType)
+    {
+    case EventType::SectorLoad:
+        return "SectorLoad";
+    case EventType::SectorUnload:
+        return "SectorUnload";
+    case EventType::NodeInitialize:
+        return "NodeInitialize";
+    case EventType::NodeAttach:
+        return "NodeAttach";
+    case EventType::NodeDetach:
+        return "NodeDetach";
+    case EventType::NodeBounds:
+        return "NodeBounds";
+    case EventType::NodeRemove:
+        return "NodeRemove";
+    case EventType::CameraUpdate:
+        return "CameraUpdate";
+    case EventType::WorldDetach:
+        return "WorldDetach";
+    case EventType::IndexClear:
+        return "IndexClear";
+    }
+
+    return "Unknown";
+}
+}
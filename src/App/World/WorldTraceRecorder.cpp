@@ -0,0 +1,191 @@
+#include "WorldTraceRecorder.hpp"
+#include "Core/Facades/Log.hpp"
+
+#include <cstring>
+
+namespace
+{
+namespace Format = App::WorldTraceFormat;
+
+static_assert(sizeof(Red::Frustum::planes) == sizeof(Format::CameraUpdate::planes));
+static_assert(sizeof(Red::Frustum::masks) == sizeof(Format::CameraUpdate::masks));
+}
+
+bool App::WorldTraceRecorder::Start(const std::filesystem::path& aPath)
+{
+    std::unique_lock _(s_lock);
+
+    if (s_recording)
+        return false;
+
+    std::error_code error;
+    std::filesystem::create_directories(aPath.parent_path(), error);
+
+    s_file.open(aPath, std::ios::binary | std::ios::trunc);
+
+    if (!s_file)
+    {
+        Core::Log::Error("WorldTraceRecorder: Can't open {}.", aPath.string());
+        return false;
+    }
+
+    const auto header = WorldTraceFormat::MakeHeader();
+    s_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    s_buffer.clear();
+    s_buffer.reserve(FlushSize + FlushSize / 4);
+    s_startTime = std::chrono::steady_clock::now();
+    s_events = 0;
+    s_writtenBytes = sizeof(header);
+
+    s_recording.store(true, std::memory_order_release);
+
+    Core::Log::Info("WorldTraceRecorder: Recording to {}.", aPath.string());
+
+    return true;
+}
+
+void App::WorldTraceRecorder::Stop()
+{
+    std::unique_lock _(s_lock);
+
+    if (!s_recording)
+        return;
+
+    s_recording.store(false, std::memory_order_release);
+
+    Flush();
+    s_file.close();
+
+    s_buffer.clear();
+    s_buffer.shrink_to_fit();
+
+    Core::Log::Info("WorldTraceRecorder: Recorded {} events, {} bytes.", s_events, s_writtenBytes);
+}
+
+bool App::WorldTraceRecorder::IsRecording()
+{
+    return s_recording.load(std::memory_order_relaxed);
+}
+
+App::WorldTraceRecorderStats App::WorldTraceRecorder::GetStats()
+{
+    std::unique_lock _(s_lock);
+    return {s_recording, s_events, s_writtenBytes + s_buffer.size()};
+}
+
+void App::WorldTraceRecorder::RecordSectorLoad(const WorldTraceFormat::SectorLoad& aSector,
+                                               const Core::Vector<WorldTraceFormat::NodeSetup>& aSetups)
+{
+    Write(Format::EventType::SectorLoad, &aSector, sizeof(aSector), aSetups.data(),
+          static_cast<uint32_t>(aSetups.size() * sizeof(Format::NodeSetup)));
+}
+
+void App::WorldTraceRecorder::RecordSectorUnload(uint64_t aSectorKey)
+{
+    const Format::SectorUnload event{aSectorKey};
+    Write(Format::EventType::SectorUnload, &event, sizeof(event));
+}
+
+void App::WorldTraceRecorder::RecordNodeInitialize(uint64_t aInstanceKey, uint64_t aSetupKey)
+{
+    const Format::NodeInitialize event{aInstanceKey, aSetupKey};
+    Write(Format::EventType::NodeInitialize, &event, sizeof(event));
+}
+
+void App::WorldTraceRecorder::RecordNodeAttach(uint64_t aInstanceKey)
+{
+    const Format::NodeAttach event{aInstanceKey};
+    Write(Format::EventType::NodeAttach, &event, sizeof(event));
+}
+
+void App::WorldTraceRecorder::RecordNodeDetach(uint64_t aInstanceKey)
+{
+    const Format::NodeDetach event{aInstanceKey};
+    Write(Format::EventType::NodeDetach, &event, sizeof(event));
+}
+
+void App::WorldTraceRecorder::RecordNodeBounds(uint64_t aNodeKey, const Red::Box& aBounds)
+{
+    const Format::NodeBounds event{aNodeKey,
+                                   {aBounds.Min.X, aBounds.Min.Y, aBounds.Min.Z, aBounds.Min.W},
+                                   {aBounds.Max.X, aBounds.Max.Y, aBounds.Max.Z, aBounds.Max.W}};
+    Write(Format::EventType::NodeBounds, &event, sizeof(event));
+}
+
+void App::WorldTraceRecorder::RecordNodeRemove(uint64_t aNodeKey)
+{
+    const Format::NodeRemove event{aNodeKey};
+    Write(Format::EventType::NodeRemove, &event, sizeof(event));
+}
+
+void App::WorldTraceRecorder::RecordCameraUpdate(const Red::Frustum& aFrustum, const Red::Vector4& aPosition,
+                                                 const Red::Vector4& aForward, float aFrustumDistance,
+                                                 float aTargetingDistance)
+{
+    Format::CameraUpdate event{{aPosition.X, aPosition.Y, aPosition.Z, aPosition.W},
+                               {aForward.X, aForward.Y, aForward.Z, aForward.W}};
+    std::memcpy(event.planes, aFrustum.planes, sizeof(event.planes));
+    std::memcpy(event.masks, aFrustum.masks, sizeof(event.masks));
+    event.frustumDistance = aFrustumDistance;
+    event.targetingDistance = aTargetingDistance;
+
+    Write(Format::EventType::CameraUpdate, &event, sizeof(event));
+}
+
+void App::WorldTraceRecorder::RecordWorldDetach()
+{
+    Write(Format::EventType::WorldDetach, nullptr, 0);
+}
+
+void App::WorldTraceRecorder::RecordIndexClear()
+{
+    Write(Format::EventType::IndexClear, nullptr, 0);
+}
+
+void App::WorldTraceRecorder::Write(WorldTraceFormat::EventType aType, const void* aPayload, uint32_t aSize,
+                                    const void* aExtra, uint32_t aExtraSize)
+{
+    std::unique_lock _(s_lock);
+
+    // The flag is checked again under the lock, the hooks can race with stopping
+    if (!s_recording)
+        return;
+
+    const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                           s_startTime);
+    const Format::EventHeader header{aType, 0, aSize + aExtraSize, static_cast<uint64_t>(time.count())};
+
+    const auto offset = s_buffer.size();
+    s_buffer.resize(offset + sizeof(header) + aSize + aExtraSize);
+
+    auto* data = s_buffer.data() + offset;
+    std::memcpy(data, &header, sizeof(header));
+
+    if (aSize)
+    {
+        std::memcpy(data + sizeof(header), aPayload, aSize);
+    }
+
+    if (aExtraSize)
+    {
+        std::memcpy(data + sizeof(header) + aSize, aExtra, aExtraSize);
+    }
+
+    ++s_events;
+
+    if (s_buffer.size() >= FlushSize)
+    {
+        Flush();
+    }
+}
+
+void App::WorldTraceRecorder::Flush()
+{
+    if (s_buffer.empty())
+        return;
+
+    s_file.write(reinterpret_cast<const char*>(s_buffer.data()), static_cast<std::streamsize>(s_buffer.size()));
+    s_writtenBytes += s_buffer.size();
+    s_buffer.clear();
+}
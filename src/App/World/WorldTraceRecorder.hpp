@@ -0,0 +1,54 @@
+#pragma once
+
+#include "App/World/WorldTraceFormat.hpp"
+#include "Red/Frustum.hpp"
+
+namespace App
+{
+struct WorldTraceRecorderStats
+{
+    bool recording{false};
+    uint64_t events{0};
+    uint64_t writtenBytes{0};
+};
+
+// Records world streaming and camera events to a trace file, so they can be replayed by the standalone tools.
+// The hooks only check a flag while nothing is recorded, the events are buffered and written in large blocks.
+class WorldTraceRecorder
+{
+public:
+    static constexpr auto FlushSize = 1u << 20;
+
+    static bool Start(const std::filesystem::path& aPath);
+    static void Stop();
+
+    [[nodiscard]] static bool IsRecording();
+    [[nodiscard]] static WorldTraceRecorderStats GetStats();
+
+    static void RecordSectorLoad(const WorldTraceFormat::SectorLoad& aSector,
+                                 const Core::Vector<WorldTraceFormat::NodeSetup>& aSetups);
+    static void RecordSectorUnload(uint64_t aSectorKey);
+    static void RecordNodeInitialize(uint64_t aInstanceKey, uint64_t aSetupKey);
+    static void RecordNodeAttach(uint64_t aInstanceKey);
+    static void RecordNodeDetach(uint64_t aInstanceKey);
+    static void RecordNodeBounds(uint64_t aNodeKey, const Red::Box& aBounds);
+    static void RecordNodeRemove(uint64_t aNodeKey);
+    static void RecordCameraUpdate(const Red::Frustum& aFrustum, const Red::Vector4& aPosition,
+                                   const Red::Vector4& aForward, float aFrustumDistance, float aTargetingDistance);
+    static void RecordWorldDetach();
+    static void RecordIndexClear();
+
+private:
+    static void Write(WorldTraceFormat::EventType aType, const void* aPayload, uint32_t aSize,
+                      const void* aExtra = nullptr, uint32_t aExtraSize = 0);
+    static void Flush();
+
+    inline static std::atomic<bool> s_recording{false};
+    inline static std::mutex s_lock;
+    inline static std::ofstream s_file;
+    inline static Core::Vector<uint8_t> s_buffer;
+    inline static std::chrono::steady_clock::time_point s_startTime;
+    inline static uint64_t s_events{0};
+    inline static uint64_t s_writtenBytes{0};
+};
+}
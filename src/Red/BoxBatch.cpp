@@ -0,0 +1,491 @@
+#include "BoxBatch.hpp"
+#include "Red/Math.hpp"
+
+#include <cmath>
+#include <intrin.h>
+
+namespace
+{
+static_assert(sizeof(Red::FrustumResult) == sizeof(int32_t));
+
+struct FrustumPlane
+{
+    float a;
+    float b;
+    float c;
+    float d;
+    bool maxX;
+    bool maxY;
+    bool maxZ;
+};
+
+using FrustumPlanes = std::array<FrustumPlane, Red::Frustum::NumberOfPlanes>;
+
+FrustumPlanes GetFrustumPlanes(const Red::Frustum& aFrustum)
+{
+    FrustumPlanes planes{};
+
+    for (auto i = 0; i < Red::Frustum::NumberOfPlanes; ++i)
+    {
+        float components[4];
+        _mm_storeu_ps(components, aFrustum.planes[i]);
+
+        const auto mask = _mm_movemask_ps(aFrustum.masks[i]);
+
+        planes[i] = {components[0], components[1], components[2], components[3],
+                     (mask & 1) != 0, (mask & 2) != 0, (mask & 4) != 0};
+    }
+
+    return planes;
+}
+
+// The plane distances are summed in the same order as the horizontal adds of Frustum::Test,
+// so the scalar and the vector kernels round exactly like the original function.
+// That only holds as long as the compiler doesn't contract the products and sums into FMAs (MSVC's /fp:contract,
+// -ffp-contract=off is required with GCC and Clang).
+// The sign of a NaN distance depends on which operand the hardware propagates, which the compiler is free to swap,
+// so boxes with a NaN distance are tested by the original function instead.
+void TestFrustumScalar(const Red::Frustum& aFrustum, const FrustumPlanes& aPlanes, const Red::BoxBatch& aBoxes,
+                       Red::FrustumResult* aResults, uint32_t aBegin, uint32_t aEnd)
+{
+    for (auto i = aBegin; i < aEnd; ++i)
+    {
+        auto result = Red::FrustumResult::Inside;
+
+        for (const auto& plane : aPlanes)
+        {
+            const auto px = plane.maxX ? aBoxes.maxX[i] : aBoxes.minX[i];
+            const auto py = plane.maxY ? aBoxes.maxY[i] : aBoxes.minY[i];
+            const auto pz = plane.maxZ ? aBoxes.maxZ[i] : aBoxes.minZ[i];
+            const auto nx = plane.maxX ? aBoxes.minX[i] : aBoxes.maxX[i];
+            const auto ny = plane.maxY ? aBoxes.minY[i] : aBoxes.maxY[i];
+            const auto nz = plane.maxZ ? aBoxes.minZ[i] : aBoxes.maxZ[i];
+
+            const auto positive = (px * plane.a + py * plane.b) + (pz * plane.c + plane.d);
+            const auto negative = (nx * plane.a + ny * plane.b) + (nz * plane.c + plane.d);
+
+            if (std::isnan(positive) || std::isnan(negative))
+            {
+                result = aFrustum.Test(aBoxes.Get(i));
+                break;
+            }
+
+            if (std::signbit(positive) != std::signbit(negative))
+            {
+                result = Red::FrustumResult::Intersecting;
+            }
+            else if (std::signbit(negative))
+            {
+                result = Red::FrustumResult::Outside;
+                break;
+            }
+        }
+
+        aResults[i] = result;
+    }
+}
+
+void DistanceSquaredScalar(const Red::Vector4& aPoint, const Red::BoxBatch& aBoxes, float* aResults, uint32_t aBegin,
+                           uint32_t aEnd)
+{
+    for (auto i = aBegin; i < aEnd; ++i)
+    {
+        aResults[i] = Red::DistanceSquared(aPoint, aBoxes.Get(i));
+    }
+}
+
+void IntersectScalar(const Red::Vector4& aOrigin, const Red::Vector4& aInverseDirection, const Red::BoxBatch& aBoxes,
+                     bool* aResults, uint32_t aBegin, uint32_t aEnd)
+{
+    for (auto i = aBegin; i < aEnd; ++i)
+    {
+        aResults[i] = Red::Intersect(aOrigin, aInverseDirection, aBoxes.Get(i));
+    }
+}
+
+// Retests the lanes of a vector with a NaN distance, see TestFrustumScalar
+void TestFrustumNaN(const Red::Frustum& aFrustum, const Red::BoxBatch& aBoxes, Red::FrustumResult* aResults,
+                    uint32_t aBegin, int aLanes)
+{
+    for (auto lane = 0; aLanes >> lane; ++lane)
+    {
+        if ((aLanes >> lane) & 1)
+        {
+            aResults[aBegin + lane] = aFrustum.Test(aBoxes.Get(aBegin + lane));
+        }
+    }
+}
+
+// Selects like the ternary operators of std::min and std::max, so NaNs and signed zeros propagate the same way
+inline __m128 Select(__m128 aMask, __m128 aTrue, __m128 aFalse)
+{
+    return _mm_or_ps(_mm_and_ps(aMask, aTrue), _mm_andnot_ps(aMask, aFalse));
+}
+
+inline __m128 Min(__m128 a, __m128 b)
+{
+    return Select(_mm_cmplt_ps(b, a), b, a);
+}
+
+inline __m128 Max(__m128 a, __m128 b)
+{
+    return Select(_mm_cmplt_ps(a, b), b, a);
+}
+
+inline __m256 Select(__m256 aMask, __m256 aTrue, __m256 aFalse)
+{
+    return _mm256_blendv_ps(aFalse, aTrue, aMask);
+}
+
+inline __m256 Min(__m256 a, __m256 b)
+{
+    return Select(_mm256_cmp_ps(b, a, _CMP_LT_OQ), b, a);
+}
+
+inline __m256 Max(__m256 a, __m256 b)
+{
+    return Select(_mm256_cmp_ps(a, b, _CMP_LT_OQ), b, a);
+}
+
+uint32_t TestFrustumSSE(const Red::Frustum& aFrustum, const FrustumPlanes& aPlanes, const Red::BoxBatch& aBoxes,
+                        Red::FrustumResult* aResults)
+{
+    const auto count = aBoxes.GetSize() & ~3u;
+
+    for (uint32_t i = 0; i < count; i += 4)
+    {
+        const auto minX = _mm_loadu_ps(&aBoxes.minX[i]);
+        const auto minY = _mm_loadu_ps(&aBoxes.minY[i]);
+        const auto minZ = _mm_loadu_ps(&aBoxes.minZ[i]);
+        const auto maxX = _mm_loadu_ps(&aBoxes.maxX[i]);
+        const auto maxY = _mm_loadu_ps(&aBoxes.maxY[i]);
+        const auto maxZ = _mm_loadu_ps(&aBoxes.maxZ[i]);
+
+        auto outside = _mm_setzero_si128();
+        auto intersecting = _mm_setzero_si128();
+        auto unordered = _mm_setzero_ps();
+
+        for (const auto& plane : aPlanes)
+        {
+            const auto a = _mm_set1_ps(plane.a);
+            const auto b = _mm_set1_ps(plane.b);
+            const auto c = _mm_set1_ps(plane.c);
+            const auto d = _mm_set1_ps(plane.d);
+
+            const auto positive = _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane.maxX ? maxX : minX, a),
+                                                         _mm_mul_ps(plane.maxY ? maxY : minY, b)),
+                                              _mm_add_ps(_mm_mul_ps(plane.maxZ ? maxZ : minZ, c), d));
+            const auto negative = _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane.maxX ? minX : maxX, a),
+                                                         _mm_mul_ps(plane.maxY ? minY : maxY, b)),
+                                              _mm_add_ps(_mm_mul_ps(plane.maxZ ? minZ : maxZ, c), d));
+
+            const auto differs = _mm_srai_epi32(_mm_castps_si128(_mm_xor_ps(positive, negative)), 31);
+            const auto negativeSign = _mm_srai_epi32(_mm_castps_si128(negative), 31);
+
+            intersecting = _mm_or_si128(intersecting, differs);
+            outside = _mm_or_si128(outside, _mm_andnot_si128(differs, negativeSign));
+            unordered = _mm_or_ps(unordered, _mm_cmpunord_ps(positive, negative));
+        }
+
+        // Outside wins over intersecting, since the original test stops at the first plane the box is outside of
+        auto result = _mm_add_epi32(_mm_set1_epi32(Red::FrustumResult::Inside), intersecting);
+        result = _mm_or_si128(_mm_and_si128(outside, _mm_set1_epi32(Red::FrustumResult::Outside)),
+                              _mm_andnot_si128(outside, result));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(aResults + i), result);
+
+        if (const auto nans = _mm_movemask_ps(unordered))
+        {
+            TestFrustumNaN(aFrustum, aBoxes, aResults, i, nans);
+        }
+    }
+
+    return count;
+}
+
+uint32_t DistanceSquaredSSE(const Red::Vector4& aPoint, const Red::BoxBatch& aBoxes, float* aResults)
+{
+    const auto count = aBoxes.GetSize() & ~3u;
+    const auto zero = _mm_setzero_ps();
+    const auto pointX = _mm_set1_ps(aPoint.X);
+    const auto pointY = _mm_set1_ps(aPoint.Y);
+    const auto pointZ = _mm_set1_ps(aPoint.Z);
+
+    const auto axisDistance = [&zero](__m128 aValue, __m128 aMin, __m128 aMax)
+    {
+        return Select(_mm_cmplt_ps(aValue, aMin), _mm_sub_ps(aMin, aValue),
+                      Select(_mm_cmpgt_ps(aValue, aMax), _mm_sub_ps(aMax, aValue), zero));
+    };
+
+    for (uint32_t i = 0; i < count; i += 4)
+    {
+        const auto dx = axisDistance(pointX, _mm_loadu_ps(&aBoxes.minX[i]), _mm_loadu_ps(&aBoxes.maxX[i]));
+        const auto dy = axisDistance(pointY, _mm_loadu_ps(&aBoxes.minY[i]), _mm_loadu_ps(&aBoxes.maxY[i]));
+        const auto dz = axisDistance(pointZ, _mm_loadu_ps(&aBoxes.minZ[i]), _mm_loadu_ps(&aBoxes.maxZ[i]));
+
+        const auto distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+        _mm_storeu_ps(aResults + i, distance);
+    }
+
+    return count;
+}
+
+uint32_t IntersectSSE(const Red::Vector4& aOrigin, const Red::Vector4& aInverseDirection, const Red::BoxBatch& aBoxes,
+                      bool* aResults)
+{
+    const auto count = aBoxes.GetSize() & ~3u;
+    const auto originX = _mm_set1_ps(aOrigin.X);
+    const auto originY = _mm_set1_ps(aOrigin.Y);
+    const auto originZ = _mm_set1_ps(aOrigin.Z);
+    const auto inverseX = _mm_set1_ps(aInverseDirection.X);
+    const auto inverseY = _mm_set1_ps(aInverseDirection.Y);
+    const auto inverseZ = _mm_set1_ps(aInverseDirection.Z);
+
+    for (uint32_t i = 0; i < count; i += 4)
+    {
+        const auto tx1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&aBoxes.minX[i]), originX), inverseX);
+        const auto tx2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&aBoxes.maxX[i]), originX), inverseX);
+
+        auto tmin = Min(tx1, tx2);
+        auto tmax = Max(tx1, tx2);
+
+        const auto ty1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&aBoxes.minY[i]), originY), inverseY);
+        const auto ty2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&aBoxes.maxY[i]), originY), inverseY);
+
+        tmin = Max(tmin, Min(ty1, ty2));
+        tmax = Min(tmax, Max(ty1, ty2));
+
+        const auto tz1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&aBoxes.minZ[i]), originZ), inverseZ);
+        const auto tz2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&aBoxes.maxZ[i]), originZ), inverseZ);
+
+        tmin = Max(tmin, Min(tz1, tz2));
+        tmax = Min(tmax, Max(tz1, tz2));
+
+        const auto hits = _mm_movemask_ps(_mm_cmpge_ps(tmax, Max(_mm_setzero_ps(), tmin)));
+
+        for (auto lane = 0; lane < 4; ++lane)
+        {
+            aResults[i + lane] = (hits >> lane) & 1;
+        }
+    }
+
+    return count;
+}
+
+uint32_t TestFrustumAVX2(const Red::Frustum& aFrustum, const FrustumPlanes& aPlanes, const Red::BoxBatch& aBoxes,
+                         Red::FrustumResult* aResults)
+{
+    const auto count = aBoxes.GetSize() & ~7u;
+
+    for (uint32_t i = 0; i < count; i += 8)
+    {
+        const auto minX = _mm256_loadu_ps(&aBoxes.minX[i]);
+        const auto minY = _mm256_loadu_ps(&aBoxes.minY[i]);
+        const auto minZ = _mm256_loadu_ps(&aBoxes.minZ[i]);
+        const auto maxX = _mm256_loadu_ps(&aBoxes.maxX[i]);
+        const auto maxY = _mm256_loadu_ps(&aBoxes.maxY[i]);
+        const auto maxZ = _mm256_loadu_ps(&aBoxes.maxZ[i]);
+
+        auto outside = _mm256_setzero_si256();
+        auto intersecting = _mm256_setzero_si256();
+        auto unordered = _mm256_setzero_ps();
+
+        for (const auto& plane : aPlanes)
+        {
+            const auto a = _mm256_set1_ps(plane.a);
+            const auto b = _mm256_set1_ps(plane.b);
+            const auto c = _mm256_set1_ps(plane.c);
+            const auto d = _mm256_set1_ps(plane.d);
+
+            const auto positive = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(plane.maxX ? maxX : minX, a),
+                                                              _mm256_mul_ps(plane.maxY ? maxY : minY, b)),
+                                                _mm256_add_ps(_mm256_mul_ps(plane.maxZ ? maxZ : minZ, c), d));
+            const auto negative = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(plane.maxX ? minX : maxX, a),
+                                                              _mm256_mul_ps(plane.maxY ? minY : maxY, b)),
+                                                _mm256_add_ps(_mm256_mul_ps(plane.maxZ ? minZ : maxZ, c), d));
+
+            const auto differs = _mm256_srai_epi32(_mm256_castps_si256(_mm256_xor_ps(positive, negative)), 31);
+            const auto negativeSign = _mm256_srai_epi32(_mm256_castps_si256(negative), 31);
+
+            intersecting = _mm256_or_si256(intersecting, differs);
+            outside = _mm256_or_si256(outside, _mm256_andnot_si256(differs, negativeSign));
+            unordered = _mm256_or_ps(unordered, _mm256_cmp_ps(positive, negative, _CMP_UNORD_Q));
+        }
+
+        auto result = _mm256_add_epi32(_mm256_set1_epi32(Red::FrustumResult::Inside), intersecting);
+        result = _mm256_blendv_epi8(result, _mm256_set1_epi32(Red::FrustumResult::Outside), outside);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(aResults + i), result);
+
+        if (const auto nans = _mm256_movemask_ps(unordered))
+        {
+            TestFrustumNaN(aFrustum, aBoxes, aResults, i, nans);
+        }
+    }
+
+    return count;
+}
+
+uint32_t DistanceSquaredAVX2(const Red::Vector4& aPoint, const Red::BoxBatch& aBoxes, float* aResults)
+{
+    const auto count = aBoxes.GetSize() & ~7u;
+    const auto zero = _mm256_setzero_ps();
+    const auto pointX = _mm256_set1_ps(aPoint.X);
+    const auto pointY = _mm256_set1_ps(aPoint.Y);
+    const auto pointZ = _mm256_set1_ps(aPoint.Z);
+
+    const auto axisDistance = [&zero](__m256 aValue, __m256 aMin, __m256 aMax)
+    {
+        return Select(_mm256_cmp_ps(aValue, aMin, _CMP_LT_OQ), _mm256_sub_ps(aMin, aValue),
+                      Select(_mm256_cmp_ps(aValue, aMax, _CMP_GT_OQ), _mm256_sub_ps(aMax, aValue), zero));
+    };
+
+    for (uint32_t i = 0; i < count; i += 8)
+    {
+        const auto dx = axisDistance(pointX, _mm256_loadu_ps(&aBoxes.minX[i]), _mm256_loadu_ps(&aBoxes.maxX[i]));
+        const auto dy = axisDistance(pointY, _mm256_loadu_ps(&aBoxes.minY[i]), _mm256_loadu_ps(&aBoxes.maxY[i]));
+        const auto dz = axisDistance(pointZ, _mm256_loadu_ps(&aBoxes.minZ[i]), _mm256_loadu_ps(&aBoxes.maxZ[i]));
+
+        const auto distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)),
+                                            _mm256_mul_ps(dz, dz));
+
+        _mm256_storeu_ps(aResults + i, distance);
+    }
+
+    return count;
+}
+
+uint32_t IntersectAVX2(const Red::Vector4& aOrigin, const Red::Vector4& aInverseDirection,
+                       const Red::BoxBatch& aBoxes, bool* aResults)
+{
+    const auto count = aBoxes.GetSize() & ~7u;
+    const auto originX = _mm256_set1_ps(aOrigin.X);
+    const auto originY = _mm256_set1_ps(aOrigin.Y);
+    const auto originZ = _mm256_set1_ps(aOrigin.Z);
+    const auto inverseX = _mm256_set1_ps(aInverseDirection.X);
+    const auto inverseY = _mm256_set1_ps(aInverseDirection.Y);
+    const auto inverseZ = _mm256_set1_ps(aInverseDirection.Z);
+
+    for (uint32_t i = 0; i < count; i += 8)
+    {
+        const auto tx1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&aBoxes.minX[i]), originX), inverseX);
+        const auto tx2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&aBoxes.maxX[i]), originX), inverseX);
+
+        auto tmin = Min(tx1, tx2);
+        auto tmax = Max(tx1, tx2);
+
+        const auto ty1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&aBoxes.minY[i]), originY), inverseY);
+        const auto ty2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&aBoxes.maxY[i]), originY), inverseY);
+
+        tmin = Max(tmin, Min(ty1, ty2));
+        tmax = Min(tmax, Max(ty1, ty2));
+
+        const auto tz1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&aBoxes.minZ[i]), originZ), inverseZ);
+        const auto tz2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&aBoxes.maxZ[i]), originZ), inverseZ);
+
+        tmin = Max(tmin, Min(tz1, tz2));
+        tmax = Min(tmax, Max(tz1, tz2));
+
+        const auto hits = _mm256_movemask_ps(_mm256_cmp_ps(tmax, Max(_mm256_setzero_ps(), tmin), _CMP_GE_OQ));
+
+        for (auto lane = 0; lane < 8; ++lane)
+        {
+            aResults[i + lane] = (hits >> lane) & 1;
+        }
+    }
+
+    return count;
+}
+
+bool IsAVX2Supported()
+{
+    int info[4];
+
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+
+    __cpuid(info, 1);
+    const auto osxsave = (info[2] & (1 << 27)) != 0;
+    const auto avx = (info[2] & (1 << 28)) != 0;
+
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+}
+
+Red::BoxBatchKernel s_supportedKernel = IsAVX2Supported() ? Red::BoxBatchKernel::AVX2 : Red::BoxBatchKernel::SSE;
+Red::BoxBatchKernel s_kernel = s_supportedKernel;
+}
+
+void Red::TestFrustum(const Frustum& aFrustum, const BoxBatch& aBoxes, FrustumResult* aResults)
+{
+    const auto planes = GetFrustumPlanes(aFrustum);
+    uint32_t processed = 0;
+
+    switch (s_kernel)
+    {
+    case BoxBatchKernel::AVX2:
+        processed = TestFrustumAVX2(aFrustum, planes, aBoxes, aResults);
+        break;
+    case BoxBatchKernel::SSE:
+        processed = TestFrustumSSE(aFrustum, planes, aBoxes, aResults);
+        break;
+    default:
+        break;
+    }
+
+    TestFrustumScalar(aFrustum, planes, aBoxes, aResults, processed, aBoxes.GetSize());
+}
+
+void Red::DistanceSquared(const Vector4& aPoint, const BoxBatch& aBoxes, float* aResults)
+{
+    uint32_t processed = 0;
+
+    switch (s_kernel)
+    {
+    case BoxBatchKernel::AVX2:
+        processed = DistanceSquaredAVX2(aPoint, aBoxes, aResults);
+        break;
+    case BoxBatchKernel::SSE:
+        processed = DistanceSquaredSSE(aPoint, aBoxes, aResults);
+        break;
+    default:
+        break;
+    }
+
+    DistanceSquaredScalar(aPoint, aBoxes, aResults, processed, aBoxes.GetSize());
+}
+
+void Red::Intersect(const Vector4& aOrigin, const Vector4& aInverseDirection, const BoxBatch& aBoxes, bool* aResults)
+{
+    uint32_t processed = 0;
+
+    switch (s_kernel)
+    {
+    case BoxBatchKernel::AVX2:
+        processed = IntersectAVX2(aOrigin, aInverseDirection, aBoxes, aResults);
+        break;
+    case BoxBatchKernel::SSE:
+        processed = IntersectSSE(aOrigin, aInverseDirection, aBoxes, aResults);
+        break;
+    default:
+        break;
+    }
+
+    IntersectScalar(aOrigin, aInverseDirection, aBoxes, aResults, processed, aBoxes.GetSize());
+}
+
+Red::BoxBatchKernel Red::GetBoxBatchKernel()
+{
+    return s_kernel;
+}
+
+Red::BoxBatchKernel Red::SetBoxBatchKernel(BoxBatchKernel aKernel)
+{
+    s_kernel = (aKernel > s_supportedKernel) ? s_supportedKernel : aKernel;
+    return s_kernel;
+}
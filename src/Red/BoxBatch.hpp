@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Red/Frustum.hpp"
+
+namespace Red
+{
+enum class BoxBatchKernel
+{
+    Scalar,
+    SSE,
+    AVX2,
+};
+
+// Axis aligned boxes stored as separate arrays per component, so that several boxes can be tested at once.
+// The boxes are expected to have W = 1 as produced by the transform helpers, W isn't stored.
+struct BoxBatch
+{
+    [[nodiscard]] uint32_t GetSize() const
+    {
+        return static_cast<uint32_t>(minX.size());
+    }
+
+    [[nodiscard]] bool IsEmpty() const
+    {
+        return minX.empty();
+    }
+
+    [[nodiscard]] Box Get(uint32_t aIndex) const
+    {
+        return {{minX[aIndex], minY[aIndex], minZ[aIndex], 1.0f}, {maxX[aIndex], maxY[aIndex], maxZ[aIndex], 1.0f}};
+    }
+
+    void Set(uint32_t aIndex, const Box& aBox)
+    {
+        minX[aIndex] = aBox.Min.X;
+        minY[aIndex] = aBox.Min.Y;
+        minZ[aIndex] = aBox.Min.Z;
+        maxX[aIndex] = aBox.Max.X;
+        maxY[aIndex] = aBox.Max.Y;
+        maxZ[aIndex] = aBox.Max.Z;
+    }
+
+    void Push(const Box& aBox)
+    {
+        minX.push_back(aBox.Min.X);
+        minY.push_back(aBox.Min.Y);
+        minZ.push_back(aBox.Min.Z);
+        maxX.push_back(aBox.Max.X);
+        maxY.push_back(aBox.Max.Y);
+        maxZ.push_back(aBox.Max.Z);
+    }
+
+    void Pop()
+    {
+        minX.pop_back();
+        minY.pop_back();
+        minZ.pop_back();
+        maxX.pop_back();
+        maxY.pop_back();
+        maxZ.pop_back();
+    }
+
+    void Reserve(uint32_t aSize)
+    {
+        minX.reserve(aSize);
+        minY.reserve(aSize);
+        minZ.reserve(aSize);
+        maxX.reserve(aSize);
+        maxY.reserve(aSize);
+        maxZ.reserve(aSize);
+    }
+
+    void Clear()
+    {
+        minX.clear();
+        minY.clear();
+        minZ.clear();
+        maxX.clear();
+        maxY.clear();
+        maxZ.clear();
+    }
+
+    [[nodiscard]] size_t GetMemorySize() const
+    {
+        return (minX.capacity() + minY.capacity() + minZ.capacity() + maxX.capacity() + maxY.capacity() +
+                maxZ.capacity()) * sizeof(float);
+    }
+
+    Core::Vector<float> minX;
+    Core::Vector<float> minY;
+    Core::Vector<float> minZ;
+    Core::Vector<float> maxX;
+    Core::Vector<float> maxY;
+    Core::Vector<float> maxZ;
+};
+
+// Batched versions of Frustum::Test, DistanceSquared and Intersect.
+// All kernels produce the same results as the single box functions, support/boxbatch checks it on edge cases.
+// The widest supported kernel is picked at startup.
+// The result buffers must have room for the whole batch.
+void TestFrustum(const Frustum& aFrustum, const BoxBatch& aBoxes, FrustumResult* aResults);
+void DistanceSquared(const Vector4& aPoint, const BoxBatch& aBoxes, float* aResults);
+void Intersect(const Vector4& aOrigin, const Vector4& aInverseDirection, const BoxBatch& aBoxes, bool* aResults);
+
+BoxBatchKernel GetBoxBatchKernel();
+BoxBatchKernel SetBoxBatchKernel(BoxBatchKernel aKernel);
+}
@@ -0,0 +1,291 @@
+#include "BoxTree.hpp"
+#include "Red/Math.hpp"
+
+#include <cfloat>
+#include <numeric>
+
+namespace
+{
+constexpr auto MaxStackSize = 64u;
+
+float GetDoubleCenter(const Red::BoxBatch& aBoxes, uint32_t aIndex, uint32_t aAxis)
+{
+    switch (aAxis)
+    {
+    case 0:
+        return aBoxes.minX[aIndex] + aBoxes.maxX[aIndex];
+    case 1:
+        return aBoxes.minY[aIndex] + aBoxes.maxY[aIndex];
+    default:
+        return aBoxes.minZ[aIndex] + aBoxes.maxZ[aIndex];
+    }
+}
+}
+
+void Red::BoxTree::Build(BoxBatch& aBoxes)
+{
+    Clear();
+
+    const auto boxCount = aBoxes.GetSize();
+
+    if (boxCount == 0)
+        return;
+
+    m_sourceIndexes.resize(boxCount);
+    std::iota(m_sourceIndexes.begin(), m_sourceIndexes.end(), 0u);
+
+    m_nodes.reserve(2 * (boxCount / LeafSize) + 1);
+    m_bounds.Reserve(2 * (boxCount / LeafSize) + 1);
+
+    BuildNode(aBoxes, 0, boxCount);
+
+    BoxBatch sortedBoxes;
+    sortedBoxes.Reserve(boxCount);
+
+    for (const auto& sourceIndex : m_sourceIndexes)
+    {
+        sortedBoxes.Push(aBoxes.Get(sourceIndex));
+    }
+
+    aBoxes = std::move(sortedBoxes);
+}
+
+void Red::BoxTree::Clear()
+{
+    m_nodes.clear();
+    m_bounds.Clear();
+    m_sourceIndexes.clear();
+}
+
+bool Red::BoxTree::IsEmpty() const
+{
+    return m_nodes.empty();
+}
+
+uint32_t Red::BoxTree::GetNodeCount() const
+{
+    return static_cast<uint32_t>(m_nodes.size());
+}
+
+uint32_t Red::BoxTree::GetSourceIndex(uint32_t aBoxIndex) const
+{
+    return m_sourceIndexes[aBoxIndex];
+}
+
+size_t Red::BoxTree::GetMemorySize() const
+{
+    return m_nodes.capacity() * sizeof(Node) + m_bounds.GetMemorySize() +
+           m_sourceIndexes.capacity() * sizeof(uint32_t);
+}
+
+uint32_t Red::BoxTree::BuildNode(const BoxBatch& aBoxes, uint32_t aBegin, uint32_t aEnd)
+{
+    const auto nodeIndex = static_cast<uint32_t>(m_nodes.size());
+
+    Box bounds{{FLT_MAX, FLT_MAX, FLT_MAX, 1.0f}, {-FLT_MAX, -FLT_MAX, -FLT_MAX, 1.0f}};
+    float centerMin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float centerMax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+    for (auto i = aBegin; i < aEnd; ++i)
+    {
+        const auto sourceIndex = m_sourceIndexes[i];
+
+        bounds.Min.X = std::min(bounds.Min.X, aBoxes.minX[sourceIndex]);
+        bounds.Min.Y = std::min(bounds.Min.Y, aBoxes.minY[sourceIndex]);
+        bounds.Min.Z = std::min(bounds.Min.Z, aBoxes.minZ[sourceIndex]);
+        bounds.Max.X = std::max(bounds.Max.X, aBoxes.maxX[sourceIndex]);
+        bounds.Max.Y = std::max(bounds.Max.Y, aBoxes.maxY[sourceIndex]);
+        bounds.Max.Z = std::max(bounds.Max.Z, aBoxes.maxZ[sourceIndex]);
+
+        for (uint32_t axis = 0; axis < 3; ++axis)
+        {
+            const auto center = GetDoubleCenter(aBoxes, sourceIndex, axis);
+            centerMin[axis] = std::min(centerMin[axis], center);
+            centerMax[axis] = std::max(centerMax[axis], center);
+        }
+    }
+
+    m_nodes.push_back({aBegin, aEnd - aBegin});
+    m_bounds.Push(bounds);
+
+    if (aEnd - aBegin <= LeafSize)
+        return nodeIndex;
+
+    // Median split along the axis with the largest spread of centers, keeps the tree balanced for any distribution
+    uint32_t splitAxis = 0;
+    for (uint32_t axis = 1; axis < 3; ++axis)
+    {
+        if (centerMax[axis] - centerMin[axis] > centerMax[splitAxis] - centerMin[splitAxis])
+        {
+            splitAxis = axis;
+        }
+    }
+
+    const auto split = aBegin + (aEnd - aBegin) / 2;
+
+    std::nth_element(m_sourceIndexes.begin() + aBegin, m_sourceIndexes.begin() + split,
+                     m_sourceIndexes.begin() + aEnd,
+                     [&aBoxes, splitAxis](uint32_t a, uint32_t b)
+                     {
+                         return GetDoubleCenter(aBoxes, a, splitAxis) < GetDoubleCenter(aBoxes, b, splitAxis);
+                     });
+
+    BuildNode(aBoxes, aBegin, split);
+    const auto secondChild = BuildNode(aBoxes, split, aEnd);
+
+    m_nodes[nodeIndex] = {secondChild, 0};
+
+    return nodeIndex;
+}
+
+int32_t Red::BoxTree::FindNearest(Frustum& aFrustum, const BoxBatch& aBoxes, const Vector4& aOrigin,
+                                  float aMaxDistance, float& aDistance) const
+{
+    if (m_nodes.empty())
+        return -1;
+
+    int32_t nearestIndex = -1;
+    float nearestDistanceSquared = aMaxDistance * aMaxDistance;
+
+    std::pair<uint32_t, bool> stack[MaxStackSize];
+    uint32_t stackSize = 0;
+
+    stack[stackSize++] = {0, false};
+
+    while (stackSize)
+    {
+        auto [nodeIndex, inside] = stack[--stackSize];
+
+        alignas(16) const Box bounds = m_bounds.Get(nodeIndex);
+
+        if (DistanceSquared(aOrigin, bounds) > nearestDistanceSquared)
+            continue;
+
+        if (!inside)
+        {
+            const auto result = aFrustum.Test(bounds);
+
+            if (result == FrustumResult::Outside)
+                continue;
+
+            // Everything in the subtree is inside as well, so the frustum tests can be skipped
+            inside = (result == FrustumResult::Inside);
+        }
+
+        const auto& node = m_nodes[nodeIndex];
+
+        if (node.count)
+        {
+            for (auto boxIndex = node.first; boxIndex < node.first + node.count; ++boxIndex)
+            {
+                alignas(16) const Box box = aBoxes.Get(boxIndex);
+
+                const auto distanceSquared = DistanceSquared(aOrigin, box);
+
+                if (distanceSquared > nearestDistanceSquared)
+                    continue;
+
+                if (!inside && aFrustum.Test(box) == FrustumResult::Outside)
+                    continue;
+
+                nearestIndex = static_cast<int32_t>(boxIndex);
+                nearestDistanceSquared = distanceSquared;
+            }
+
+            continue;
+        }
+
+        // The nearer child is pushed last, so it's visited first and tightens the distance for the other one
+        const auto firstChild = nodeIndex + 1;
+        const auto secondChild = node.first;
+
+        if (DistanceSquared(aOrigin, m_bounds.Get(firstChild)) < DistanceSquared(aOrigin, m_bounds.Get(secondChild)))
+        {
+            stack[stackSize++] = {secondChild, inside};
+            stack[stackSize++] = {firstChild, inside};
+        }
+        else
+        {
+            stack[stackSize++] = {firstChild, inside};
+            stack[stackSize++] = {secondChild, inside};
+        }
+    }
+
+    if (nearestIndex >= 0)
+    {
+        aDistance = sqrtf(nearestDistanceSquared);
+    }
+
+    return nearestIndex;
+}
+
+int32_t Red::BoxTree::FindNearest(const Vector4& aOrigin, const Vector4& aInverseDirection, const BoxBatch& aBoxes,
+                                  float aMinDistance, float aMaxDistance, float& aDistance) const
+{
+    if (m_nodes.empty())
+        return -1;
+
+    int32_t nearestIndex = -1;
+    float nearestDistanceSquared = aMaxDistance * aMaxDistance;
+    const auto minDistanceSquared = aMinDistance * aMinDistance;
+
+    uint32_t stack[MaxStackSize];
+    uint32_t stackSize = 0;
+
+    stack[stackSize++] = 0;
+
+    while (stackSize)
+    {
+        const auto nodeIndex = stack[--stackSize];
+        const auto bounds = m_bounds.Get(nodeIndex);
+
+        if (DistanceSquared(aOrigin, bounds) > nearestDistanceSquared)
+            continue;
+
+        if (!Intersect(aOrigin, aInverseDirection, bounds))
+            continue;
+
+        const auto& node = m_nodes[nodeIndex];
+
+        if (node.count)
+        {
+            for (auto boxIndex = node.first; boxIndex < node.first + node.count; ++boxIndex)
+            {
+                const auto box = aBoxes.Get(boxIndex);
+                const auto distanceSquared = DistanceSquared(aOrigin, box);
+
+                if (distanceSquared > nearestDistanceSquared || distanceSquared < minDistanceSquared)
+                    continue;
+
+                if (!Intersect(aOrigin, aInverseDirection, box))
+                    continue;
+
+                nearestIndex = static_cast<int32_t>(boxIndex);
+                nearestDistanceSquared = distanceSquared;
+            }
+
+            continue;
+        }
+
+        const auto firstChild = nodeIndex + 1;
+        const auto secondChild = node.first;
+
+        if (DistanceSquared(aOrigin, m_bounds.Get(firstChild)) < DistanceSquared(aOrigin, m_bounds.Get(secondChild)))
+        {
+            stack[stackSize++] = secondChild;
+            stack[stackSize++] = firstChild;
+        }
+        else
+        {
+            stack[stackSize++] = firstChild;
+            stack[stackSize++] = secondChild;
+        }
+    }
+
+    if (nearestIndex >= 0)
+    {
+        aDistance = sqrtf(nearestDistanceSquared);
+    }
+
+    return nearestIndex;
+}
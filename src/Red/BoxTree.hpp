@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Red/BoxBatch.hpp"
+
+namespace Red
+{
+// Bounding volume hierarchy over a fixed set of boxes, built once and never updated.
+// Building reorders the boxes so that every leaf covers a contiguous range, the original indices are kept.
+// Inner nodes are stored in depth first order, so the first child directly follows its parent.
+class BoxTree
+{
+public:
+    static constexpr auto LeafSize = 8u;
+
+    void Build(BoxBatch& aBoxes);
+    void Clear();
+
+    [[nodiscard]] bool IsEmpty() const;
+    [[nodiscard]] uint32_t GetNodeCount() const;
+    [[nodiscard]] uint32_t GetSourceIndex(uint32_t aBoxIndex) const;
+    [[nodiscard]] size_t GetMemorySize() const;
+
+    // Finds the nearest box not outside of the frustum and not farther than the distance from the origin.
+    // Returns the index of the box in the reordered batch or -1.
+    int32_t FindNearest(Frustum& aFrustum, const BoxBatch& aBoxes, const Vector4& aOrigin, float aMaxDistance,
+                        float& aDistance) const;
+
+    // Finds the nearest box hit by the ray with the distance from the origin in the range.
+    // Returns the index of the box in the reordered batch or -1.
+    int32_t FindNearest(const Vector4& aOrigin, const Vector4& aInverseDirection, const BoxBatch& aBoxes,
+                        float aMinDistance, float aMaxDistance, float& aDistance) const;
+
+private:
+    struct Node
+    {
+        uint32_t first; // First box of a leaf or the second child of an inner node
+        uint32_t count; // Number of boxes of a leaf or zero for an inner node
+    };
+
+    uint32_t BuildNode(const BoxBatch& aBoxes, uint32_t aBegin, uint32_t aEnd);
+
+    Core::Vector<Node> m_nodes;
+    BoxBatch m_bounds;
+    Core::Vector<uint32_t> m_sourceIndexes;
+};
+}
@@ -0,0 +1,292 @@
+// Checks that every box batch kernel returns exactly the results of the single box functions.
+// The batches cover NaNs, infinities, signed zeros, denormals and sizes that aren't multiples of the vector width.
+// Builds with the compat header of the replay tool, for example:
+//   g++ -std=c++20 -O2 -mavx2 -mfma -ffp-contract=off -Isrc -Isupport/worldtrace/compat -include Compat.hpp
+//       support/boxbatch/main.cpp src/Red/BoxBatch.cpp -o boxbatch
+#include "Red/BoxBatch.hpp"
+#include "Red/Math.hpp"
+
+#include <bit>
+#include <charconv>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <string_view>
+
+namespace
+{
+constexpr Red::BoxBatchKernel Kernels[] = {Red::BoxBatchKernel::Scalar, Red::BoxBatchKernel::SSE,
+                                           Red::BoxBatchKernel::AVX2};
+
+constexpr uint32_t MaxBatchSize = 67;
+
+const char* GetKernelName(Red::BoxBatchKernel aKernel)
+{
+    switch (aKernel)
+    {
+    case Red::BoxBatchKernel::Scalar:
+        return "scalar";
+    case Red::BoxBatchKernel::SSE:
+        return "sse";
+    case Red::BoxBatchKernel::AVX2:
+        return "avx2";
+    default:
+        return "unknown";
+    }
+}
+
+// Values picked from this list hit the corner cases of the comparisons and of the sign tests
+constexpr float SpecialValues[] = {
+    0.0f,
+    -0.0f,
+    1.0f,
+    -1.0f,
+    std::numeric_limits<float>::quiet_NaN(),
+    -std::numeric_limits<float>::quiet_NaN(),
+    std::numeric_limits<float>::infinity(),
+    -std::numeric_limits<float>::infinity(),
+    std::numeric_limits<float>::denorm_min(),
+    -std::numeric_limits<float>::denorm_min(),
+    std::numeric_limits<float>::max(),
+    -std::numeric_limits<float>::max(),
+};
+
+class Generator
+{
+public:
+    explicit Generator(uint64_t aSeed)
+        : m_random(aSeed)
+    {
+    }
+
+    float Value()
+    {
+        if (m_random() % 4 == 0)
+            return SpecialValues[m_random() % std::size(SpecialValues)];
+
+        return std::uniform_real_distribution<float>(-100.0f, 100.0f)(m_random);
+    }
+
+    Red::Box Box()
+    {
+        // Mostly regular boxes around the origin, so that all frustum results show up
+        if (m_random() % 4 != 0)
+        {
+            std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+            std::uniform_real_distribution<float> extent(0.0f, 20.0f);
+
+            const Red::Vector4 center{position(m_random), position(m_random), position(m_random), 1.0f};
+            const Red::Vector4 size{extent(m_random), extent(m_random), extent(m_random), 1.0f};
+
+            return {{center.X - size.X, center.Y - size.Y, center.Z - size.Z, 1.0f},
+                    {center.X + size.X, center.Y + size.Y, center.Z + size.Z, 1.0f}};
+        }
+
+        return {{Value(), Value(), Value(), 1.0f}, {Value(), Value(), Value(), 1.0f}};
+    }
+
+    Red::Vector4 Point()
+    {
+        return {Value(), Value(), Value(), 1.0f};
+    }
+
+    Red::Frustum Frustum()
+    {
+        Red::Frustum frustum{};
+
+        for (auto i = 0; i < Red::Frustum::NumberOfPlanes; ++i)
+        {
+            const auto special = m_random() % 8 == 0;
+            std::uniform_real_distribution<float> component(-1.0f, 1.0f);
+
+            float plane[4];
+            float mask[4];
+
+            for (auto j = 0; j < 4; ++j)
+            {
+                plane[j] = special ? Value() : component(m_random) * (j == 3 ? 50.0f : 1.0f);
+            }
+
+            // The game derives the masks from the plane signs, arbitrary masks are tested as well
+            for (auto j = 0; j < 4; ++j)
+            {
+                const auto set = (m_random() % 8 == 0) ? (m_random() % 2 == 0) : !std::signbit(plane[j]);
+                mask[j] = std::bit_cast<float>(set ? 0xFFFFFFFFu : 0u);
+            }
+
+            frustum.planes[i] = _mm_loadu_ps(plane);
+            frustum.masks[i] = _mm_loadu_ps(mask);
+        }
+
+        return frustum;
+    }
+
+private:
+    std::mt19937_64 m_random;
+};
+
+struct Mismatches
+{
+    uint64_t frustum{0};
+    uint64_t distance{0};
+    uint64_t intersect{0};
+    uint64_t checks{0};
+};
+
+void PrintBox(const Red::Box& aBox)
+{
+    std::fprintf(stderr, "  box (%a %a %a) (%a %a %a)\n", aBox.Min.X, aBox.Min.Y, aBox.Min.Z, aBox.Max.X, aBox.Max.Y,
+                 aBox.Max.Z);
+}
+
+void CheckBatch(Generator& aGenerator, const Red::BoxBatch& aBoxes, Mismatches& aMismatches)
+{
+    const auto size = aBoxes.GetSize();
+
+    // One slot past the end catches kernels that write outside of the batch
+    Red::FrustumResult frustumResults[MaxBatchSize + 1];
+    float distanceResults[MaxBatchSize + 1];
+    bool intersectResults[MaxBatchSize + 1];
+
+    frustumResults[size] = Red::FrustumResult::Undefined;
+    distanceResults[size] = -1.0f;
+    intersectResults[size] = false;
+
+    const auto frustum = aGenerator.Frustum();
+    const auto point = aGenerator.Point();
+    const auto origin = aGenerator.Point();
+    const auto inverseDirection = aGenerator.Point();
+
+    Red::TestFrustum(frustum, aBoxes, frustumResults);
+    Red::DistanceSquared(point, aBoxes, distanceResults);
+    Red::Intersect(origin, inverseDirection, aBoxes, intersectResults);
+
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        const auto box = aBoxes.Get(i);
+        const auto frustumResult = frustum.Test(box);
+        const auto distanceResult = Red::DistanceSquared(point, box);
+        const auto intersectResult = Red::Intersect(origin, inverseDirection, box);
+
+        if (frustumResults[i] != frustumResult)
+        {
+            if (!aMismatches.frustum)
+            {
+                std::fprintf(stderr, "frustum test of box %u/%u: %d instead of %d\n", i, size, frustumResults[i],
+                             frustumResult);
+                PrintBox(box);
+            }
+
+            ++aMismatches.frustum;
+        }
+
+        if (std::bit_cast<uint32_t>(distanceResults[i]) != std::bit_cast<uint32_t>(distanceResult))
+        {
+            if (!aMismatches.distance)
+            {
+                std::fprintf(stderr, "distance to box %u/%u: %a instead of %a, point (%a %a %a)\n", i, size,
+                             distanceResults[i], distanceResult, point.X, point.Y, point.Z);
+                PrintBox(box);
+            }
+
+            ++aMismatches.distance;
+        }
+
+        if (intersectResults[i] != intersectResult)
+        {
+            if (!aMismatches.intersect)
+            {
+                std::fprintf(stderr, "intersection with box %u/%u: %d instead of %d, ray (%a %a %a) (%a %a %a)\n", i,
+                             size, intersectResults[i], intersectResult, origin.X, origin.Y, origin.Z,
+                             inverseDirection.X, inverseDirection.Y, inverseDirection.Z);
+                PrintBox(box);
+            }
+
+            ++aMismatches.intersect;
+        }
+
+        aMismatches.checks += 3;
+    }
+
+    if (frustumResults[size] != Red::FrustumResult::Undefined ||
+        std::bit_cast<uint32_t>(distanceResults[size]) != std::bit_cast<uint32_t>(-1.0f) || intersectResults[size])
+    {
+        std::fprintf(stderr, "batch of %u boxes: results written past the end\n", size);
+        ++aMismatches.frustum;
+    }
+}
+
+int Check(uint32_t aIterations, uint64_t aSeed)
+{
+    auto failed = false;
+
+    for (const auto kernel : Kernels)
+    {
+        if (Red::SetBoxBatchKernel(kernel) != kernel)
+        {
+            std::printf("%-8s not supported by this CPU, skipped\n", GetKernelName(kernel));
+            continue;
+        }
+
+        // Every kernel sees the same batches
+        Generator generator(aSeed);
+        Mismatches mismatches;
+        Red::BoxBatch boxes;
+
+        for (uint32_t iteration = 0; iteration < aIterations; ++iteration)
+        {
+            for (uint32_t size = 0; size <= MaxBatchSize; size = (size < 17) ? size + 1 : size + 25)
+            {
+                boxes.Clear();
+
+                for (uint32_t i = 0; i < size; ++i)
+                {
+                    boxes.Push(generator.Box());
+                }
+
+                CheckBatch(generator, boxes, mismatches);
+            }
+        }
+
+        const auto total = mismatches.frustum + mismatches.distance + mismatches.intersect;
+
+        std::printf("%-8s %llu checks, %llu frustum, %llu distance, %llu intersect mismatches\n",
+                    GetKernelName(kernel), static_cast<unsigned long long>(mismatches.checks),
+                    static_cast<unsigned long long>(mismatches.frustum),
+                    static_cast<unsigned long long>(mismatches.distance),
+                    static_cast<unsigned long long>(mismatches.intersect));
+
+        failed |= total != 0;
+    }
+
+    return failed ? 1 : 0;
+}
+
+template<typename T>
+bool ParseNumber(std::string_view aText, T& aValue)
+{
+    const auto result = std::from_chars(aText.data(), aText.data() + aText.size(), aValue);
+    return result.ec == std::errc() && result.ptr == aText.data() + aText.size();
+}
+
+void PrintUsage()
+{
+    std::fprintf(stderr, "usage:\n"
+                         "  boxbatch [iterations] [seed]  compare all supported kernels with the single box tests\n");
+}
+}
+
+int main(int aArgc, char** aArgv)
+{
+    uint32_t iterations = 2000;
+    uint64_t seed = 1;
+
+    if (aArgc > 3 || (aArgc > 1 && !ParseNumber(aArgv[1], iterations)) ||
+        (aArgc > 2 && !ParseNumber(aArgv[2], seed)))
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    return Check(iterations, seed);
+}
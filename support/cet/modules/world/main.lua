@@ -73,6 +73,7 @@ local userStateSchema = {
 local function syncInspectionSystemState()
     inspectionSystem:SetFrustumDistance(userState.frustumDistance)
     inspectionSystem:SetTargetingDistance(userState.targetingDistance)
+    inspectionSystem:SetCrosshairLimit(userState.maxTargets)
 
     userState.frustumDistance = inspectionSystem:GetFrustumDistance()
     userState.targetingDistance = inspectionSystem:GetTargetingDistance()
@@ -224,10 +225,6 @@ local function getLookAtTargets(maxDistance)
             return
         end
 
-        while #results > userState.maxTargets do
-            table.remove(results)
-        end
-
         return results
     end
 end
@@ -738,90 +735,104 @@ local function fillTargetCommunityData(target, data)
     end
 end
 
-local function fillTargetNodeData(target, data)
-    local sectorData
-    if IsDefined(target.nodeInstance) then
-        sectorData = inspectionSystem:ResolveSectorDataFromNodeInstance(target.nodeInstance)
-    elseif isNotEmpty(target.nodeID) then
-        sectorData = inspectionSystem:ResolveSectorDataFromNodeID(target.nodeID)
-    end
-    if sectorData and sectorData.sectorHash ~= 0 then
-        data.sectorPath = RedHotTools.GetResourcePath(sectorData.sectorHash)
-        data.instanceIndex = sectorData.instanceIndex
-        data.instanceCount = sectorData.instanceCount
-        data.nodeIndex = sectorData.nodeIndex
-        data.nodeCount = sectorData.nodeCount
-        data.nodeType = sectorData.nodeType.value
-        data.nodeID = sectorData.nodeID
-        data.parentID = sectorData.parentID
-        data.debugName = sectorData.debugName
-    end
-
-    if IsDefined(target.nodeDefinition) then
-        local node = target.nodeDefinition
-        data.nodeType = RedHotTools.GetTypeName(node).value
+local function fillTargetSectorData(sectorData, data)
+    data.sectorPath = RedHotTools.GetResourcePath(sectorData.sectorHash)
+    data.instanceIndex = sectorData.instanceIndex
+    data.instanceCount = sectorData.instanceCount
+    data.nodeIndex = sectorData.nodeIndex
+    data.nodeCount = sectorData.nodeCount
+    data.nodeType = sectorData.nodeType.value
+    data.nodeID = sectorData.nodeID
+    data.parentID = sectorData.parentID
+    data.debugName = sectorData.debugName
+end
 
-        if RedHotTools.IsInstanceOf(node, 'worldMeshNode')
-        or RedHotTools.IsInstanceOf(node, 'worldInstancedMeshNode')
-        or RedHotTools.IsInstanceOf(node, 'worldBendedMeshNode')
-        or RedHotTools.IsInstanceOf(node, 'worldFoliageNode')
-        or RedHotTools.IsInstanceOf(node, 'worldPhysicalDestructionNode') then
-            data.meshPath = RedHotTools.GetResourcePath(node.mesh.hash)
-            data.meshAppearance = node.meshAppearance.value
-        end
+local function fillTargetNodeData(target, data, nodeData)
+    if not nodeData and (IsDefined(target.nodeInstance) or IsDefined(target.nodeDefinition)) then
+        nodeData = inspectionSystem:ResolveTarget(target.nodeInstance, target.nodeDefinition)
+    end
 
-        if RedHotTools.IsInstanceOf(node, 'worldTerrainMeshNode') then
-            data.meshPath = RedHotTools.GetResourcePath(node.meshRef.hash)
+    if nodeData and nodeData.sectorHash ~= 0 then
+        data.sectorPath = nodeData.sectorPath
+        data.instanceIndex = nodeData.instanceIndex
+        data.instanceCount = nodeData.instanceCount
+        data.nodeIndex = nodeData.nodeIndex
+        data.nodeCount = nodeData.nodeCount
+        data.nodeID = nodeData.nodeID
+        data.parentID = nodeData.parentID
+        data.debugName = nodeData.debugName
+    elseif not IsDefined(target.nodeInstance) and isNotEmpty(target.nodeID) then
+        local sectorData = inspectionSystem:ResolveSectorDataFromNodeID(target.nodeID)
+        if sectorData.sectorHash ~= 0 then
+            fillTargetSectorData(sectorData, data)
         end
+    end
 
-        if RedHotTools.IsInstanceOf(node, 'worldStaticDecalNode') then
-            data.materialPath = RedHotTools.GetResourcePath(node.material.hash)
+    if nodeData then
+        if isNotEmpty(nodeData.nodeType.value) then
+            data.nodeType = nodeData.nodeType.value
         end
-
-        if RedHotTools.IsInstanceOf(node, 'worldEffectNode') then
-            data.effectPath = RedHotTools.GetResourcePath(node.effect.hash)
+        if isNotEmpty(nodeData.meshPath) then
+            data.meshPath = nodeData.meshPath
+            data.meshAppearance = nodeData.meshAppearance.value
         end
-
-        if RedHotTools.IsInstanceOf(node, 'worldPopulationSpawnerNode') then
-            data.recordID = node.objectRecordId.value
-            data.appearanceName = node.appearanceName.value
+        if isNotEmpty(nodeData.materialPath) then
+            data.materialPath = nodeData.materialPath
         end
-
-        if RedHotTools.IsInstanceOf(node, 'worldEntityNode') then
-            data.templatePath = RedHotTools.GetResourcePath(node.entityTemplate.hash)
-            data.appearanceName = node.appearanceName.value
+        if isNotEmpty(nodeData.effectPath) then
+            data.effectPath = nodeData.effectPath
         end
-
-        if RedHotTools.IsInstanceOf(node, 'worldDeviceNode') then
-            data.deviceClass = node.deviceClassName.value
+        if isNotEmpty(nodeData.templatePath) then
+            data.templatePath = nodeData.templatePath
         end
-
-        if RedHotTools.IsInstanceOf(node, 'worldTriggerAreaNode') then
+        if isNotEmpty(nodeData.recordID) then
+            data.recordID = nodeData.recordID
+        end
+        if isNotEmpty(nodeData.appearanceName.value) then
+            data.appearanceName = nodeData.appearanceName.value
+        end
+        if #nodeData.triggerNotifiers > 0 then
             data.triggerNotifiers = {}
-            for _, notifier in ipairs(node.notifiers) do
-                table.insert(data.triggerNotifiers, RedHotTools.GetTypeName(notifier).value)
+            for _, notifier in ipairs(nodeData.triggerNotifiers) do
+                table.insert(data.triggerNotifiers, notifier.value)
             end
         end
+        if isNotEmpty(nodeData.nodeRef) then
+            data.nodeRef = nodeData.nodeRef
+        end
+        if isNotEmpty(nodeData.parentRef) then
+            data.parentRef = nodeData.parentRef
+        end
+    end
 
-        if RedHotTools.IsInstanceOf(node, 'worldStaticOccluderMeshNode')
-        or RedHotTools.IsInstanceOf(node, 'worldInstancedOccluderNode') then
-            data.meshPath = RedHotTools.GetResourcePath(node.mesh.hash)
+    if nodeData and IsDefined(target.nodeDefinition) then
+        local node = target.nodeDefinition
+
+        if nodeData.isDeviceNode then
+            data.deviceClass = node.deviceClassName.value
+        end
+
+        if nodeData.isOccluderNode or nodeData.isInstancedOccluderNode then
             data.occluderType = node.occluderType.value
         end
 
-        if RedHotTools.IsInstanceOf(node, 'worldAISpotNode') and node.spot and node.spot.resource then
+        if nodeData.isAISpotNode and node.spot and node.spot.resource then
             data.workspotPath = RedHotTools.GetResourcePath(node.spot.resource.hash)
         end
     end
 
-    if isNotEmpty(data.nodeID) then
-        data.nodeRef = inspectionSystem:ResolveNodeRefFromNodeHash(data.nodeID)
-    elseif isNotEmpty(target.nodeID) then
-        data.nodeRef = inspectionSystem:ResolveNodeRefFromNodeHash(target.nodeID)
+    if isEmpty(data.nodeRef) then
+        if isNotEmpty(data.nodeID) then
+            data.nodeRef = inspectionSystem:ResolveNodeRefFromNodeHash(data.nodeID)
+        elseif isNotEmpty(target.nodeID) then
+            data.nodeRef = inspectionSystem:ResolveNodeRefFromNodeHash(target.nodeID)
+        end
     end
 
     if isNotEmpty(data.parentID) then
-        data.parentRef = inspectionSystem:ResolveNodeRefFromNodeHash(data.parentID)
+        if isEmpty(data.parentRef) then
+            data.parentRef = inspectionSystem:ResolveNodeRefFromNodeHash(data.parentID)
+        end
         if isNotEmpty(data.parentRef) then
             data.parentInstance = inspectionSystem:FindStreamedNode(data.parentID).nodeInstance
         end
@@ -831,16 +842,18 @@ local function fillTargetNodeData(target, data)
     data.nodeInstance = target.nodeInstance
 
     data.isNode = IsDefined(data.nodeInstance) or IsDefined(data.nodeDefinition) or isNotEmpty(data.nodeID)
-    data.isAreaNode = data.isNode and RedHotTools.IsInstanceOf(data.nodeDefinition, 'worldAreaShapeNode')
-    data.isOccluderNode = data.isNode and RedHotTools.IsInstanceOf(data.nodeDefinition, 'worldStaticOccluderMeshNode')
-    data.isProxyMeshNode = data.isNode and RedHotTools.IsInstanceOf(data.nodeDefinition, 'worldPrefabProxyMeshNode')
-    data.isCommunityNode = data.isNode and RedHotTools.IsInstanceOf(data.nodeDefinition, 'worldCompiledCommunityAreaNode')
-    data.isSpawnerNode = data.isNode and RedHotTools.IsInstanceOf(data.nodeDefinition, 'worldPopulationSpawnerNode')
+    data.isAreaNode = data.isNode and nodeData ~= nil and nodeData.isAreaNode
+    data.isOccluderNode = data.isNode and nodeData ~= nil and nodeData.isOccluderNode
+    data.isProxyMeshNode = data.isNode and nodeData ~= nil and nodeData.isProxyMeshNode
+    data.isCommunityNode = data.isNode and nodeData ~= nil and nodeData.isCommunityNode
+    data.isSpawnerNode = data.isNode and nodeData ~= nil and nodeData.isSpawnerNode
     data.isVisibleNode = data.isNode and (isNotEmpty(data.meshPath) or isNotEmpty(data.materialPath) or isNotEmpty(data.templatePath))
-        or RedHotTools.IsInstanceOf(data.nodeDefinition, 'worldStaticLightNode')
-    data.isCollisionNode = data.isNode and RedHotTools.IsInstanceOf(data.nodeDefinition, 'worldCollisionNode')
+        or (nodeData ~= nil and nodeData.isLightNode)
+    data.isCollisionNode = data.isNode and nodeData ~= nil and nodeData.isCollisionNode
 
-    if isNotEmpty(data.nodeType) then
+    if nodeData and isNotEmpty(nodeData.nodeGroup.value) then
+        data.nodeGroup = nodeData.nodeGroup.value
+    elseif isNotEmpty(data.nodeType) then
         data.nodeGroup = nodeGroupMapping[data.nodeType]
     end
 end
@@ -851,6 +864,7 @@ local function fillTargetGeomertyData(target, data)
     data.position = target.position
     data.orientation = target.orientation
     data.boundingBox = target.boundingBox
+    data.meshInstanceIndex = target.meshInstanceIndex
 
     if target.testBox and not target.testBox.Min:IsXYZZero() and target.testBox.Min.x <= target.testBox.Max.x then
         data.testBox = target.testBox
@@ -966,13 +980,13 @@ local function expandTarget(target)
     end
 end
 
-local function resolveTargetData(target)
+local function resolveTargetData(target, nodeData)
     expandTarget(target)
 
     local result = {}
     fillTargetEntityData(target, result)
     fillTargetCommunityData(target, result)
-    fillTargetNodeData(target, result)
+    fillTargetNodeData(target, result, nodeData)
     fillTargetGeomertyData(target, result)
     fillTargetDescription(target, result)
     fillTargetHash(target, result)
@@ -1128,7 +1142,14 @@ end
 local scanner = {
     requested = false,
     finished = false,
-    results = {},
+    generation = 0,
+    resolved = {},
+    total = 0,
+    matched = 0,
+    limit = 0,
+    pageSize = 200,
+    dirty = false,
+    groupsRegistered = false,
     distance = 0,
     group = '',
     term = nil,
@@ -1155,124 +1176,109 @@ local function scanTargets()
 
     scanner.requested = false
 
-    local results = {}
-
-    for _, target in ipairs(inspectionSystem:GetStreamedNodesInFrustum()) do
-        local result = resolveTargetData(target)
-        if result then
-            table.insert(results, result)
+    if not scanner.groupsRegistered then
+        for nodeType, nodeGroup in pairs(nodeGroupMapping) do
+            inspectionSystem:RegisterNodeGroup(nodeType, nodeGroup)
         end
+        inspectionSystem:SetScannerPageSize(scanner.pageSize)
+        scanner.groupsRegistered = true
     end
 
-    table.sort(results, function(a, b)
-        return a.distance < b.distance
-    end)
+    local changes = inspectionSystem:GetFrustumChanges(scanner.generation)
 
-    for index, result in ipairs(results) do
-        result.index = index
+    if changes.reset then
+        scanner.resolved = {}
+    end
+
+    for _, hash in ipairs(changes.removed) do
+        scanner.resolved[tostring(hash)] = nil
+    end
+
+    for _, target in ipairs(changes.moved) do
+        local result = scanner.resolved[tostring(target.hash)]
+        if result then
+            fillTargetGeomertyData(target, result)
+        end
     end
 
-    scanner.results = results
-    scanner.term = nil
-    scanner.filtered = results
+    scanner.generation = changes.generation
+    scanner.total = inspectionSystem:ScanFrustumNodes()
+    scanner.limit = scanner.pageSize
+    scanner.dirty = true
+    scanner.filtered = {}
     scanner.hovered = nil
     scanner.finished = true
 end
 
-local function filterTargetByDistance(target, distance)
-    return isEmpty(distance) or target.distance <= distance
-end
+local function resolveScannedTargets(targets)
+    local unresolved = {}
 
-local function filterTargetByGroup(target, group)
-    return isEmpty(group) or target.nodeGroup == group
-end
+    for _, target in ipairs(targets) do
+        if not scanner.resolved[tostring(target.hash)] then
+            table.insert(unresolved, target)
+        end
+    end
 
-local partialMatchFields = {
-    'nodeType',
-    'nodeRef',
-    'parentRef',
-    'sectorPath',
-    'meshPath',
-    'materialPath',
-    'effectPath',
-    'templatePath',
-    'recordID',
-    'triggerNotifiers',
-}
+    if #unresolved > 0 then
+        local nodeData = inspectionSystem:ResolveTargets(unresolved)
+        for index, target in ipairs(unresolved) do
+            scanner.resolved[tostring(target.hash)] = resolveTargetData(target, nodeData[index])
+        end
+    end
 
-local exactMatchFields = {
-    'instanceIndex',
-}
+    local results = {}
 
-local function buildQuery(term)
-    if isEmpty(term) then
-        return nil
+    for _, target in ipairs(targets) do
+        local result = scanner.resolved[tostring(target.hash)]
+        result.distance = target.distance
+        table.insert(results, result)
     end
 
-    local exact = term:upper()
-    local escaped = exact:gsub('([^%w])', '%%%1')
-    local wildcard = escaped:gsub('%s+', '.* ') .. '.*'
-
-    return {
-        exact = exact,
-        escaped = escaped,
-        wildcard = wildcard,
-    }
+    return results
 end
 
-local function filterTargetByQuery(target, query)
-    if isEmpty(query) then
-        return true
-    end
-
-    for _, field in ipairs(exactMatchFields) do
-        if isNotEmpty(target[field]) then
-            local value = tostring(target[field]):upper()
-            if value == query.exact then
-                return true
-            end
-        end
-    end
+local function getScannedResults()
+    local query = inspectionSystem:QueryScannedNodes(0, '', '', 0, scanner.total)
+    return resolveScannedTargets(query.nodes)
+end
 
-    for _, field in ipairs(partialMatchFields) do
-        if type(target[field]) == 'table' then
-            for _, item in ipairs(target[field]) do
-                local value = tostring(item):upper()
-                if value:find(query.escaped) or value:find(query.wildcard) then
-                    return true
-                end
-            end
-        elseif isNotEmpty(target[field]) then
-            local value = tostring(target[field]):upper()
-            if value:find(query.escaped) or value:find(query.wildcard) then
-                return true
-            end
-        end
+local function getFilteredScannedResults()
+    if #scanner.filtered == scanner.matched then
+        return scanner.filtered
     end
 
-    return false
+    local query = inspectionSystem:QueryScannedNodes(scanner.distance or 0, scanner.group or '', scanner.term or '', 0, scanner.matched)
+    return resolveScannedTargets(query.nodes)
 end
 
 local function filterTargets(maxDistance, group, term)
-    if scanner.group == group and scanner.term == term and scanner.distance == maxDistance then
+    if scanner.group == group and scanner.term == term and scanner.distance == maxDistance and not scanner.dirty then
         return
     end
 
-    local filtered = {}
-    local query = buildQuery(term)
-
-    for _, result in ipairs(scanner.results) do
-        if filterTargetByDistance(result, maxDistance)
-        and filterTargetByGroup(result, group)
-        and filterTargetByQuery(result, query) then
-            table.insert(filtered, result)
-        end
+    if scanner.group ~= group or scanner.term ~= term or scanner.distance ~= maxDistance then
+        scanner.limit = scanner.pageSize
     end
 
+    local query = inspectionSystem:QueryScannedNodes(maxDistance or 0, group or '', term or '', 0, scanner.limit)
+
     scanner.distance = maxDistance
     scanner.group = group
     scanner.term = term
-    scanner.filtered = filtered
+    scanner.dirty = false
+    scanner.total = query.total
+    scanner.matched = query.matched
+    scanner.filtered = resolveScannedTargets(query.nodes)
+    scanner.hovered = nil
+
+    for index, result in ipairs(scanner.filtered) do
+        result.index = index
+    end
+end
+
+local function showMoreScannedResults()
+    scanner.limit = scanner.limit + scanner.pageSize
+    scanner.dirty = true
 end
 
 local function updateScanner(distance, group, filter)
@@ -1280,7 +1286,7 @@ local function updateScanner(distance, group, filter)
     filterTargets(distance, group, filter)
 
     if userState.highlightScannerResult and scanner.hovered then
-        highlightTarget(scanner.results[scanner.hovered])
+        highlightTarget(scanner.filtered[scanner.hovered])
     end
 end
 
@@ -1716,6 +1722,10 @@ local function isValidNodeIndex(data)
         and type(data.instanceCount) == 'number' and data.instanceCount > 0
 end
 
+local function isValidMeshInstanceIndex(data)
+    return type(data.meshInstanceIndex) == 'number' and data.meshInstanceIndex >= 0
+end
+
 local function isValidCommunityIndex(data)
     return type(data.communityIndex) == 'number' and data.communityIndex >= 0
         and type(data.communityCount) == 'number' and data.communityCount > 0
@@ -1749,6 +1759,7 @@ local resultSchema = {
         { name = 'nodeCount', label = '/', format = '%d', inline = true, validate = isValidNodeIndex },
         { name = 'instanceIndex', label = 'Node Instance:', format = '%d', validate = isValidNodeIndex },
         { name = 'instanceCount', label = '/', format = '%d', inline = true, validate = isValidNodeIndex },
+        { name = 'meshInstanceIndex', label = 'Mesh Instance:', format = '%d', validate = isValidMeshInstanceIndex },
         { name = 'debugName', label = 'Debug Name:' },
     },
     {
@@ -2134,7 +2145,7 @@ local function drawScannerContent()
         end
 
         ImGui.Spacing()
-        if #scanner.results > 0 then
+        if scanner.total > 0 then
             ImGui.Separator()
             ImGui.Spacing()
 
@@ -2189,7 +2200,7 @@ local function drawScannerContent()
             ImGui.AlignTextToFramePadding()
             ImGui.Text('Showing:')
             ImGui.SameLine()
-            ImGui.Text(('%d / %d'):format(#scanner.filtered, #scanner.results))
+            ImGui.Text(('%d / %d'):format(scanner.matched, scanner.total))
             --ImGui.PopStyleColor()
             ImGui.SameLine()
             local expandlAll = ImGui.Button('Expand all')
@@ -2199,7 +2210,7 @@ local function drawScannerContent()
             ImGui.SameLine()
             if ImGui.Button('Copy sectors') then
                 local sectors = {}
-                for _, result in ipairs(scanner.filtered) do
+                for _, result in ipairs(getFilteredScannedResults()) do
                     if isNotEmpty(result.sectorPath) and not sectors[result.sectorPath] then
                         sectors[result.sectorPath] = result.sectorPath
                         table.insert(sectors, result.sectorPath)
@@ -2253,6 +2264,13 @@ local function drawScannerContent()
                 ImGui.EndChildFrame()
                 ImGui.PopStyleColor()
                 ImGui.PopStyleVar(3)
+
+                if #scanner.filtered < scanner.matched then
+                    ImGui.Spacing()
+                    if ImGui.Button(('Show more (%d hidden)'):format(scanner.matched - #scanner.filtered), viewStyle.windowWidth, viewStyle.buttonHeight) then
+                        showMoreScannedResults()
+                    end
+                end
             else
                 ImGui.PushStyleColor(ImGuiCol.Text, viewStyle.mutedTextColor)
                 ImGui.TextWrapped('No matches')
@@ -2484,6 +2502,7 @@ local function drawSettingsContent()
     state, changed = ImGui.InputInt('##StaticMeshTargets', userState.maxTargets, 1, 10, ImGuiInputTextFlags.None)
     if changed then
         userState.maxTargets = MathEx.Clamp(state, 1, 16)
+        syncInspectionSystemState()
     end
     ImGui.EndGroup()
     if ImGui.IsItemHovered() then
@@ -3129,12 +3148,8 @@ return {
         GetWorldInspectorTargets = function()
             return inspector.results
         end,
-        GetWorldScannerResults = function()
-            return scanner.results
-        end,
-        GetWorldScannerFilteredResults = function ()
-            return scanner.filtered
-        end,
+        GetWorldScannerResults = getScannedResults,
+        GetWorldScannerFilteredResults = getFilteredScannedResults,
         GetLookupResult = function()
             return lookup.result
         end,
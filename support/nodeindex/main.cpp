@@ -0,0 +1,295 @@
+#include "App/World/WorldNodeIndexFormat.hpp"
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+namespace Format = App::WorldNodeIndexFormat;
+
+bool ReadIndex(const std::filesystem::path& aPath, Format::Header& aHeader, std::vector<Format::Record>& aRecords)
+{
+    std::error_code error;
+    const auto fileSize = std::filesystem::file_size(aPath, error);
+
+    if (error)
+    {
+        std::fprintf(stderr, "%s: can't read file size\n", aPath.string().c_str());
+        return false;
+    }
+
+    std::ifstream file(aPath, std::ios::binary);
+    file.read(reinterpret_cast<char*>(&aHeader), sizeof(aHeader));
+
+    if (!file || !Format::IsValidHeader(aHeader, fileSize))
+    {
+        std::fprintf(stderr, "%s: not a node index or unsupported version\n", aPath.string().c_str());
+        return false;
+    }
+
+    const auto recordCount = Format::GetRecordCount(fileSize);
+    const auto offset = aRecords.size();
+
+    aRecords.resize(offset + recordCount);
+    file.read(reinterpret_cast<char*>(aRecords.data() + offset),
+              static_cast<std::streamsize>(recordCount * sizeof(Format::Record)));
+
+    if (!file)
+    {
+        std::fprintf(stderr, "%s: truncated records\n", aPath.string().c_str());
+        return false;
+    }
+
+    return true;
+}
+
+template<typename T>
+bool ParseField(std::string_view& aLine, T& aValue)
+{
+    auto separator = aLine.find(',');
+    auto field = aLine.substr(0, separator);
+    auto base = 10;
+
+    if (field.starts_with("0x"))
+    {
+        field.remove_prefix(2);
+        base = 16;
+    }
+
+    auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), aValue, base);
+
+    aLine.remove_prefix(separator == std::string_view::npos ? aLine.size() : separator + 1);
+
+    return error == std::errc() && end == field.data() + field.size();
+}
+
+// The stamp of a sector is a sum over its records, so it matches the one computed by the game for the same records
+void StampSectors(std::span<Format::Record> aRecords)
+{
+    std::unordered_map<uint64_t, uint64_t> sectorStamps;
+
+    for (const auto& record : aRecords)
+    {
+        sectorStamps[record.sectorHash] += Format::MakeSectorStamp(std::span(&record, 1));
+    }
+
+    for (auto& record : aRecords)
+    {
+        record.sectorStamp = sectorStamps[record.sectorHash];
+    }
+}
+
+// Text input has one record per line, the sector stamps are computed from all records of the file:
+// nodeID,sectorHash,nodeType,parentID,instanceIndex,instanceCount,nodeIndex,nodeCount
+bool ReadText(const std::filesystem::path& aPath, std::vector<Format::Record>& aRecords)
+{
+    std::ifstream file(aPath);
+
+    if (!file)
+    {
+        std::fprintf(stderr, "%s: can't open file\n", aPath.string().c_str());
+        return false;
+    }
+
+    std::string line;
+    size_t lineNumber = 0;
+    const auto offset = aRecords.size();
+
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::string_view fields(line);
+        Format::Record record{};
+
+        if (!ParseField(fields, record.nodeID) || !ParseField(fields, record.sectorHash) ||
+            !ParseField(fields, record.nodeType) || !ParseField(fields, record.parentID) ||
+            !ParseField(fields, record.instanceIndex) || !ParseField(fields, record.instanceCount) ||
+            !ParseField(fields, record.nodeIndex) || !ParseField(fields, record.nodeCount))
+        {
+            std::fprintf(stderr, "%s:%zu: malformed record\n", aPath.string().c_str(), lineNumber);
+            return false;
+        }
+
+        aRecords.push_back(record);
+    }
+
+    StampSectors(std::span(aRecords).subspan(offset));
+
+    return true;
+}
+
+int Build(const std::filesystem::path& aOutput, const std::vector<std::filesystem::path>& aInputs)
+{
+    std::vector<Format::Record> records;
+
+    for (const auto& input : aInputs)
+    {
+        Format::Header header{};
+
+        if (input.extension() == ".csv" || input.extension() == ".txt")
+        {
+            if (!ReadText(input, records))
+                return 1;
+        }
+        else if (!ReadIndex(input, header, records))
+        {
+            return 1;
+        }
+    }
+
+    Format::CompactRecords(records);
+
+    auto tempPath = aOutput;
+    tempPath += ".tmp";
+
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+
+        const auto header = Format::MakeHeader(records.size());
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(records.data()),
+                   static_cast<std::streamsize>(records.size() * sizeof(Format::Record)));
+
+        if (!file)
+        {
+            std::fprintf(stderr, "%s: write failed\n", tempPath.string().c_str());
+            return 1;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, aOutput, error);
+
+    if (error)
+    {
+        std::fprintf(stderr, "%s: %s\n", aOutput.string().c_str(), error.message().c_str());
+        return 1;
+    }
+
+    std::printf("%s: %zu records\n", aOutput.string().c_str(), records.size());
+
+    return 0;
+}
+
+int Verify(const std::filesystem::path& aPath)
+{
+    Format::Header header{};
+    std::vector<Format::Record> records;
+
+    if (!ReadIndex(aPath, header, records))
+        return 1;
+
+    size_t errors = 0;
+
+    for (size_t recordIndex = 1; recordIndex < header.sortedCount; ++recordIndex)
+    {
+        if (!Format::IsOrdered(records[recordIndex - 1], records[recordIndex]))
+        {
+            std::fprintf(stderr, "record %zu: sorted part is out of order or has duplicates\n", recordIndex);
+            ++errors;
+        }
+    }
+
+    for (size_t recordIndex = 0; recordIndex < records.size(); ++recordIndex)
+    {
+        const auto& record = records[recordIndex];
+
+        if (!record.nodeID || !record.sectorHash || record.instanceIndex < 0 || record.nodeIndex < 0 ||
+            static_cast<uint32_t>(record.instanceIndex) >= record.instanceCount ||
+            static_cast<uint32_t>(record.nodeIndex) >= record.nodeCount)
+        {
+            std::fprintf(stderr, "record %zu: invalid node 0x%016llx\n", recordIndex,
+                         static_cast<unsigned long long>(record.nodeID));
+            ++errors;
+        }
+    }
+
+    std::printf("%s: %llu sorted, %llu appended, %zu errors\n", aPath.string().c_str(),
+                static_cast<unsigned long long>(header.sortedCount),
+                static_cast<unsigned long long>(records.size() - header.sortedCount), errors);
+
+    return errors ? 1 : 0;
+}
+
+int Lookup(const std::filesystem::path& aPath, std::string_view aNodeID)
+{
+    Format::Header header{};
+    std::vector<Format::Record> records;
+    uint64_t nodeID{};
+
+    if (!ParseField(aNodeID, nodeID))
+    {
+        std::fprintf(stderr, "invalid node ID\n");
+        return 1;
+    }
+
+    if (!ReadIndex(aPath, header, records))
+        return 1;
+
+    const auto record = Format::FindRecord(records.data(), header.sortedCount, records.size(), nodeID);
+
+    if (!record)
+    {
+        std::printf("not found\n");
+        return 1;
+    }
+
+    std::printf("nodeID=0x%016llx sectorHash=0x%016llx sectorStamp=0x%016llx nodeType=0x%016llx "
+                "parentID=0x%016llx instance=%d/%u node=%d/%u\n",
+                static_cast<unsigned long long>(record->nodeID), static_cast<unsigned long long>(record->sectorHash),
+                static_cast<unsigned long long>(record->sectorStamp), static_cast<unsigned long long>(record->nodeType),
+                static_cast<unsigned long long>(record->parentID),
+                record->instanceIndex, record->instanceCount, record->nodeIndex, record->nodeCount);
+
+    return 0;
+}
+
+void PrintUsage()
+{
+    std::fprintf(stderr, "Usage:\n"
+                         "  nodeindex build <output> <input>...\n"
+                         "  nodeindex verify <index>\n"
+                         "  nodeindex lookup <index> <nodeID>\n");
+}
+}
+
+int main(int aArgc, char** aArgv)
+{
+    if (aArgc < 3)
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    const std::string_view command = aArgv[1];
+
+    if (command == "build" && aArgc >= 4)
+    {
+        return Build(aArgv[2], {aArgv + 3, aArgv + aArgc});
+    }
+
+    if (command == "verify" && aArgc == 3)
+    {
+        return Verify(aArgv[2]);
+    }
+
+    if (command == "lookup" && aArgc == 4)
+    {
+        return Lookup(aArgv[2], aArgv[3]);
+    }
+
+    PrintUsage();
+    return 2;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <immintrin.h>
+
+// Stand-ins for the engine types used by the culling code, forced in front of every source of the replay tool.
+// The layout matches the engine types, the frustum and box kernels rely on it.
+namespace Core
+{
+// Only the part of the hopscotch map interface used by the culling code
+template<typename K, typename V>
+class Map : public std::unordered_map<K, V>
+{
+    using Base = std::unordered_map<K, V>;
+
+public:
+    struct iterator : Base::iterator
+    {
+        iterator(typename Base::iterator aIt)
+            : Base::iterator(aIt)
+        {
+        }
+
+        V& value() const
+        {
+            return (*this)->second;
+        }
+    };
+
+    iterator begin()
+    {
+        return Base::begin();
+    }
+
+    iterator end()
+    {
+        return Base::end();
+    }
+
+    iterator find(const K& aKey)
+    {
+        return Base::find(aKey);
+    }
+
+    typename Base::const_iterator begin() const
+    {
+        return Base::begin();
+    }
+
+    typename Base::const_iterator end() const
+    {
+        return Base::end();
+    }
+
+    typename Base::const_iterator find(const K& aKey) const
+    {
+        return Base::find(aKey);
+    }
+
+    using Base::erase;
+};
+
+template<typename T>
+using Vector = std::vector<T>;
+}
+
+namespace Red
+{
+struct Vector4
+{
+    float X;
+    float Y;
+    float Z;
+    float W;
+};
+
+struct Box
+{
+    Vector4 Min;
+    Vector4 Max;
+};
+}
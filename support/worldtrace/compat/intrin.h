@@ -0,0 +1,13 @@
+#pragma once
+
+// CPU feature queries of the box kernels for compilers other than MSVC.
+#include <cpuid.h>
+#include <immintrin.h>
+
+#undef __cpuid
+
+inline void __cpuid(int aInfo[4], int aLeaf)
+{
+    __cpuid_count(aLeaf, 0, aInfo[0], aInfo[1], aInfo[2], aInfo[3]);
+}
+
@@ -0,0 +1,1176 @@
+// Replays world traces recorded by the world inspector without the game.
+// The culling runs through the same spatial index and box kernels as in the game, the engine types are replaced
+// by the compat header. Synthetic traces of a given size can be generated to compare the culling strategies,
+// the ranking of targets and scanner pages is compared on random distances.
+// Builds for example with:
+//   g++ -std=c++20 -O2 -mavx2 -mfma -ffp-contract=off -Isrc -Isupport/worldtrace/compat -include Compat.hpp
+//       support/worldtrace/main.cpp src/App/World/WorldNodeSpatialIndex.cpp src/Red/BoxBatch.cpp -o worldtrace
+#include "App/World/WorldNodeSpatialIndex.hpp"
+#include "App/World/WorldNodeTopK.hpp"
+#include "App/World/WorldTraceFormat.hpp"
+#include "Red/Math.hpp"
+
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+namespace Format = App::WorldTraceFormat;
+
+struct Event
+{
+    Format::EventType type;
+    uint64_t time;
+    const uint8_t* payload;
+    uint32_t size;
+};
+
+constexpr auto EventTypeCount = static_cast<size_t>(Format::EventType::IndexClear) + 1;
+
+enum class ReplayMode
+{
+    Index,  // Culling through the spatial index, as in the game
+    Linear, // Every streamed node is tested, as before the spatial index
+    Cold,   // Spatial index without plane hints and skipped updates, candidates are tested again by the chunks
+};
+
+enum class Motion
+{
+    Walk,
+    Drive,
+};
+
+bool ReadTrace(const std::filesystem::path& aPath, std::vector<uint8_t>& aData, std::vector<Event>& aEvents)
+{
+    std::error_code error;
+    const auto fileSize = std::filesystem::file_size(aPath, error);
+
+    if (error)
+    {
+        std::fprintf(stderr, "%s: can't read file size\n", aPath.string().c_str());
+        return false;
+    }
+
+    aData.resize(fileSize);
+
+    std::ifstream file(aPath, std::ios::binary);
+    file.read(reinterpret_cast<char*>(aData.data()), static_cast<std::streamsize>(fileSize));
+
+    Format::Header header{};
+
+    if (!file || fileSize < sizeof(header))
+    {
+        std::fprintf(stderr, "%s: can't read file\n", aPath.string().c_str());
+        return false;
+    }
+
+    std::memcpy(&header, aData.data(), sizeof(header));
+
+    if (!Format::IsValidHeader(header))
+    {
+        std::fprintf(stderr, "%s: not a world trace or unsupported version\n", aPath.string().c_str());
+        return false;
+    }
+
+    size_t offset = sizeof(header);
+
+    while (offset + sizeof(Format::EventHeader) <= aData.size())
+    {
+        Format::EventHeader eventHeader{};
+        std::memcpy(&eventHeader, aData.data() + offset, sizeof(eventHeader));
+        offset += sizeof(eventHeader);
+
+        // A trace of a crashed session can end in the middle of an event, everything before it is still usable
+        if (offset + eventHeader.size > aData.size())
+        {
+            std::fprintf(stderr, "%s: truncated event at %zu\n", aPath.string().c_str(), offset);
+            break;
+        }
+
+        aEvents.push_back({eventHeader.type, eventHeader.time, aData.data() + offset, eventHeader.size});
+        offset += eventHeader.size;
+    }
+
+    return true;
+}
+
+template<typename T>
+bool ReadPayload(const Event& aEvent, T& aPayload)
+{
+    if (aEvent.size < sizeof(T))
+        return false;
+
+    std::memcpy(&aPayload, aEvent.payload, sizeof(T));
+    return true;
+}
+
+double GetPercentile(std::vector<double>& aValues, double aPercentile)
+{
+    if (aValues.empty())
+        return 0.0;
+
+    const auto index = static_cast<size_t>(aPercentile * static_cast<double>(aValues.size() - 1));
+    std::nth_element(aValues.begin(), aValues.begin() + index, aValues.end());
+
+    return aValues[index];
+}
+
+void PrintLatency(const char* aName, std::vector<double>& aLatencies)
+{
+    if (aLatencies.empty())
+        return;
+
+    double total = 0.0;
+    for (const auto& latency : aLatencies)
+    {
+        total += latency;
+    }
+
+    const auto count = aLatencies.size();
+    const auto p50 = GetPercentile(aLatencies, 0.5);
+    const auto p90 = GetPercentile(aLatencies, 0.9);
+    const auto p99 = GetPercentile(aLatencies, 0.99);
+    const auto max = *std::max_element(aLatencies.begin(), aLatencies.end());
+
+    std::printf("%-16s count=%zu total=%.3fms mean=%.3fus p50=%.3fus p90=%.3fus p99=%.3fus max=%.3fus\n", aName,
+                count, total / 1000.0, total / static_cast<double>(count), p50, p90, p99, max);
+}
+
+// Mirrors the lookups of the node registry: loaded sectors are keyed by the end of their setup buffer,
+// node instances are resolved to their setups through the reverse index.
+class RegistryReplay
+{
+public:
+    void LoadSector(const Event& aEvent)
+    {
+        Format::SectorLoad sectorLoad{};
+
+        if (!ReadPayload(aEvent, sectorLoad))
+            return;
+
+        const auto setupCount = (aEvent.size - sizeof(sectorLoad)) / sizeof(Format::NodeSetup);
+
+        auto& sector = m_sectors[sectorLoad.sectorKey];
+        sector.sectorHash = sectorLoad.sectorHash;
+        sector.setupKeys.resize(setupCount);
+        sector.instanceKeys.assign(setupCount, 0);
+
+        for (size_t setupIndex = 0; setupIndex < setupCount; ++setupIndex)
+        {
+            Format::NodeSetup setup{};
+            std::memcpy(&setup, aEvent.payload + sizeof(sectorLoad) + setupIndex * sizeof(setup), sizeof(setup));
+
+            sector.setupKeys[setupIndex] = setup.setupKey;
+
+            if (setup.nodeID)
+            {
+                m_nodeRefs[setup.nodeID] = setup.setupKey;
+            }
+        }
+
+        sector.setupsBegin = setupCount ? sector.setupKeys.front() : sectorLoad.sectorKey;
+    }
+
+    void UnloadSector(const Event& aEvent)
+    {
+        Format::SectorUnload sectorUnload{};
+
+        if (ReadPayload(aEvent, sectorUnload))
+        {
+            m_sectors.erase(sectorUnload.sectorKey);
+        }
+    }
+
+    void InitializeNode(const Event& aEvent)
+    {
+        Format::NodeInitialize nodeInitialize{};
+
+        if (!ReadPayload(aEvent, nodeInitialize))
+            return;
+
+        if (auto sector = FindSector(nodeInitialize.setupKey))
+        {
+            const auto& setupKeys = sector->setupKeys;
+            const auto& setupIt = std::lower_bound(setupKeys.begin(), setupKeys.end(), nodeInitialize.setupKey);
+
+            if (setupIt != setupKeys.end() && *setupIt == nodeInitialize.setupKey)
+            {
+                sector->instanceKeys[setupIt - setupKeys.begin()] = nodeInitialize.instanceKey;
+            }
+        }
+
+        m_nodeInstances[nodeInitialize.instanceKey] = nodeInitialize.setupKey;
+    }
+
+    void AttachNode(const Event& aEvent, bool aAttached)
+    {
+        Format::NodeAttach nodeAttach{};
+
+        if (!ReadPayload(aEvent, nodeAttach))
+            return;
+
+        const auto& instanceIt = m_nodeInstances.find(nodeAttach.instanceKey);
+
+        if (instanceIt == m_nodeInstances.end() || !FindSector(instanceIt->second))
+        {
+            ++m_unresolvedEvents;
+            return;
+        }
+
+        if (aAttached)
+        {
+            ++m_attachedNodes;
+        }
+        else if (m_attachedNodes)
+        {
+            --m_attachedNodes;
+        }
+    }
+
+    void Clear()
+    {
+        m_sectors.clear();
+        m_nodeInstances.clear();
+        m_attachedNodes = 0;
+    }
+
+    [[nodiscard]] size_t GetSectorCount() const
+    {
+        return m_sectors.size();
+    }
+
+    [[nodiscard]] size_t GetNodeRefCount() const
+    {
+        return m_nodeRefs.size();
+    }
+
+    [[nodiscard]] uint64_t GetAttachedNodes() const
+    {
+        return m_attachedNodes;
+    }
+
+    [[nodiscard]] uint64_t GetUnresolvedEvents() const
+    {
+        return m_unresolvedEvents;
+    }
+
+private:
+    struct Sector
+    {
+        uint64_t sectorHash;
+        uint64_t setupsBegin;
+        std::vector<uint64_t> setupKeys;
+        std::vector<uint64_t> instanceKeys;
+    };
+
+    Sector* FindSector(uint64_t aSetupKey)
+    {
+        const auto& it = m_sectors.upper_bound(aSetupKey);
+
+        if (it == m_sectors.end() || it->second.setupsBegin > aSetupKey)
+            return nullptr;
+
+        return &it->second;
+    }
+
+    std::map<uint64_t, Sector> m_sectors;
+    Core::Map<uint64_t, uint64_t> m_nodeRefs;
+    Core::Map<uint64_t, uint64_t> m_nodeInstances;
+    uint64_t m_attachedNodes{0};
+    uint64_t m_unresolvedEvents{0};
+};
+
+// The culling before the spatial index: every streamed node is tested against the frustum and the distance.
+class LinearScan
+{
+public:
+    void Insert(uint64_t aKey, const Red::Box& aBox)
+    {
+        const auto& it = m_indexes.find(aKey);
+
+        if (it != m_indexes.end())
+        {
+            m_boxes[it->second] = aBox;
+            return;
+        }
+
+        m_indexes[aKey] = m_keys.size();
+        m_keys.push_back(aKey);
+        m_boxes.push_back(aBox);
+    }
+
+    bool Remove(uint64_t aKey)
+    {
+        const auto& it = m_indexes.find(aKey);
+
+        if (it == m_indexes.end())
+            return false;
+
+        const auto index = it->second;
+        m_indexes.erase(it);
+
+        if (index + 1 != m_keys.size())
+        {
+            m_keys[index] = m_keys.back();
+            m_boxes[index] = m_boxes.back();
+            m_indexes[m_keys[index]] = index;
+        }
+
+        m_keys.pop_back();
+        m_boxes.pop_back();
+
+        return true;
+    }
+
+    void Clear()
+    {
+        m_keys.clear();
+        m_boxes.clear();
+        m_indexes.clear();
+    }
+
+    void Query(const Red::Frustum& aFrustum, const Red::Vector4& aOrigin, float aMaxDistance,
+               Core::Vector<uint64_t>& aResult) const
+    {
+        const auto maxDistanceSquared = aMaxDistance * aMaxDistance;
+
+        for (size_t i = 0; i < m_keys.size(); ++i)
+        {
+            if (aFrustum.Test(m_boxes[i]) != Red::FrustumResult::Outside &&
+                Red::DistanceSquared(aOrigin, m_boxes[i]) <= maxDistanceSquared)
+            {
+                aResult.push_back(m_keys[i]);
+            }
+        }
+    }
+
+    [[nodiscard]] uint32_t GetSize() const
+    {
+        return static_cast<uint32_t>(m_keys.size());
+    }
+
+private:
+    std::vector<uint64_t> m_keys;
+    std::vector<Red::Box> m_boxes;
+    Core::Map<uint64_t, size_t> m_indexes;
+};
+
+// Order independent digest of the query results, equal digests mean both strategies culled the same nodes
+uint64_t MixKey(uint64_t aKey)
+{
+    aKey ^= aKey >> 33;
+    aKey *= 0xFF51AFD7ED558CCDull;
+    aKey ^= aKey >> 33;
+    aKey *= 0xC4CEB9FE1A85EC53ull;
+    aKey ^= aKey >> 33;
+
+    return aKey;
+}
+
+Red::Frustum ToFrustum(const Format::CameraUpdate& aCamera)
+{
+    Red::Frustum frustum;
+    std::memcpy(frustum.planes, aCamera.planes, sizeof(frustum.planes));
+    std::memcpy(frustum.masks, aCamera.masks, sizeof(frustum.masks));
+
+    return frustum;
+}
+
+int Info(const std::filesystem::path& aPath)
+{
+    std::vector<uint8_t> data;
+    std::vector<Event> events;
+
+    if (!ReadTrace(aPath, data, events))
+        return 1;
+
+    std::array<uint64_t, EventTypeCount> counts{};
+    std::array<uint64_t, EventTypeCount> bytes{};
+    uint64_t unknownEvents = 0;
+    uint64_t nodeSetups = 0;
+
+    for (const auto& event : events)
+    {
+        const auto typeIndex = static_cast<size_t>(event.type);
+
+        if (typeIndex == 0 || typeIndex >= EventTypeCount)
+        {
+            ++unknownEvents;
+            continue;
+        }
+
+        ++counts[typeIndex];
+        bytes[typeIndex] += sizeof(Format::EventHeader) + event.size;
+
+        if (event.type == Format::EventType::SectorLoad && event.size >= sizeof(Format::SectorLoad))
+        {
+            nodeSetups += (event.size - sizeof(Format::SectorLoad)) / sizeof(Format::NodeSetup);
+        }
+    }
+
+    const auto duration = events.empty() ? 0.0 : static_cast<double>(events.back().time) / 1e9;
+
+    std::printf("%s: %zu events, %zu bytes, %.1fs\n", aPath.string().c_str(), events.size(), data.size(), duration);
+
+    for (size_t typeIndex = 1; typeIndex < EventTypeCount; ++typeIndex)
+    {
+        std::printf("  %-16s %10llu events %12llu bytes\n", Format::GetEventName(static_cast<Format::EventType>(typeIndex)),
+                    static_cast<unsigned long long>(counts[typeIndex]),
+                    static_cast<unsigned long long>(bytes[typeIndex]));
+    }
+
+    std::printf("  %llu node setups, %llu unknown events\n", static_cast<unsigned long long>(nodeSetups),
+                static_cast<unsigned long long>(unknownEvents));
+
+    return 0;
+}
+
+const char* GetModeName(ReplayMode aMode)
+{
+    switch (aMode)
+    {
+    case ReplayMode::Index:
+        return "index";
+    case ReplayMode::Linear:
+        return "linear";
+    case ReplayMode::Cold:
+        return "cold";
+    default:
+        return "unknown";
+    }
+}
+
+int Replay(const std::filesystem::path& aPath, uint32_t aRepeat, ReplayMode aMode)
+{
+    std::vector<uint8_t> data;
+    std::vector<Event> events;
+
+    if (!ReadTrace(aPath, data, events))
+        return 1;
+
+    std::vector<double> registryLatencies;
+    std::vector<double> indexLatencies;
+    std::vector<double> queryLatencies;
+    uint64_t skippedQueries = 0;
+    uint64_t candidates = 0;
+    uint64_t visitedCells = 0;
+    uint64_t planeTests = 0;
+    uint64_t digest = 0;
+
+    RegistryReplay registry;
+    LinearScan linear;
+    Core::Map<uint64_t, Red::Box> coldBoxes;
+    App::WorldNodeSpatialIndex index;
+    App::WorldNodeSpatialQuery query;
+    Core::Vector<uint64_t> result;
+
+    const auto replayStart = std::chrono::steady_clock::now();
+
+    for (uint32_t pass = 0; pass < aRepeat; ++pass)
+    {
+        registry.Clear();
+        linear.Clear();
+        coldBoxes.clear();
+        index.Clear();
+
+        // Same as the inspector, the query is skipped when neither the view nor the index changed
+        Format::CameraUpdate lastCamera{};
+        bool indexChanged = true;
+
+        for (const auto& event : events)
+        {
+            const auto eventStart = std::chrono::steady_clock::now();
+
+            switch (event.type)
+            {
+            case Format::EventType::SectorLoad:
+                registry.LoadSector(event);
+                break;
+            case Format::EventType::SectorUnload:
+                registry.UnloadSector(event);
+                break;
+            case Format::EventType::NodeInitialize:
+                registry.InitializeNode(event);
+                break;
+            case Format::EventType::NodeAttach:
+                registry.AttachNode(event, true);
+                break;
+            case Format::EventType::NodeDetach:
+                registry.AttachNode(event, false);
+                break;
+            case Format::EventType::NodeBounds:
+            {
+                Format::NodeBounds nodeBounds{};
+
+                if (ReadPayload(event, nodeBounds))
+                {
+                    const Red::Box box{{nodeBounds.min[0], nodeBounds.min[1], nodeBounds.min[2], nodeBounds.min[3]},
+                                       {nodeBounds.max[0], nodeBounds.max[1], nodeBounds.max[2], nodeBounds.max[3]}};
+
+                    if (aMode == ReplayMode::Linear)
+                    {
+                        linear.Insert(nodeBounds.nodeKey, box);
+                    }
+                    else
+                    {
+                        index.Insert(nodeBounds.nodeKey, box);
+                    }
+
+                    if (aMode == ReplayMode::Cold)
+                    {
+                        coldBoxes[nodeBounds.nodeKey] = box;
+                    }
+
+                    indexChanged = true;
+                }
+                break;
+            }
+            case Format::EventType::NodeRemove:
+            {
+                Format::NodeRemove nodeRemove{};
+
+                if (!ReadPayload(event, nodeRemove))
+                    break;
+
+                coldBoxes.erase(nodeRemove.nodeKey);
+
+                if (aMode == ReplayMode::Linear ? linear.Remove(nodeRemove.nodeKey) : index.Remove(nodeRemove.nodeKey))
+                {
+                    indexChanged = true;
+                }
+                break;
+            }
+            case Format::EventType::CameraUpdate:
+            {
+                Format::CameraUpdate camera{};
+
+                if (!ReadPayload(event, camera))
+                    break;
+
+                if (aMode != ReplayMode::Cold && !indexChanged &&
+                    std::memcmp(&camera, &lastCamera, sizeof(camera)) == 0)
+                {
+                    ++skippedQueries;
+                    continue;
+                }
+
+                auto frustum = ToFrustum(camera);
+                const Red::Vector4 position{camera.position[0], camera.position[1], camera.position[2],
+                                            camera.position[3]};
+
+                result.clear();
+
+                if (aMode == ReplayMode::Linear)
+                {
+                    linear.Query(frustum, position, camera.frustumDistance, result);
+                }
+                else
+                {
+                    // Without the hints of the previous queries every test starts with the first plane
+                    if (aMode == ReplayMode::Cold)
+                    {
+                        query = {};
+                    }
+
+                    index.Query(frustum, position, camera.frustumDistance, query, result);
+
+                    const auto stats = index.GetStats(query);
+                    visitedCells += stats.visitedCells;
+                    planeTests += stats.planeTests;
+
+                    if (aMode == ReplayMode::Cold)
+                    {
+                        uint32_t retests = 0;
+
+                        for (const auto key : result)
+                        {
+                            uint8_t plane = 0;
+                            frustum.Test(coldBoxes.find(key)->second, plane, retests);
+                        }
+
+                        planeTests += retests;
+                    }
+                }
+
+                candidates += result.size();
+
+                for (const auto key : result)
+                {
+                    digest += MixKey(key);
+                }
+
+                lastCamera = camera;
+                indexChanged = false;
+                break;
+            }
+            case Format::EventType::WorldDetach:
+                registry.Clear();
+                linear.Clear();
+                index.Clear();
+                indexChanged = true;
+                break;
+            case Format::EventType::IndexClear:
+                linear.Clear();
+                index.Clear();
+                indexChanged = true;
+                break;
+            default:
+                continue;
+            }
+
+            const std::chrono::duration<double, std::micro> eventDuration =
+                std::chrono::steady_clock::now() - eventStart;
+
+            switch (event.type)
+            {
+            case Format::EventType::NodeBounds:
+            case Format::EventType::NodeRemove:
+            case Format::EventType::IndexClear:
+                indexLatencies.push_back(eventDuration.count());
+                break;
+            case Format::EventType::CameraUpdate:
+                queryLatencies.push_back(eventDuration.count());
+                break;
+            default:
+                registryLatencies.push_back(eventDuration.count());
+                break;
+            }
+        }
+    }
+
+    const std::chrono::duration<double, std::milli> replayDuration = std::chrono::steady_clock::now() - replayStart;
+    const auto eventCount = static_cast<double>(events.size()) * aRepeat;
+    const auto queryCount = queryLatencies.size();
+
+    std::printf("%s: %u passes, %.0f events in %.3fms, %.0f events/s\n", aPath.string().c_str(), aRepeat,
+                eventCount, replayDuration.count(), eventCount / (replayDuration.count() / 1000.0));
+    std::printf("registry         sectors=%zu refs=%zu attached=%llu unresolved=%llu\n", registry.GetSectorCount(),
+                registry.GetNodeRefCount(), static_cast<unsigned long long>(registry.GetAttachedNodes()),
+                static_cast<unsigned long long>(registry.GetUnresolvedEvents()));
+    std::printf("culling          mode=%s entries=%u queries=%zu skipped=%llu candidates=%.1f cells=%.1f planes=%.1f "
+                "digest=%016llx\n",
+                GetModeName(aMode), aMode == ReplayMode::Linear ? linear.GetSize() : index.GetSize(), queryCount,
+                static_cast<unsigned long long>(skippedQueries),
+                queryCount ? static_cast<double>(candidates) / queryCount : 0.0,
+                queryCount ? static_cast<double>(visitedCells) / queryCount : 0.0,
+                queryCount ? static_cast<double>(planeTests) / queryCount : 0.0,
+                static_cast<unsigned long long>(digest));
+    std::printf("plane tests      total=%llu per pass=%.0f\n", static_cast<unsigned long long>(planeTests),
+                static_cast<double>(planeTests) / aRepeat);
+
+    PrintLatency("registry", registryLatencies);
+    PrintLatency("index updates", indexLatencies);
+    PrintLatency("frustum queries", queryLatencies);
+
+    return 0;
+}
+
+class TraceWriter
+{
+public:
+    bool Open(const std::filesystem::path& aPath)
+    {
+        m_file.open(aPath, std::ios::binary | std::ios::trunc);
+
+        const auto header = Format::MakeHeader();
+        m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        return static_cast<bool>(m_file);
+    }
+
+    template<typename T>
+    void Write(Format::EventType aType, const T& aPayload, const void* aData = nullptr, uint32_t aDataSize = 0)
+    {
+        const Format::EventHeader eventHeader{aType, 0, static_cast<uint32_t>(sizeof(T)) + aDataSize, m_time};
+
+        m_file.write(reinterpret_cast<const char*>(&eventHeader), sizeof(eventHeader));
+        m_file.write(reinterpret_cast<const char*>(&aPayload), sizeof(T));
+
+        if (aDataSize)
+        {
+            m_file.write(static_cast<const char*>(aData), aDataSize);
+        }
+    }
+
+    void SetTime(uint64_t aTime)
+    {
+        m_time = aTime;
+    }
+
+    [[nodiscard]] bool IsGood() const
+    {
+        return static_cast<bool>(m_file);
+    }
+
+private:
+    std::ofstream m_file;
+    uint64_t m_time{0};
+};
+
+// Camera with a 90 degree horizontal field of view, the planes face the inside of the frustum
+Format::CameraUpdate MakeCamera(const float aPosition[3], float aYaw, float aPitch, float aFrustumDistance)
+{
+    constexpr auto NearDistance = 0.1f;
+    constexpr auto HorizontalSlope = 1.0f;
+    constexpr auto VerticalSlope = 9.0f / 16.0f;
+
+    const float forward[3] = {std::cos(aPitch) * std::cos(aYaw), std::cos(aPitch) * std::sin(aYaw), std::sin(aPitch)};
+    const float right[3] = {std::sin(aYaw), -std::cos(aYaw), 0.0f};
+    const float up[3] = {right[1] * forward[2] - right[2] * forward[1], right[2] * forward[0] - right[0] * forward[2],
+                         right[0] * forward[1] - right[1] * forward[0]};
+
+    float normals[6][3];
+
+    for (auto i = 0; i < 3; ++i)
+    {
+        normals[0][i] = forward[i];
+        normals[1][i] = -forward[i];
+        normals[2][i] = forward[i] * HorizontalSlope + right[i];
+        normals[3][i] = forward[i] * HorizontalSlope - right[i];
+        normals[4][i] = forward[i] * VerticalSlope + up[i];
+        normals[5][i] = forward[i] * VerticalSlope - up[i];
+    }
+
+    Format::CameraUpdate camera{};
+
+    for (auto plane = 0; plane < 6; ++plane)
+    {
+        const auto& normal = normals[plane];
+        const auto length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+        auto distance = 0.0f;
+
+        for (auto i = 0; i < 3; ++i)
+        {
+            camera.planes[plane][i] = normal[i] / length;
+            camera.masks[plane][i] = camera.planes[plane][i] >= 0.0f ? 0xFFFFFFFF : 0;
+            distance -= camera.planes[plane][i] * aPosition[i];
+        }
+
+        if (plane == 0)
+        {
+            distance -= NearDistance;
+        }
+        else if (plane == 1)
+        {
+            distance += aFrustumDistance;
+        }
+
+        camera.planes[plane][3] = distance;
+        camera.masks[plane][3] = 0xFFFFFFFF;
+    }
+
+    for (auto i = 0; i < 3; ++i)
+    {
+        camera.position[i] = aPosition[i];
+        camera.forward[i] = forward[i];
+    }
+
+    camera.position[3] = 1.0f;
+    camera.frustumDistance = aFrustumDistance;
+    camera.targetingDistance = 10.0f;
+
+    return camera;
+}
+
+// Writes a trace of a world of 8 km, split into sectors of 128 m that share the boxes evenly.
+// All sectors are loaded upfront, then the camera moves through the world at 10 updates per second.
+// Sectors around the camera are streamed out and in again from time to time.
+// Walking stops for a few seconds now and then, so that unchanged updates are skipped.
+int Synthesize(const std::filesystem::path& aPath, uint32_t aBoxCount, Motion aMotion, uint32_t aUpdates)
+{
+    constexpr auto WorldExtent = 4096.0f;
+    constexpr auto SectorSize = 128.0f;
+    constexpr auto SectorsPerSide = static_cast<uint32_t>(2 * WorldExtent / SectorSize);
+    constexpr auto SectorCount = SectorsPerSide * SectorsPerSide;
+    constexpr auto FrustumDistance = 120.0f;
+    constexpr auto UpdateInterval = 100'000'000ull;
+
+    struct Sector
+    {
+        uint64_t sectorKey;
+        uint32_t boxCount;
+        std::vector<uint64_t> instanceKeys;
+    };
+
+    TraceWriter writer;
+
+    if (!writer.Open(aPath))
+    {
+        std::fprintf(stderr, "%s: can't write file\n", aPath.string().c_str());
+        return 1;
+    }
+
+    std::mt19937_64 random(1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::normal_distribution<float> turn(0.0f, 1.0f);
+    std::vector<Sector> sectors(SectorCount);
+    std::vector<Format::NodeSetup> setups;
+    uint64_t nextAddress = 0x10000000;
+
+    const auto loadSector = [&](uint32_t aSectorIndex)
+    {
+        auto& sector = sectors[aSectorIndex];
+        const auto originX = static_cast<float>(aSectorIndex % SectorsPerSide) * SectorSize - WorldExtent;
+        const auto originY = static_cast<float>(aSectorIndex / SectorsPerSide) * SectorSize - WorldExtent;
+
+        setups.resize(sector.boxCount);
+
+        for (uint32_t i = 0; i < sector.boxCount; ++i)
+        {
+            auto& setup = setups[i];
+
+            setup = {};
+            setup.setupKey = nextAddress;
+            setup.nodeID = random();
+            setup.nodeType = random() % 64;
+            setup.nodeIndex = i;
+            setup.position[0] = originX + unit(random) * SectorSize;
+            setup.position[1] = originY + unit(random) * SectorSize;
+            setup.position[2] = unit(random) * 20.0f;
+            setup.position[3] = 1.0f;
+            setup.orientation[3] = 1.0f;
+            setup.scale[0] = setup.scale[1] = setup.scale[2] = 1.0f;
+
+            nextAddress += sizeof(Format::NodeSetup);
+        }
+
+        sector.sectorKey = nextAddress;
+        nextAddress += 0x1000;
+
+        const Format::SectorLoad sectorLoad{sector.sectorKey, random(), sector.boxCount, sector.boxCount};
+        writer.Write(Format::EventType::SectorLoad, sectorLoad, setups.data(),
+                     static_cast<uint32_t>(setups.size() * sizeof(Format::NodeSetup)));
+
+        sector.instanceKeys.clear();
+
+        for (const auto& setup : setups)
+        {
+            const auto instanceKey = nextAddress;
+            nextAddress += 0x100;
+
+            writer.Write(Format::EventType::NodeInitialize, Format::NodeInitialize{instanceKey, setup.setupKey});
+            writer.Write(Format::EventType::NodeAttach, Format::NodeAttach{instanceKey});
+
+            // Mostly props of a few meters, some buildings
+            const auto extent = unit(random) < 0.05f ? 10.0f + unit(random) * 40.0f : 0.2f + unit(random) * 3.0f;
+
+            Format::NodeBounds nodeBounds{};
+            nodeBounds.nodeKey = instanceKey;
+
+            for (auto i = 0; i < 3; ++i)
+            {
+                nodeBounds.min[i] = setup.position[i] - extent;
+                nodeBounds.max[i] = setup.position[i] + extent;
+            }
+
+            nodeBounds.min[3] = nodeBounds.max[3] = 1.0f;
+
+            writer.Write(Format::EventType::NodeBounds, nodeBounds);
+
+            sector.instanceKeys.push_back(instanceKey);
+        }
+    };
+
+    const auto unloadSector = [&](uint32_t aSectorIndex)
+    {
+        auto& sector = sectors[aSectorIndex];
+
+        for (const auto instanceKey : sector.instanceKeys)
+        {
+            writer.Write(Format::EventType::NodeRemove, Format::NodeRemove{instanceKey});
+            writer.Write(Format::EventType::NodeDetach, Format::NodeDetach{instanceKey});
+        }
+
+        writer.Write(Format::EventType::SectorUnload, Format::SectorUnload{sector.sectorKey});
+    };
+
+    for (uint32_t sectorIndex = 0; sectorIndex < SectorCount; ++sectorIndex)
+    {
+        sectors[sectorIndex].boxCount = static_cast<uint32_t>(
+            (static_cast<uint64_t>(aBoxCount) * (sectorIndex + 1)) / SectorCount -
+            (static_cast<uint64_t>(aBoxCount) * sectorIndex) / SectorCount);
+
+        loadSector(sectorIndex);
+    }
+
+    const auto speed = aMotion == Motion::Walk ? 1.4f : 15.0f;
+    const auto height = aMotion == Motion::Walk ? 1.7f : 1.2f;
+    const auto turnRate = aMotion == Motion::Walk ? 0.05f : 0.01f;
+
+    float position[3] = {0.0f, 0.0f, height};
+    float heading = 0.0f;
+    float time = 0.0f;
+
+    for (uint32_t update = 0; update < aUpdates; ++update)
+    {
+        writer.SetTime((update + 1) * UpdateInterval);
+
+        // Walking stops for 5 seconds every 30 seconds
+        const auto stopped = aMotion == Motion::Walk && update % 300 >= 250;
+
+        if (!stopped)
+        {
+            heading += turn(random) * turnRate;
+
+            // Turn back before leaving the world
+            if (std::abs(position[0]) > WorldExtent - 256.0f || std::abs(position[1]) > WorldExtent - 256.0f)
+            {
+                heading = std::atan2(-position[1], -position[0]);
+            }
+
+            position[0] += std::cos(heading) * speed * 0.1f;
+            position[1] += std::sin(heading) * speed * 0.1f;
+            time += 0.1f;
+
+            // A sector next to the camera is streamed in again every 2 seconds
+            if (update % 20 == 19)
+            {
+                const auto sectorX = std::clamp(static_cast<int32_t>((position[0] + WorldExtent) / SectorSize) +
+                                                    static_cast<int32_t>(random() % 3) - 1,
+                                                0, static_cast<int32_t>(SectorsPerSide) - 1);
+                const auto sectorY = std::clamp(static_cast<int32_t>((position[1] + WorldExtent) / SectorSize) +
+                                                    static_cast<int32_t>(random() % 3) - 1,
+                                                0, static_cast<int32_t>(SectorsPerSide) - 1);
+                const auto sectorIndex = static_cast<uint32_t>(sectorY) * SectorsPerSide +
+                                         static_cast<uint32_t>(sectorX);
+
+                unloadSector(sectorIndex);
+                loadSector(sectorIndex);
+            }
+        }
+
+        // Walkers look around while moving, drivers look ahead
+        const auto yaw = aMotion == Motion::Walk ? heading + 0.6f * std::sin(time * 0.3f) : heading;
+        const auto pitch = aMotion == Motion::Walk ? 0.1f * std::sin(time * 0.2f) : 0.0f;
+
+        writer.Write(Format::EventType::CameraUpdate, MakeCamera(position, yaw, pitch, FrustumDistance));
+    }
+
+    if (!writer.IsGood())
+    {
+        std::fprintf(stderr, "%s: can't write file\n", aPath.string().c_str());
+        return 1;
+    }
+
+    std::printf("%s: %u boxes in %u sectors, %u updates\n", aPath.string().c_str(), aBoxCount, SectorCount, aUpdates);
+
+    return 0;
+}
+
+// Ranks random distances like the crosshair and scanner results, the full sort is what the inspector did before.
+// All strategies must produce the same ranking, random distances practically never tie.
+int Rank(uint32_t aCandidates, uint32_t aLimit, uint32_t aRepeat)
+{
+    using Entry = App::WorldNodeTopK<uint32_t>::Entry;
+
+    const auto limit = std::min(aLimit, aCandidates);
+    const auto pageSize = std::min(limit, 50u);
+    const auto pageBegin = limit - pageSize;
+
+    std::mt19937_64 random(1);
+    std::uniform_real_distribution<float> distance(0.0f, 120.0f);
+    std::vector<float> distances(aCandidates);
+
+    for (auto& value : distances)
+    {
+        value = distance(random);
+    }
+
+    std::vector<uint32_t> sortedIndexes;
+    Core::Vector<Entry> selectedEntries;
+    Core::Vector<Entry> rankedEntries;
+    std::vector<double> sortDurations;
+    std::vector<double> heapDurations;
+    std::vector<double> pageDurations;
+    bool same = true;
+
+    for (uint32_t pass = 0; pass < aRepeat; ++pass)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        sortedIndexes.resize(aCandidates);
+
+        for (uint32_t i = 0; i < aCandidates; ++i)
+        {
+            sortedIndexes[i] = i;
+        }
+
+        std::sort(sortedIndexes.begin(), sortedIndexes.end(),
+                  [&distances](uint32_t a, uint32_t b) { return distances[a] < distances[b]; });
+
+        auto end = std::chrono::steady_clock::now();
+        sortDurations.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+
+        start = std::chrono::steady_clock::now();
+
+        App::WorldNodeTopK<uint32_t> nearest(limit);
+
+        for (uint32_t i = 0; i < aCandidates; ++i)
+        {
+            nearest.Push(distances[i], i);
+        }
+
+        nearest.Take(selectedEntries);
+
+        end = std::chrono::steady_clock::now();
+        heapDurations.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+
+        // Pages beyond the scanner page size are ranked on demand, this ranks the last page below the limit
+        start = std::chrono::steady_clock::now();
+
+        rankedEntries.clear();
+
+        for (uint32_t i = 0; i < aCandidates; ++i)
+        {
+            rankedEntries.emplace_back(distances[i], i);
+        }
+
+        std::nth_element(rankedEntries.begin(), rankedEntries.begin() + pageBegin, rankedEntries.end());
+        std::partial_sort(rankedEntries.begin() + pageBegin, rankedEntries.begin() + limit, rankedEntries.end());
+
+        end = std::chrono::steady_clock::now();
+        pageDurations.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+
+        for (uint32_t rank = 0; rank < limit; ++rank)
+        {
+            same &= selectedEntries[rank].second == sortedIndexes[rank];
+            same &= rank < pageBegin || rankedEntries[rank].second == sortedIndexes[rank];
+        }
+    }
+
+    std::printf("rank             candidates=%u limit=%u page=%u-%u repeat=%u results=%s\n", aCandidates, limit,
+                pageBegin, limit, aRepeat, same ? "same" : "different");
+
+    PrintLatency("full sort", sortDurations);
+    PrintLatency("top-k heap", heapDurations);
+    PrintLatency("on-demand page", pageDurations);
+
+    return same ? 0 : 1;
+}
+
+template<typename T>
+bool ParseNumber(std::string_view aText, T& aValue)
+{
+    const auto [end, error] = std::from_chars(aText.data(), aText.data() + aText.size(), aValue);
+    return error == std::errc() && end == aText.data() + aText.size();
+}
+
+void PrintUsage()
+{
+    std::fprintf(stderr, "Usage:\n"
+                         "  worldtrace info <trace>\n"
+                         "  worldtrace replay <trace> [repeat] [--linear|--cold]\n"
+                         "  worldtrace synth <trace> <boxes> [walk|drive] [updates]\n"
+                         "  worldtrace rank <candidates> [limit] [repeat]\n");
+}
+}
+
+int main(int aArgc, char** aArgv)
+{
+    if (aArgc < 3)
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    const std::string_view command = aArgv[1];
+
+    if (command == "info" && aArgc == 3)
+    {
+        return Info(aArgv[2]);
+    }
+
+    if (command == "replay" && aArgc <= 5)
+    {
+        uint32_t repeat = 1;
+        auto mode = ReplayMode::Index;
+
+        for (auto i = 3; i < aArgc; ++i)
+        {
+            const std::string_view argument = aArgv[i];
+
+            if (argument == "--linear")
+            {
+                mode = ReplayMode::Linear;
+            }
+            else if (argument == "--cold")
+            {
+                mode = ReplayMode::Cold;
+            }
+            else if (!ParseNumber(argument, repeat) || repeat == 0)
+            {
+                std::fprintf(stderr, "invalid repeat count\n");
+                return 2;
+            }
+        }
+
+        return Replay(aArgv[2], repeat, mode);
+    }
+
+    if (command == "synth" && aArgc >= 4 && aArgc <= 6)
+    {
+        uint32_t boxes = 0;
+        uint32_t updates = 600;
+        auto motion = Motion::Walk;
+
+        if (!ParseNumber(std::string_view(aArgv[3]), boxes) || boxes == 0)
+        {
+            std::fprintf(stderr, "invalid box count\n");
+            return 2;
+        }
+
+        if (aArgc >= 5)
+        {
+            const std::string_view value = aArgv[4];
+
+            if (value == "drive")
+            {
+                motion = Motion::Drive;
+            }
+            else if (value != "walk")
+            {
+                std::fprintf(stderr, "invalid motion, expected walk or drive\n");
+                return 2;
+            }
+        }
+
+        if (aArgc == 6 && (!ParseNumber(std::string_view(aArgv[5]), updates) || updates == 0))
+        {
+            std::fprintf(stderr, "invalid update count\n");
+            return 2;
+        }
+
+        return Synthesize(aArgv[2], boxes, motion, updates);
+    }
+
+    if (command == "rank" && aArgc <= 5)
+    {
+        uint32_t candidates = 0;
+        uint32_t limit = 8;
+        uint32_t repeat = 100;
+
+        if (!ParseNumber(std::string_view(aArgv[2]), candidates) || candidates == 0 ||
+            (aArgc >= 4 && (!ParseNumber(std::string_view(aArgv[3]), limit) || limit == 0)) ||
+            (aArgc == 5 && (!ParseNumber(std::string_view(aArgv[4]), repeat) || repeat == 0)))
+        {
+            std::fprintf(stderr, "invalid candidate count, limit or repeat count\n");
+            return 2;
+        }
+
+        return Rank(candidates, limit, repeat);
+    }
+
+    PrintUsage();
+    return 2;
+}